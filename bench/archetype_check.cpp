@@ -0,0 +1,147 @@
+// The projectile archetype of the registry against a plain reference, over inserts and removes that move rows across
+// the 16 KB chunks, destroy through the registry, a save and load of the archetype, a registry snapshot and clear()
+
+#include "bench.hpp"
+
+#include <vector>
+
+// A projectile whose components all carry tag, to tell the rows apart after they moved
+static void insert_projectile(Entity e, int tag)
+{
+	Motion motion;
+	motion.position = { (float)tag, (float)-tag };
+	Projectile projectile;
+	projectile.damage = tag;
+	AABB aabb;
+	aabb.collision_box = { (float)tag, 1.f };
+	RenderRequest render;
+	render.alpha = (float)tag;
+	registry().projectileArchetype.insert(e, motion, projectile, MovingCollidable(), MovingSAT(), Collidable(), aabb, render);
+}
+
+struct Reference
+{
+	Entity entity;
+	int tag;
+};
+
+// Every live projectile has its own components, every chunk but the last is full and nothing else is in the archetype
+static void check_matches(const std::vector<Reference>& live, const std::vector<Entity>& gone)
+{
+	ProjectileArchetype& archetype = registry().projectileArchetype;
+	CHECK(archetype.size() == live.size());
+	for (const Reference& r : live) {
+		CHECK(archetype.has(r.entity));
+		CHECK(archetype.get<Motion>(r.entity).position == vec2((float)r.tag, (float)-r.tag));
+		CHECK(archetype.get<Projectile>(r.entity).damage == r.tag);
+		CHECK(archetype.get<AABB>(r.entity).collision_box.x == (float)r.tag);
+		CHECK(archetype.get<RenderRequest>(r.entity).alpha == (float)r.tag);
+	}
+	for (Entity e : gone)
+		CHECK(!archetype.has(e));
+
+	size_t rows = 0, chunks = 0;
+	bool short_chunk = false;
+	archetype.each_chunk([&](size_t count, Entity* entities, Motion* motions, Projectile* projectiles, MovingCollidable*, MovingSAT*,
+		Collidable*, AABB* aabbs, RenderRequest* renders) {
+		CHECK(!short_chunk && count > 0 && count <= ProjectileArchetype::CHUNK_CAPACITY);
+		short_chunk = count < ProjectileArchetype::CHUNK_CAPACITY;
+		for (size_t row = 0; row < count; row++) {
+			CHECK(archetype.has(entities[row]));
+			int tag = projectiles[row].damage;
+			CHECK(motions[row].position.x == (float)tag && aabbs[row].collision_box.x == (float)tag && renders[row].alpha == (float)tag);
+		}
+		rows += count;
+		chunks++;
+	});
+	CHECK(rows == live.size());
+	CHECK(chunks == (live.size() + ProjectileArchetype::CHUNK_CAPACITY - 1) / ProjectileArchetype::CHUNK_CAPACITY);
+}
+
+int main()
+{
+	BenchWorld world;
+	ProjectileArchetype& archetype = registry().projectileArchetype;
+	const size_t capacity = ProjectileArchetype::CHUNK_CAPACITY;
+
+	// a little over five chunks
+	std::vector<Reference> live;
+	std::vector<Entity> gone;
+	int next_tag = 1;
+	for (size_t i = 0; i < capacity * 5 + 7; i++) {
+		Entity e = registry().create();
+		insert_projectile(e, next_tag);
+		live.push_back({ e, next_tag++ });
+	}
+	check_matches(live, gone);
+
+	// removes from the front chunks fill the holes with rows of the last chunk, removes through the registry go by signature
+	BenchRandom random;
+	for (int step = 0; step < 4000; step++) {
+		if (random.next() % 3 != 0 && !live.empty()) {
+			size_t k = random.next() % live.size();
+			if (random.next() % 4 == 0)
+				k = random.next() % std::min(live.size(), capacity);
+			Entity e = live[k].entity;
+			live[k] = live.back();
+			live.pop_back();
+			if (random.next() % 2)
+				archetype.remove(e);
+			else
+				registry().destroy(e);
+			gone.push_back(e);
+		}
+		else {
+			Entity e = registry().create();
+			insert_projectile(e, next_tag);
+			live.push_back({ e, next_tag++ });
+		}
+		if (step % 100 == 0)
+			check_matches(live, gone);
+	}
+	check_matches(live, gone);
+
+	// a destroyed index that is handed out again does not find the old row
+	Entity reused = registry().create();
+	CHECK(!archetype.has(reused));
+	insert_projectile(reused, next_tag);
+	live.push_back({ reused, next_tag++ });
+	check_matches(live, gone);
+
+	// save and load of the archetype alone
+	SnapshotBuffer buffer;
+	archetype.save(buffer);
+	archetype.clear();
+	CHECK(archetype.size() == 0);
+	for (const Reference& r : live)
+		CHECK(!archetype.has(r.entity));
+	SnapshotReader reader(buffer);
+	archetype.load(reader);
+	check_matches(live, gone);
+
+	// a registry snapshot brings the rows back together with the entities
+	ECSRegistry::Snapshot snapshot = registry().snapshot();
+	std::vector<Reference> saved = live;
+	for (const Reference& r : live) {
+		registry().destroy(r.entity);
+		gone.push_back(r.entity);
+	}
+	live.clear();
+	check_matches(live, gone);
+	registry().restore(snapshot);
+	for (const Reference& r : saved)
+		CHECK(registry().valid(r.entity));
+	gone.clear();
+	check_matches(saved, gone);
+
+	// clear() empties the archetype, later inserts start over in the first chunk
+	archetype.clear();
+	check_matches({}, {});
+	for (const Reference& r : saved)
+		CHECK(!archetype.has(r.entity));
+	insert_projectile(saved[0].entity, saved[0].tag);
+	check_matches({ saved[0] }, {});
+
+	printf("projectile archetype matched the reference over 4000 changes, %zu rows per chunk\n", capacity);
+	return 0;
+}
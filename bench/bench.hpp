@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+
+#include "world.hpp"
+
+// Shared helpers of the benchmarks and checks in this folder
+
+// Checks stay on in every build type, the check targets are compiled with -UNDEBUG
+#define CHECK(...) assert((__VA_ARGS__))
+
+// Wall time of fn in milliseconds, best of runs so that a descheduled run does not count
+template <typename Fn>
+double time_ms(Fn fn, int runs = 5)
+{
+	double best = 1e30;
+	for (int run = 0; run < runs; run++) {
+		auto start = std::chrono::steady_clock::now();
+		fn();
+		double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		if (ms < best)
+			best = ms;
+	}
+	return best;
+}
+
+// Keeps the compiler from dropping a result that is otherwise unused
+template <typename T>
+void keep(T value)
+{
+	[[maybe_unused]] static volatile T sink;
+	sink = value;
+}
+
+// Small fast random numbers, the same sequence on every platform
+struct BenchRandom
+{
+	uint64_t state = 0x9E3779B97F4A7C15ull;
+
+	uint32_t next()
+	{
+		state ^= state << 13;
+		state ^= state >> 7;
+		state ^= state << 17;
+		return (uint32_t)state;
+	}
+
+	// in [0, 1)
+	float unit() { return (next() >> 8) * (1.f / 16777216.f); }
+};
+
+// A World that is the current one of the calling thread for as long as it lives
+struct BenchWorld : World
+{
+	BenchWorld() { make_current(); }
+};
+
+// A static wall in the current world, its collider is box big, turned with the Motion and offset from it
+inline Entity add_wall(vec2 position, vec2 scale, float angle, vec2 box, vec2 offset)
+{
+	Entity e = registry().create();
+	Motion& motion = registry().motions.emplace(e);
+	motion.position = position;
+	motion.scale = scale;
+	motion.angle = angle;
+	AABB& aabb = registry().AABBs.emplace(e);
+	aabb.collision_box = box;
+	aabb.offset = offset;
+	registry().staticCollidables.emplace(e);
+	return e;
+}
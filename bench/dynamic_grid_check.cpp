@@ -0,0 +1,42 @@
+// DynamicGrid queries return exactly the boxes that a test against every box finds, in index order,
+// including boxes too large for the cells and queries covering more cells than there are buckets
+
+#include "dynamic_grid.hpp"
+#include "bench.hpp"
+
+#include <vector>
+
+int main()
+{
+	BenchRandom random;
+	DynamicGrid grid;
+	size_t queries = 0;
+	for (int round = 0; round < 30; round++) {
+		std::vector<std::pair<vec2, vec2>> boxes;
+		grid.clear(96.f);
+		int count = 200 + round * 50;
+		for (int i = 0; i < count; i++) {
+			vec2 center = { random.unit() * 3000.f - 500.f, random.unit() * 3000.f - 500.f };
+			float radius = i % 97 == 0 ? 3000.f : 2.f + random.unit() * 38.f;
+			boxes.push_back({ center - vec2(radius), center + vec2(radius) });
+			CHECK(grid.add(center - vec2(radius), center + vec2(radius)) == (uint32_t)i);
+		}
+		grid.build();
+
+		for (int q = 0; q < 300; q++) {
+			vec2 center = { random.unit() * 3000.f, random.unit() * 3000.f };
+			float radius = q % 50 == 0 ? 5000.f : 4.f + random.unit() * 76.f;
+			vec2 min = center - vec2(radius), max = center + vec2(radius);
+			std::vector<uint32_t> found, expected;
+			grid.query(min, max, [&](uint32_t item) { found.push_back(item); });
+			for (uint32_t i = 0; i < boxes.size(); i++) {
+				if (!(boxes[i].second.x < min.x || max.x < boxes[i].first.x || boxes[i].second.y < min.y || max.y < boxes[i].first.y))
+					expected.push_back(i);
+			}
+			CHECK(found == expected);
+			queries++;
+		}
+	}
+	printf("DynamicGrid matched brute force on %zu queries\n", queries);
+	return 0;
+}
@@ -0,0 +1,133 @@
+// insert/get/has/remove throughput of ComponentContainer, the paged sparse set, against the
+// unordered_map container it replaced, for 1k to 1M entities
+
+#include "bench.hpp"
+#include "tinyECS/tiny_ecs.hpp"
+
+#include <unordered_map>
+#include <vector>
+
+// The container as it was before the sparse set, reduced to the operations measured here
+template <typename Component>
+class HashMapContainer
+{
+	std::unordered_map<unsigned int, unsigned int> map_entity_componentID;
+
+public:
+	std::vector<Component> components;
+	std::vector<Entity> entities;
+
+	Component& insert(Entity e, Component c)
+	{
+		map_entity_componentID[e] = (unsigned int)components.size();
+		components.push_back(std::move(c));
+		entities.push_back(e);
+		return components.back();
+	}
+
+	Component& get(Entity e) {
+		return components[map_entity_componentID[e]];
+	}
+
+	bool has(Entity entity) {
+		return map_entity_componentID.count(entity) > 0;
+	}
+
+	void remove(Entity e)
+	{
+		if (has(e))
+		{
+			int cID = map_entity_componentID[e];
+			components[cID] = std::move(components.back());
+			entities[cID] = entities.back();
+			map_entity_componentID[entities.back()] = cID;
+			map_entity_componentID.erase(e);
+			components.pop_back();
+			entities.pop_back();
+		}
+	}
+};
+
+// Same size as Motion
+struct Payload
+{
+	float values[8];
+};
+
+struct Result
+{
+	double insert_ns, get_ns, has_ns, remove_ns;
+};
+
+// entities holds n live handles in creation order, probe holds them shuffled plus as many that were never inserted
+template <typename Container>
+Result run(const std::vector<Entity>& entities, const std::vector<Entity>& shuffled, const std::vector<Entity>& probe)
+{
+	size_t n = entities.size();
+	Result result;
+	Container container;
+
+	result.insert_ns = time_ms([&] {
+		container = Container();
+		for (Entity e : entities)
+			container.insert(e, Payload{});
+	}) * 1e6 / n;
+
+	result.get_ns = time_ms([&] {
+		float sum = 0.f;
+		for (Entity e : shuffled)
+			sum += container.get(e).values[0];
+		keep(sum);
+	}) * 1e6 / n;
+
+	result.has_ns = time_ms([&] {
+		size_t found = 0;
+		for (Entity e : probe)
+			found += container.has(e);
+		keep(found);
+	}) * 1e6 / probe.size();
+
+	// every run removes everything, so fill the container again outside of the timed part
+	double best = 1e30;
+	for (int run = 0; run < 5; run++) {
+		container = Container();
+		for (Entity e : entities)
+			container.insert(e, Payload{});
+		best = std::min(best, time_ms([&] {
+			for (Entity e : shuffled)
+				container.remove(e);
+		}, 1));
+	}
+	result.remove_ns = best * 1e6 / n;
+	return result;
+}
+
+int main()
+{
+	printf("ns per operation, random order for get/has/remove, half of the has() probes miss\n");
+	printf("%9s  %-10s %8s %8s %8s %8s\n", "entities", "container", "insert", "get", "has", "remove");
+	for (size_t n : { (size_t)1000, (size_t)10000, (size_t)100000, (size_t)1000000 }) {
+		EntityPool pool;
+		std::vector<Entity> entities, missing;
+		for (size_t i = 0; i < n; i++)
+			entities.push_back(pool.create());
+		for (size_t i = 0; i < n; i++)
+			missing.push_back(pool.create());
+
+		BenchRandom random;
+		std::vector<Entity> shuffled = entities;
+		for (size_t i = n - 1; i > 0; i--)
+			std::swap(shuffled[i], shuffled[random.next() % (i + 1)]);
+		std::vector<Entity> probe;
+		for (size_t i = 0; i < n; i++) {
+			probe.push_back(shuffled[i]);
+			probe.push_back(missing[random.next() % n]);
+		}
+
+		Result old_result = run<HashMapContainer<Payload>>(entities, shuffled, probe);
+		Result new_result = run<ComponentContainer<Payload>>(entities, shuffled, probe);
+		printf("%9zu  %-10s %8.1f %8.1f %8.1f %8.1f\n", n, "hash map", old_result.insert_ns, old_result.get_ns, old_result.has_ns, old_result.remove_ns);
+		printf("%9zu  %-10s %8.1f %8.1f %8.1f %8.1f\n", n, "sparse set", new_result.insert_ns, new_result.get_ns, new_result.has_ns, new_result.remove_ns);
+	}
+	return 0;
+}
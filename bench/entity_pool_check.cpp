@@ -0,0 +1,60 @@
+// Entity handles stay stale under projectile-like churn, and snapshots of the pool give handles back
+
+#include "tinyECS/tiny_ecs.hpp"
+#include "bench.hpp"
+
+#include <cstdio>
+#include <vector>
+
+int main()
+{
+	// a few hundred long lived entities and a bullet that is gone right away
+	EntityPool pool;
+	std::vector<Entity> live;
+	for (int i = 0; i < 300; i++)
+		live.push_back(pool.create());
+	Entity stale = pool.create();
+	pool.destroy(stale);
+	CHECK(!pool.valid(stale));
+
+	// more bullets that live for a moment: with the most recently freed index reused first, every one of them
+	// would get the index of stale, which would be back at its generation after 4096 bullets
+	const int steps = 1000000;
+	for (int step = 0; step < steps; step++) {
+		Entity bullet = pool.create();
+		CHECK(!pool.valid(stale));
+		pool.destroy(bullet);
+		// and now and then a long lived one changes
+		if (step % 7 == 0) {
+			pool.destroy(live[step % live.size()]);
+			live[step % live.size()] = pool.create();
+		}
+	}
+	for (Entity e : live)
+		CHECK(pool.valid(e));
+	CHECK(pool.alive() == live.size());
+	// the queue keeps the indices in use bounded
+	for (Entity e : live)
+		CHECK(e.index() <= live.size() + EntityPool::MIN_FREE_INDICES + 1);
+
+	// rolling back brings the saved handles back and keeps later ones stale
+	EntityPool saved = pool;
+	std::vector<Entity> later;
+	for (int i = 0; i < 2000; i++)
+		later.push_back(pool.create());
+	pool.destroy(live[0]);
+	pool.restore(saved);
+	for (Entity e : live)
+		CHECK(pool.valid(e));
+	for (Entity e : later)
+		CHECK(!pool.valid(e));
+	for (int i = 0; i < 5000; i++) {
+		Entity e = pool.create();
+		for (Entity old : later)
+			CHECK(old.id() != e.id() || !pool.valid(old));
+		pool.destroy(e);
+	}
+
+	printf("entity pool ok\n");
+	return 0;
+}
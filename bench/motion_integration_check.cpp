@@ -0,0 +1,55 @@
+// integrate_motions gives bit for bit the results of integrate_motion, including the int modulo of the angle
+
+#include "motion_integration.hpp"
+#include "bench.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+// Angles where the float version of (int)(angle + angle_velocity) % 360 can go wrong:
+// around multiples of 360, around 0, fractions that truncate towards 0, and the 2^23 limit of the fast path
+static float tricky_angle(BenchRandom& random)
+{
+	static const float picks[] = {
+		0.f, -0.f, 0.5f, -0.5f, 0.99999994f, -0.99999994f, 1.f, -1.f,
+		359.f, 359.5f, 359.99997f, 360.f, 360.5f, -359.5f, -360.f, -360.5f, 719.99994f, 720.f, -720.f,
+		1e6f + 0.5f, -1e6f - 0.5f, 8388607.f, 8388607.5f, -8388607.f, 8388608.f, -8388608.f, 8388609.f, 1e9f, -1e9f
+	};
+	if (random.next() % 3 == 0)
+		return picks[random.next() % (sizeof(picks) / sizeof(picks[0]))];
+	float scale = random.next() % 2 ? 360.f : 1e5f;
+	return (random.unit() * 2.f - 1.f) * scale;
+}
+
+int main()
+{
+	BenchRandom random;
+	size_t bodies = 0;
+	for (int round = 0; round < 2000; round++) {
+		// counts that are not a multiple of 8 run the scalar tail too
+		size_t count = random.next() % 100;
+		std::vector<Motion> motions(count);
+		for (Motion& motion : motions) {
+			motion.position = { (random.unit() - 0.5f) * 1e4f, (random.unit() - 0.5f) * 1e4f };
+			motion.velocity = { (random.unit() - 0.5f) * 6000.f, (random.unit() - 0.5f) * 6000.f };
+			motion.scale = { random.unit() * 100.f, random.unit() * 100.f };
+			motion.angle = tricky_angle(random);
+			uint32_t kind = random.next() % 4;
+			motion.angle_velocity = kind == 0 ? 0.f : kind == 1 ? tricky_angle(random) : (random.unit() - 0.5f) * 20.f;
+			if (kind == 3)
+				motion.angle_velocity = std::floor(motion.angle_velocity);
+		}
+		float delta_time = random.next() % 2 ? 1.f / 60.f : random.unit() * 0.1f;
+
+		std::vector<Motion> expected = motions;
+		for (Motion& motion : expected)
+			integrate_motion(motion, delta_time);
+		integrate_motions(motions.data(), motions.size(), delta_time);
+
+		CHECK(std::memcmp(expected.data(), motions.data(), count * sizeof(Motion)) == 0);
+		bodies += count;
+	}
+	printf("integrate_motions matches integrate_motion on %zu bodies\n", bodies);
+	return 0;
+}
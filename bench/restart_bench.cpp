@@ -0,0 +1,99 @@
+// Cost of restarting a level: restoring the snapshot taken at the level start against tearing down and respawning
+// the enemies and pickups as the full restart does. The level has the entity counts of level 3, the walls and props
+// stay in place either way. The spatial hash and the map are not part of this, both are kept by a restore
+
+#include "bench.hpp"
+
+static void spawn_enemy(BenchRandom& random)
+{
+	Entity e = registry().create();
+	Motion& motion = registry().motions.emplace(e);
+	motion.position = { random.unit() * 6000.f, random.unit() * 6000.f };
+	motion.scale = { 64.f, 64.f };
+	registry().enemies.emplace(e);
+	registry().guns.emplace(e);
+	registry().circlebounds.emplace(e).collision_radius = 24.f;
+	registry().collidables.emplace(e);
+	registry().movingCircleCollidables.emplace(e);
+	registry().renderRequests.emplace(e);
+	registry().pathComponents.emplace(e);
+	registry().walkSoundTimers.emplace(e);
+}
+
+static void spawn_pickup(BenchRandom& random)
+{
+	Entity e = registry().create();
+	registry().motions.emplace(e).position = { random.unit() * 6000.f, random.unit() * 6000.f };
+	registry().pickups.emplace(e);
+	registry().renderRequests.emplace(e);
+	registry().textureWithoutLighting.emplace(e);
+}
+
+// what a few minutes of play leave behind: dead enemies, flying projectiles, a gun on the floor
+static void play(BenchRandom& random)
+{
+	for (int i = 0; i < 60; i++)
+		registry().deadEnemies.emplace(registry().enemies.entities[i]);
+	for (int i = 0; i < 200; i++) {
+		Entity e = registry().create();
+		registry().motions.emplace(e).velocity = { 3000.f, 0.f };
+		registry().projectiles.emplace(e);
+		registry().AABBs.emplace(e);
+		registry().collidables.emplace(e);
+		registry().renderRequests.emplace(e);
+	}
+	spawn_pickup(random);
+}
+
+int main()
+{
+	BenchWorld world;
+
+	const int walls = 4000, enemies = 150, pickups = 40;
+	BenchRandom random;
+	for (int i = 0; i < walls; i++) {
+		Entity e = registry().create();
+		Motion& motion = registry().motions.emplace(e);
+		motion.position = { random.unit() * 6000.f, random.unit() * 6000.f };
+		motion.scale = { 64.f, 64.f };
+		registry().AABBs.emplace(e);
+		registry().staticCollidables.emplace(e);
+		registry().renderRequests.emplace(e);
+		registry().motions.freeze(e);
+	}
+	for (int i = 0; i < enemies; i++)
+		spawn_enemy(random);
+	for (int i = 0; i < pickups; i++)
+		spawn_pickup(random);
+
+	const int restarts = 50;
+	ECSRegistry::Snapshot level_start;
+	double snapshot_ms = time_ms([&] {
+		for (int i = 0; i < restarts; i++)
+			level_start = registry().snapshot();
+	}) / restarts;
+
+	double restore_ms = 0.0, rebuild_ms = 0.0;
+	for (int i = 0; i < restarts; i++) {
+		play(random);
+		restore_ms += time_ms([&] { registry().restore(level_start); }, 1);
+
+		play(random);
+		rebuild_ms += time_ms([&] {
+			while (!registry().enemies.entities.empty())
+				registry().destroy(registry().enemies.entities.back());
+			while (!registry().projectiles.entities.empty())
+				registry().destroy(registry().projectiles.entities.back());
+			while (!registry().pickups.entities.empty())
+				registry().destroy(registry().pickups.entities.back());
+			for (int j = 0; j < enemies; j++)
+				spawn_enemy(random);
+			for (int j = 0; j < pickups; j++)
+				spawn_pickup(random);
+		}, 1);
+		registry().restore(level_start);
+	}
+	printf("%d entities, snapshot %.3f ms and %zu bytes\n", (int)registry().motions.size(), snapshot_ms, level_start.data.byte_size());
+	printf("restart: %.3f ms restoring the snapshot, %.3f ms destroying and respawning\n", restore_ms / restarts, rebuild_ms / restarts);
+	return 0;
+}
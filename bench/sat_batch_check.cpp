@@ -0,0 +1,79 @@
+// StaticBatch gives the results of AABBCircleSAT and AABBSAT bit for bit: random statics, rotated and axis aligned,
+// with and without collider offsets and with zero width boxes, against circles and boxes, some placed exactly on a corner.
+// Built twice, once with the SSE kernels and once with SAT_DISABLE_SIMD for the scalar ones
+
+#include "sat_batch.hpp"
+#include "bench.hpp"
+
+#include <vector>
+
+int main()
+{
+	BenchRandom random;
+	auto between = [&](float low, float high) { return low + random.unit() * (high - low); };
+	EntityPool pool;
+	long tests = 0, hits = 0;
+	for (int round = 0; round < 3000; round++) {
+		int count = 1 + random.next() % 23;
+		std::vector<Entity> statics;
+		std::vector<Motion> motions;
+		std::vector<AABB> aabbs;
+		SpatialHash hash;
+		for (int i = 0; i < count; i++) {
+			Entity e = pool.create();
+			Motion motion;
+			motion.position = { between(0.f, 800.f), between(0.f, 800.f) };
+			motion.scale = { between(1.f, 200.f), between(1.f, 200.f) };
+			int kind = random.next() % 4;
+			motion.angle = kind == 0 ? 0.f : kind == 1 ? 90.f : between(-360.f, 360.f);
+			AABB aabb;
+			aabb.collision_box = random.next() % 5 == 0 ? vec2(0.f, between(1.f, 200.f)) : vec2(between(1.f, 200.f), between(1.f, 200.f));
+			aabb.offset = random.next() % 2 ? vec2(0.f) : vec2(between(-20.f, 20.f), between(-20.f, 20.f));
+			if (hash.shapes.size() <= e.index())
+				hash.shapes.resize(e.index() + 1);
+			hash.shapes[e.index()] = make_static_shape(motion, aabb);
+			statics.push_back(e);
+			motions.push_back(motion);
+			aabbs.push_back(aabb);
+		}
+		StaticBatch batch;
+		batch.gather(hash, statics);
+		CHECK(batch.size() == statics.size());
+
+		for (int q = 0; q < 20; q++) {
+			vec2 center = { between(0.f, 800.f), between(0.f, 800.f) };
+			if (q == 0)
+				center = hash.shapes[statics[0].index()].corners[random.next() % 4];
+			CircleBound circle;
+			circle.collision_radius = between(1.f, 60.f);
+			Motion circle_motion;
+			circle_motion.position = center;
+			batch.test_circle(center, circle.collision_radius);
+			std::vector<bool> circle_hits(count);
+			for (int i = 0; i < count; i++)
+				circle_hits[i] = batch.hit(i);
+
+			Motion box_motion;
+			box_motion.position = center;
+			box_motion.angle = random.next() % 2 ? 0.f : between(-360.f, 360.f);
+			AABB box;
+			box.collision_box = { between(1.f, 200.f), between(1.f, 200.f) };
+			vec2 box_center = get_relative_center(box_motion.position, box_motion.angle, box.offset);
+			std::array<vec2, 4> box_corners = get_rotated_corners(box_center, box.collision_box, box_motion.angle);
+			batch.test_box(box_center, box_corners, box.collision_box);
+
+			for (int i = 0; i < count; i++) {
+				vec2 static_center = get_relative_center(motions[i].position, motions[i].angle, aabbs[i].offset);
+				std::array<vec2, 4> corners = get_rotated_corners(static_center, aabbs[i].collision_box, motions[i].angle);
+				bool circle_hit = AABBCircleSAT(static_center, aabbs[i], corners, center, circle, circle_motion, 1.f / 60.f);
+				bool box_hit = AABBSAT(static_center, corners, aabbs[i], box_center, box_corners, box, 1.f / 60.f);
+				CHECK(circle_hits[i] == circle_hit);
+				CHECK(batch.hit(i) == box_hit);
+				hits += circle_hit + box_hit;
+				tests += 2;
+			}
+		}
+	}
+	printf("StaticBatch matched the scalar tests on %ld pairs, %ld of them touching\n", tests, hits);
+	return 0;
+}
@@ -0,0 +1,87 @@
+// Frame time of the playing schedule of main() run one system after another, and by the scheduler on every core.
+// The systems are stand-ins that do a fixed amount of work each, with the access declarations of main(): which systems
+// overlap comes from the real declarations, how long each one takes is made up. On a single core the threaded run
+// can not be faster, the difference is then the cost of the scheduler itself
+
+#include "bench.hpp"
+#include "scheduler.hpp"
+
+#include <algorithm>
+#include <thread>
+
+// Work that takes the same number of instructions on every thread, unlike waiting for a point in time
+static void work(uint32_t steps)
+{
+	uint32_t x = 0x9E3779B9u;
+	for (uint32_t i = 0; i < steps; i++) {
+		x ^= x << 13;
+		x ^= x >> 17;
+		x ^= x << 5;
+	}
+	keep(x);
+}
+
+int main()
+{
+	BenchWorld world;
+	unsigned int hardware_threads = std::thread::hardware_concurrency();
+	unsigned int workers = std::max(1u, std::min(hardware_threads > 1 ? hardware_threads - 1 : 1u, MAX_THREADS - 1));
+	world.start_workers(workers);
+
+	// steps per millisecond on this machine
+	uint32_t steps_per_ms = (uint32_t)(1000000 / time_ms([] { work(1000000); }));
+	auto system = [&](float ms) {
+		uint32_t steps = (uint32_t)(ms * steps_per_ms);
+		return [steps](float) { work(steps); };
+	};
+
+	SystemSchedule schedule;
+	schedule.add("world", SystemAccess::exclusive(), system(0.05f));
+	schedule.add("flush", SystemAccess::exclusive(), system(0.01f));
+	schedule.add("ai",
+		SystemAccess()
+			.read<Player, Map, GameProgress>()
+			.write<Enemy, Motion, Gun, PathComponent>()
+			.write<Projectile, AABB, Collidable, MovingCollidable, MovingSAT, Pickup, RenderRequest, Light, RemoveTimer, Animation, TextureWithoutLighting>()
+			.use(SYSTEM_RESOURCE::ENTITIES).use(SYSTEM_RESOURCE::AUDIO),
+		system(0.4f));
+	schedule.add("hud", SystemAccess().read<Player, Dash>().write<UI>(), system(0.02f));
+	schedule.add("physics",
+		SystemAccess()
+			.read<Projectile, Player, Map, GameProgress, Mesh*>()
+			.read<AABB, Collidable, CircleBound, StaticCollidable, MovingCollidable, MovingCircle, MovingSAT, meshCollidable>()
+			.write<Motion, Collision, RenderRequest, SpatialHash>()
+			.write<Gun, Pickup, TextureWithoutLighting>()
+			.use(SYSTEM_RESOURCE::ENTITIES),
+		system(0.4f));
+	schedule.add("transforms", SystemAccess().write<Parent, Motion>(), system(0.05f));
+	schedule.add("animation timers", SystemAccess().write<Animation>(), system(0.05f));
+	schedule.add("flush", SystemAccess::exclusive(), system(0.01f));
+	schedule.add("player", SystemAccess::exclusive(), system(0.1f));
+	schedule.add("animation", SystemAccess().write<Animation, RenderRequest>().use(SYSTEM_RESOURCE::ENTITIES), system(0.1f));
+	schedule.add("flush", SystemAccess::exclusive(), system(0.01f));
+	schedule.add("ui",
+		SystemAccess()
+			.read<Input, Player, Gun>()
+			.write<UI, Text, RenderRequest, Motion, Animation, TextureWithoutLighting>()
+			.use(SYSTEM_RESOURCE::ENTITIES).use(SYSTEM_RESOURCE::AUDIO).use(SYSTEM_RESOURCE::GAME_STATE),
+		system(0.02f));
+	schedule.add("collisions", SystemAccess::exclusive(), system(0.1f));
+	schedule.add("input", SystemAccess().write<Input>(), system(0.01f));
+	schedule.print();
+
+	const int frames = 200;
+	debugging.single_threaded_systems = true;
+	double serial_ms = time_ms([&] {
+		for (int frame = 0; frame < frames; frame++)
+			world.scheduler.run(schedule, 16.f);
+	}) / frames;
+	debugging.single_threaded_systems = false;
+	double threaded_ms = time_ms([&] {
+		for (int frame = 0; frame < frames; frame++)
+			world.scheduler.run(schedule, 16.f);
+	}) / frames;
+	printf("playing schedule: %.3f ms per frame on 1 thread, %.3f ms on %u threads (%u cores)\n",
+		serial_ms, threaded_ms, world.scheduler.thread_count(), hardware_threads);
+	return 0;
+}
@@ -0,0 +1,82 @@
+// Queries of the static spatial hash report every static sharing a cell with the body once, in cell order,
+// and allocate nothing once the candidate buffer has grown, the same goes for adding a static to a grown hash
+
+#include "physics_system_init.hpp"
+#include "bench.hpp"
+
+#include <vector>
+
+int main()
+{
+	BenchWorld world;
+	registry().on_construct<StaticCollidable>().connect<&add_static_to_hash>();
+	registry().on_destroy<StaticCollidable>().connect<&remove_static_from_hash>();
+
+	SpatialHash& hash = registry().spatialHashes.emplace(registry().create());
+	hash.width = 50;
+	hash.height = 50;
+	add_statics_to_hash(hash);
+
+	BenchRandom random;
+	std::vector<Entity> walls;
+	for (int i = 0; i < 3000; i++) {
+		vec2 position = { random.unit() * 5000.f, random.unit() * 5000.f };
+		vec2 scale = { 20.f + random.unit() * 380.f, 20.f + random.unit() * 380.f };
+		walls.push_back(add_wall(position, scale, 0.f, scale, vec2(0.f)));
+	}
+	for (int i = 0; i < 500; i++)
+		registry().destroy(walls[i * 3]);
+
+	std::vector<Motion> bodies(2200);
+	for (Motion& body : bodies) {
+		body.position = { random.unit() * 5000.f, random.unit() * 5000.f };
+		body.scale = { 30.f, 30.f };
+	}
+
+	// every static of the cells once, in the order the cells list them
+	std::vector<Entity> candidates;
+	std::vector<bool> seen;
+	for (const Motion& body : bodies) {
+		get_potential_collisions(hash, Entity(), body, candidates);
+		std::vector<Entity> expected;
+		seen.assign(registry().motions.size() + 4096, false);
+		auto [top_left, bottom_right] = get_cells_for_entity(hash, body);
+		for (int x = top_left.x; x <= bottom_right.x; x++) {
+			for (int y = top_left.y; y <= bottom_right.y; y++) {
+				for (Entity e : get_entities_in_cell(hash, { x, y })) {
+					if (!seen[e.index()]) {
+						seen[e.index()] = true;
+						expected.push_back(e);
+					}
+				}
+			}
+		}
+		CHECK(candidates == expected);
+	}
+
+	// a frame of queries after the first one allocates nothing
+	uint64_t before = allocation_count();
+	size_t found = 0;
+	for (int frame = 0; frame < 10; frame++) {
+		for (const Motion& body : bodies) {
+			get_potential_collisions(hash, Entity(), body, candidates);
+			found += candidates.size();
+			for (Entity e : get_entities_in_cell(hash, world_pos_to_hash_cell(hash, body.position)))
+				found += e.index() & 1;
+		}
+	}
+	CHECK(allocation_count() == before);
+
+	// tracking a static is a store into arrays that only grow now and then, not an allocation per static
+	before = allocation_count();
+	const int swaps = 1000;
+	for (int i = 0; i < swaps; i++) {
+		registry().destroy(registry().staticCollidables.entities.back());
+		add_wall({ random.unit() * 5000.f, random.unit() * 5000.f }, { 30.f, 30.f }, 0.f, { 30.f, 30.f }, vec2(0.f));
+	}
+	uint64_t swap_allocations = allocation_count() - before;
+	CHECK(swap_allocations < swaps / 10);
+	printf("%zu candidates in 10 frames of %zu queries without allocating, %llu allocations for %d wall swaps\n",
+		found, bodies.size(), (unsigned long long)swap_allocations, swaps);
+	return 0;
+}
@@ -0,0 +1,70 @@
+// The compressed rows of the static spatial hash against one vector per cell, over 3000 random wall additions and
+// removals: after every change each cell lists the same statics in the same order
+
+#include "physics_system_init.hpp"
+#include "bench.hpp"
+
+#include <algorithm>
+#include <vector>
+
+static Entity add_random_wall(BenchRandom& random)
+{
+	vec2 position = { random.unit() * 2000.f, random.unit() * 2000.f };
+	vec2 scale = { 20.f + random.unit() * 280.f, 20.f + random.unit() * 280.f };
+	return add_wall(position, scale, 0.f, scale, vec2(0.f));
+}
+
+int main()
+{
+	BenchWorld world;
+	registry().on_construct<StaticCollidable>().connect<&add_static_to_hash>();
+	registry().on_destroy<StaticCollidable>().connect<&remove_static_from_hash>();
+
+	BenchRandom random;
+	std::vector<Entity> walls;
+	for (int i = 0; i < 400; i++)
+		walls.push_back(add_random_wall(random));
+
+	const int size = 20;
+	SpatialHash& hash = registry().spatialHashes.emplace(registry().create());
+	hash.width = size;
+	hash.height = size;
+	add_statics_to_hash(hash);
+
+	// statics are appended to their cells and removed without changing the order of the others
+	std::vector<std::vector<Entity>> reference(size * size);
+	auto add_reference = [&](Entity e) {
+		const SpatialHash::StaticCells& cells = hash.static_cells[e.index()];
+		for (int x = cells.first.x; x <= cells.last.x; x++)
+			for (int y = cells.first.y; y <= cells.last.y; y++)
+				reference[y * size + x].push_back(e);
+	};
+	for (Entity e : registry().staticCollidables.entities)
+		add_reference(e);
+
+	const int steps = 3000;
+	for (int step = 0; step < steps; step++) {
+		if (random.next() % 2 && !walls.empty()) {
+			size_t k = random.next() % walls.size();
+			Entity e = walls[k];
+			walls.erase(walls.begin() + k);
+			for (std::vector<Entity>& cell : reference)
+				cell.erase(std::remove(cell.begin(), cell.end(), e), cell.end());
+			registry().destroy(e);
+		}
+		else {
+			Entity e = add_random_wall(random);
+			walls.push_back(e);
+			add_reference(e);
+		}
+
+		for (int y = 0; y < size; y++) {
+			for (int x = 0; x < size; x++) {
+				CellEntities cell = get_entities_in_cell(hash, { x, y });
+				CHECK(std::vector<Entity>(cell.begin(), cell.end()) == reference[y * size + x]);
+			}
+		}
+	}
+	printf("rows matched the reference over %d changes, %zu statics in %zu slots\n", steps, walls.size(), hash.cell_entities.size());
+	return 0;
+}
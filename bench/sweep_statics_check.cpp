@@ -0,0 +1,69 @@
+// sweep_statics against a brute force sweep over every static, on 20000 random segments through walls whose colliders
+// are rotated, offset and larger than their Motion. The brute force is a hash of a single cell, which holds every static
+
+#include "physics_system_init.hpp"
+#include "bench.hpp"
+
+#include <cmath>
+#include <vector>
+
+int main()
+{
+	BenchWorld world;
+	registry().on_construct<StaticCollidable>().connect<&add_static_to_hash>();
+	registry().on_destroy<StaticCollidable>().connect<&remove_static_from_hash>();
+
+	SpatialHash& hash = registry().spatialHashes.emplace(registry().create());
+	hash.width = 20;
+	hash.height = 20;
+	add_statics_to_hash(hash);
+
+	// a collider two cells to the right of its Motion, a segment passing only through the cells of the collider
+	Entity overhang = add_wall({ 250.f, 1950.f }, { 40.f, 40.f }, 0.f, { 40.f, 40.f }, { 200.f, 0.f });
+	Entity hit;
+	float hit_t;
+	CHECK(sweep_statics(hash, { 450.f, 1850.f }, { 450.f, 2000.f }, 0.f, hit, hit_t) && hit == overhang);
+
+	BenchRandom random;
+	for (int i = 0; i < 50; i++) {
+		vec2 size = { 5.f + random.unit() * 295.f, 5.f + random.unit() * 295.f };
+		int kind = random.next() % 3;
+		float angle = kind == 0 ? 0.f : kind == 1 ? 90.f : random.unit() * 360.f;
+		// some boxes without width, and colliders up to twice the Motion, up to 150 from it
+		vec2 box = random.next() % 10 == 0 ? vec2(0.f, size.y) : size * (0.5f + random.unit() * 1.5f);
+		vec2 offset = vec2(random.unit() - 0.5f, random.unit() - 0.5f) * 300.f;
+		add_wall({ -100.f + random.unit() * 2200.f, -100.f + random.unit() * 2200.f }, size, angle, box, offset);
+	}
+
+	SpatialHash brute;
+	brute.width = 1;
+	brute.height = 1;
+	add_statics_to_hash(brute);
+
+	const int segments = 20000;
+	int hits = 0;
+	for (int i = 0; i < segments; i++) {
+		vec2 start = { -100.f + random.unit() * 2200.f, -100.f + random.unit() * 2200.f };
+		float length = i % 7 == 0 ? 0.f : random.unit() * 600.f;
+		float direction = random.unit() * 6.2832f;
+		vec2 end = i % 11 == 0 ? start + vec2(0.f, length) : start + length * vec2(std::cos(direction), std::sin(direction));
+		float radius = random.unit() * 40.f;
+
+		Entity brute_hit;
+		float brute_t;
+		bool brute_found = sweep_statics(brute, start, end, radius, brute_hit, brute_t);
+		bool found = sweep_statics(hash, start, end, radius, hit, hit_t);
+		// statics touched at the same t may come in either order
+		CHECK(found == brute_found);
+		CHECK(!found || hit_t == brute_t);
+		hits += found;
+	}
+
+	// a wall thinner than one frame of a fast projectile
+	Entity thin = add_wall({ 1000.f, 1000.f }, { 10.f, 400.f }, 0.f, { 4.f, 400.f }, vec2(0.f));
+	CHECK(sweep_statics(hash, { 700.f, 1000.f }, { 1300.f, 1000.f }, 0.f, hit, hit_t));
+	CHECK(hit == thin || hit_t < 0.5f);
+
+	printf("sweep_statics matched the brute force on %d segments, %d of them hitting\n", segments, hits);
+	return 0;
+}
@@ -0,0 +1,91 @@
+// Per-frame costs of the joins and the motion integration in PhysicsSystem::step, on a synthetic scene of
+// 2000 statics (wall sections, props, doors), 150 enemies and 400 projectiles.
+// level2 and level3 are not loaded: loading a map (MapSystem::render_map), the AI and the collision responses of the
+// physics step call into the renderer, the audio system and GLFW, which this project does not link. level3, the largest
+// level, is 50x50 tiles with 25 enemies and 63 props, so the scene is several times the load of a real frame
+
+#include "bench.hpp"
+#include "motion_integration.hpp"
+
+#include <vector>
+
+int main()
+{
+	BenchWorld world;
+
+	const int statics = 2000, enemies = 150, projectiles = 400;
+	BenchRandom random;
+	for (int i = 0; i < statics; i++) {
+		Entity e = registry().create();
+		Motion& motion = registry().motions.emplace(e);
+		motion.position = { random.unit() * 6000.f, random.unit() * 6000.f };
+		motion.scale = { 64.f, 64.f };
+		registry().AABBs.emplace(e);
+		registry().collidables.emplace(e);
+	}
+	for (int i = 0; i < enemies; i++) {
+		Entity e = registry().create();
+		Motion& motion = registry().motions.emplace(e);
+		motion.position = { random.unit() * 6000.f, random.unit() * 6000.f };
+		motion.velocity = { random.unit() * 200.f, random.unit() * 200.f };
+		registry().circlebounds.emplace(e);
+		registry().movingCircleCollidables.emplace(e);
+		registry().collidables.emplace(e);
+	}
+	for (int i = 0; i < projectiles; i++) {
+		Entity e = registry().create();
+		Motion& motion = registry().motions.emplace(e);
+		motion.velocity = { 3000.f, 0.f };
+		motion.angle_velocity = 2.f;
+		registry().AABBs.emplace(e);
+		registry().collidables.emplace(e);
+	}
+	const int frames = 1000;
+
+	// the joins of the collision loops, hand rolled with a get() per component as before views, and with a view
+	double join_ms = time_ms([&] {
+		for (int frame = 0; frame < frames; frame++) {
+			float sum = 0.f;
+			for (Entity e : registry().movingCircleCollidables.entities) {
+				if (!registry().motions.has(e) || !registry().circlebounds.has(e))
+					continue;
+				sum += registry().motions.get(e).position.x + registry().circlebounds.get(e).collision_radius;
+			}
+			keep(sum);
+		}
+	}) / frames;
+	double view_ms = time_ms([&] {
+		for (int frame = 0; frame < frames; frame++) {
+			float sum = 0.f;
+			for (auto [e, moving_circle, motion, circle_bound] : registry().view<MovingCircle, Motion, CircleBound>())
+				sum += motion.position.x + circle_bound.collision_radius;
+			keep(sum);
+		}
+	}) / frames;
+	printf("moving circle join:   %.4f ms per frame with get(), %.4f ms with a view\n", join_ms, view_ms);
+
+	// the integration loop, scalar over every Motion as before, and through the kernel
+	std::vector<Motion> copy(registry().motions.components);
+	double scalar_ms = time_ms([&] {
+		for (int frame = 0; frame < frames; frame++)
+			for (Motion& motion : copy)
+				integrate_motion(motion, 1.f / 60.f);
+	}) / frames;
+	double kernel_ms = time_ms([&] {
+		for (int frame = 0; frame < frames; frame++)
+			integrate_motions(copy.data(), copy.size(), 1.f / 60.f);
+	}) / frames;
+
+	// statics frozen at the tail are not integrated at all
+	for (Entity e : registry().AABBs.entities)
+		if (registry().motions.get(e).velocity == vec2(0.f))
+			registry().motions.freeze(e);
+	size_t active = registry().motions.active_size();
+	double active_ms = time_ms([&] {
+		for (int frame = 0; frame < frames; frame++)
+			integrate_motions(registry().motions.components.data(), active, 1.f / 60.f);
+	}) / frames;
+	printf("motion integration:   %.4f ms per frame scalar, %.4f ms with the kernel, %.4f ms skipping the %zu frozen statics\n",
+		scalar_ms, kernel_ms, active_ms, registry().motions.size() - active);
+	return 0;
+}
@@ -0,0 +1,94 @@
+// TagContainer against a plain list of members: the same members in the same order, stale handles do not match,
+// and a snapshot gives the members back
+
+#include "tinyECS/tiny_ecs.hpp"
+#include "bench.hpp"
+
+#include <algorithm>
+#include <vector>
+
+struct Tag {};
+
+int main()
+{
+	EntityPool pool;
+	TagContainer<Tag> tags;
+	std::vector<Entity> reference; // members, removed by moving the last one into the gap
+	std::vector<Entity> alive;
+	std::vector<Entity> dead;
+	BenchRandom random;
+
+	const int operations = 200000;
+	for (int op = 0; op < operations; op++) {
+		uint32_t kind = random.next() % 8;
+		if (kind < 3 || alive.empty()) {
+			Entity e = pool.create();
+			alive.push_back(e);
+			if (random.next() % 2) {
+				tags.insert(e);
+				reference.push_back(e);
+			}
+		}
+		else if (kind < 5) {
+			Entity e = alive[random.next() % alive.size()];
+			if (!tags.has(e)) {
+				tags.insert(e);
+				reference.push_back(e);
+			}
+		}
+		else if (kind < 7) {
+			Entity e = alive[random.next() % alive.size()];
+			tags.remove(e);
+			auto it = std::find(reference.begin(), reference.end(), e);
+			if (it != reference.end()) {
+				*it = reference.back();
+				reference.pop_back();
+			}
+		}
+		else {
+			// destroying takes the entity out of the set, its index comes back under a new generation
+			size_t i = random.next() % alive.size();
+			Entity e = alive[i];
+			tags.remove(e);
+			auto it = std::find(reference.begin(), reference.end(), e);
+			if (it != reference.end()) {
+				*it = reference.back();
+				reference.pop_back();
+			}
+			pool.destroy(e);
+			alive[i] = alive.back();
+			alive.pop_back();
+			dead.push_back(e);
+		}
+
+		if (op % 10000 == 0) {
+			CHECK(tags.entities == reference);
+			for (Entity e : alive)
+				CHECK(tags.has(e) == (std::find(reference.begin(), reference.end(), e) != reference.end()));
+			for (Entity e : dead)
+				CHECK(!tags.has(e));
+		}
+	}
+	CHECK(tags.size() == reference.size());
+
+	// save, change, load: the saved members and only those are back
+	SnapshotBuffer buffer;
+	tags.save(buffer);
+	std::vector<Entity> saved = tags.entities;
+	for (Entity e : saved)
+		if (random.next() % 2)
+			tags.remove(e);
+	for (int i = 0; i < 100; i++)
+		tags.insert(pool.create());
+	SnapshotReader reader(buffer);
+	tags.load(reader);
+	CHECK(tags.entities == saved);
+	for (Entity e : alive)
+		CHECK(tags.has(e) == (std::find(saved.begin(), saved.end(), e) != saved.end()));
+
+	tags.clear();
+	for (Entity e : saved)
+		CHECK(!tags.has(e));
+	printf("TagContainer matched the reference over %d operations\n", operations);
+	return 0;
+}
@@ -7,57 +7,82 @@ static inline int cell_key(const ivec2& cell, int grid_width) {
     return cell.y * grid_width + cell.x;
 }
 
-// use the "came from" map to reconstruct the path
-static std::vector<ivec2> reconstruct_path(const std::unordered_map<int, ivec2>& came_from, const ivec2& current, int grid_width) {
-    std::vector<ivec2> total_path;
-    ivec2 curr = current;
-    total_path.push_back(curr);
-    int key = cell_key(curr, grid_width);
-    while (came_from.find(key) != came_from.end()) {
-        curr = came_from.at(key);
-        total_path.push_back(curr);
-        key = cell_key(curr, grid_width);
+// Search state of every cell, kept between searches so that a replan does not allocate.
+// A cell only counts as reached if its stamp matches the current search, which saves clearing the arrays.
+// One per thread, so worlds running on different threads do not share it.
+struct PathScratch {
+    std::vector<float> g_score;
+    std::vector<int> came_from;     // key of the previous cell, -1 for the start
+    std::vector<uint32_t> stamps;
+    std::vector<Node> open_set;     // binary heap ordered by NodeComparator
+    uint32_t stamp = 0;
+};
+static thread_local PathScratch scratch;
+
+static void begin_search(int cell_count) {
+    if ((int)scratch.stamps.size() < cell_count) {
+        scratch.g_score.resize(cell_count);
+        scratch.came_from.resize(cell_count);
+        scratch.stamps.resize(cell_count, 0);
     }
-    std::reverse(total_path.begin(), total_path.end());
-    return total_path;
+    if (++scratch.stamp == 0) {
+        std::fill(scratch.stamps.begin(), scratch.stamps.end(), 0);
+        scratch.stamp = 1;
+    }
+    scratch.open_set.clear();
 }
 
-std::vector<ivec2> find_path(const ivec2& start, const ivec2& goal, const Map& map) {
-        std::priority_queue<Node, std::vector<Node>, NodeComparator> open_set;
-    std::unordered_map<int, float> g_score;
-    std::unordered_map<int, ivec2> came_from;
-    int gridWidth = map.grid_width;
+// use the "came from" links to reconstruct the path
+static void reconstruct_path(const ivec2& current, int grid_width, WaypointBuffer& path) {
+    path.clear();
+    int key = cell_key(current, grid_width);
+    while (key != -1) {
+        path.push_back({ key % grid_width, key / grid_width });
+        key = scratch.came_from[key];
+    }
+    std::reverse(path.begin(), path.end());
+}
 
-    auto cell_key = [&](const ivec2& c) {
-        return c.y * gridWidth + c.x;
-    };
+// 8 directions: up/down/left/right + diagonals
+static const std::pair<ivec2, float> directions[] = {
+    { {0, -1}, 1.f },
+    { {0,  1}, 1.f },
+    { {-1, 0}, 1.f },
+    { { 1, 0}, 1.f },
+
+    // diagonal movements. comment out if using manhattan
+    { { 1,  1}, 1.4142f },
+    { { 1, -1}, 1.4142f },
+    { {-1,  1}, 1.4142f },
+    { {-1, -1}, 1.4142f }
+};
+
+bool find_path(const ivec2& start, const ivec2& goal, const Map& map, WaypointBuffer& path) {
+    int gridWidth = map.grid_width;
+    if (start.x < 0 || start.y < 0 || start.x >= map.grid_width || start.y >= map.grid_height) {
+        path.clear();
+        return false;
+    }
+    begin_search(map.grid_width * map.grid_height);
+    std::vector<Node>& open_set = scratch.open_set;
+    NodeComparator comparator;
 
-    int startKey = cell_key(start);
+    int startKey = cell_key(start, gridWidth);
     float start_h = heuristic(start, goal);
-    g_score[startKey] = 0.f;
-    open_set.push(Node(start, 0.f, start_h, start));
-
-    // 8 directions: up/down/left/right + diagonals
-    std::vector<std::pair<ivec2, float>> directions = {
-        { {0, -1}, 1.f },
-        { {0,  1}, 1.f },
-        { {-1, 0}, 1.f },
-        { { 1, 0}, 1.f },
-
-        // diagonal movements. comment out if using manhattan
-        { { 1,  1}, 1.4142f },
-        { { 1, -1}, 1.4142f },
-        { {-1,  1}, 1.4142f },
-        { {-1, -1}, 1.4142f }
-    };
+    scratch.g_score[startKey] = 0.f;
+    scratch.came_from[startKey] = -1;
+    scratch.stamps[startKey] = scratch.stamp;
+    open_set.push_back(Node(start, 0.f, start_h, start));
 
     while (!open_set.empty()) {
-        Node current = open_set.top();
-        open_set.pop();
+        std::pop_heap(open_set.begin(), open_set.end(), comparator);
+        Node current = open_set.back();
+        open_set.pop_back();
 
         // if goal is reached
         if (current.pos == goal) {
-            return reconstruct_path(came_from, current.pos, gridWidth);
+            reconstruct_path(current.pos, gridWidth, path);
+            return true;
         }
 
         for (auto& dirPair : directions) {
@@ -81,17 +106,20 @@ std::vector<ivec2> find_path(const ivec2& start, const ivec2& goal, const Map& m
                 continue;
 
             float tentative_g = current.g + dirPair.second;
-            int neighKey = cell_key(neighbor);
-            if (g_score.find(neighKey) == g_score.end() || tentative_g < g_score[neighKey]) {
-                came_from[neighKey] = current.pos;
-                g_score[neighKey] = tentative_g;
+            int neighKey = cell_key(neighbor, gridWidth);
+            if (scratch.stamps[neighKey] != scratch.stamp || tentative_g < scratch.g_score[neighKey]) {
+                scratch.stamps[neighKey] = scratch.stamp;
+                scratch.came_from[neighKey] = cell_key(current.pos, gridWidth);
+                scratch.g_score[neighKey] = tentative_g;
                 float h = heuristic(neighbor, goal);
-                open_set.push(Node(neighbor, tentative_g, h, current.pos));
+                open_set.push_back(Node(neighbor, tentative_g, h, current.pos));
+                std::push_heap(open_set.begin(), open_set.end(), comparator);
             }
         }
     }
     // no path found
-    return {};
+    path.clear();
+    return false;
 }
 
 bool has_line_of_sight(const vec2& start, const vec2& end, const Map& map) {
@@ -43,6 +43,7 @@ inline bool traversable(const ivec2& cell, const Map& map) {
     return (map.tile_id_grid[cell.y][cell.x] != TILE_ID::WALL && map.tile_id_grid[cell.y][cell.x] != TILE_ID::CLOSED_DOOR);
 }
 
-std::vector<ivec2> find_path(const ivec2& start, const ivec2& goal, const Map& map);
+// Writes the cells from start to goal into path, returns false if goal can not be reached
+bool find_path(const ivec2& start, const ivec2& goal, const Map& map, WaypointBuffer& path);
 
 bool has_line_of_sight(const vec2& start, const vec2& end, const Map& map);
@@ -14,22 +14,39 @@
 
 #include "decision_tree_ai.hpp"
 #include "a_star_pathfinding.hpp"
+#include "scheduler.hpp"
 
 void AISystem::step(float elapsed_ms)
 {
 	if (!decisionTree)
 		decisionTree = build_decision_tree();
 
-	for (const Entity& enemy_entity : registry.enemies.entities) {
-		progress_timers(elapsed_ms, enemy_entity);
+	// Evaluating the decision tree only reads, so the enemies are evaluated in parallel up front.
+	// Acting on the decisions plans paths, shoots and alerts other enemies, that part stays on this thread.
+	// An enemy alerted by another one this frame reacts in the next.
+	auto& enemy_container = registry().enemies;
+	decisions.resize(enemy_container.size());
+	scheduler().parallel_for(enemy_container.size(), 8, [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; i++) {
+			Entity enemy_entity = enemy_container.entities[i];
+			if (!registry().motions.has(enemy_entity))
+				continue;
+			progress_timers(elapsed_ms, enemy_entity);
+			decisions[i] = decisionTree->evaluate(enemy_entity);
+		}
+	});
 
-		// Evaluate the decision tree for this enemy.
-		ENEMY_ACTION action = decisionTree->evaluate(enemy_entity);
-		auto& enemy = registry.enemies.get(enemy_entity);
-		auto& enemyMotion = registry.motions.get(enemy_entity);
+	for (size_t i = 0; i < enemy_container.size(); i++) {
+		Entity enemy_entity = enemy_container.entities[i];
+		Motion* motion = registry().motions.find(enemy_entity);
+		if (!motion)
+			continue;
+		Enemy& enemy = enemy_container.components[i];
+		Motion& enemyMotion = *motion;
+		ENEMY_ACTION action = decisions[i];
 
 		// if no player exists ex. player dies
-		if (registry.players.entities.empty()) {
+		if (registry().players.entities.empty()) {
 			// if no player, do nothing
 			enemyMotion.velocity = { 0, 0 };
 			enemy.state = ENEMY_STATE::IDLE;
@@ -87,17 +104,17 @@ void AISystem::step(float elapsed_ms)
 
 			update_enemy_rotation(enemy_entity, elapsed_ms);
 
-			Entity player = registry.players.entities[0];
-			Motion& player_motion = registry.motions.get(player);
+			Entity player = registry().players.entities[0];
+			Motion& player_motion = registry().motions.get(player);
 
 			ivec2 enemy_cell = world_to_grid_coords(enemyMotion.position.x, enemyMotion.position.y);
 			ivec2 player_cell = world_to_grid_coords(player_motion.position.x, player_motion.position.y);
 
 			// get or add the PathComponent assuming they dont already have one
-			if (!registry.pathComponents.has(enemy_entity)) {
-				registry.pathComponents.emplace(enemy_entity);
+			if (!registry().pathComponents.has(enemy_entity)) {
+				registry().pathComponents.emplace(enemy_entity);
 			}
-			auto& pathComp = registry.pathComponents.get(enemy_entity);
+			auto& pathComp = registry().pathComponents.get(enemy_entity);
 
 			// if enemy loses line of sight and player is moving, then invalidate the path
 			// reset stop timer so that when enemy reaches path, they don't stop immediately on the corner
@@ -109,16 +126,14 @@ void AISystem::step(float elapsed_ms)
 
 			// majority of path calculation here
 			if (!pathComp.valid) {
-				int current_level = registry.gameProgress.components[0].level;
-				Map& map = registry.maps.components[current_level];
-				std::vector<ivec2> newPath = find_path(enemy_cell, player_cell, map);
-				if (newPath.empty()) {
+				int current_level = registry().gameProgress.components[0].level;
+				Map& map = registry().maps.components[current_level];
+				// the path is written straight into the component
+				if (!find_path(enemy_cell, player_cell, map, pathComp.waypoints)) {
 					// no path found
 					enemyMotion.velocity = { 0, 0 };
 					break;
 				}
-				// store the path once found
-				pathComp.waypoints = newPath;
 				pathComp.current_index = 0;
 				pathComp.valid = true;
 				pathComp.target_cell = player_cell;
@@ -161,8 +176,8 @@ void AISystem::init(RenderSystem* renderer, AudioSystem* audio) {
 }
 
 void AISystem::update_velocity(Entity entity, float elapsed_ms) {
-	Enemy& enemy = registry.enemies.get(entity);
-	Motion& motion = registry.motions.get(entity);
+	Enemy& enemy = registry().enemies.get(entity);
+	Motion& motion = registry().motions.get(entity);
 	if (enemy.state == ENEMY_STATE::IDLE) {
 		float smooth_constant = 10.f;
 		float time_adjusted_constant = 1.0f - expf(-smooth_constant * (elapsed_ms / 1000.f));
@@ -173,9 +188,9 @@ void AISystem::update_velocity(Entity entity, float elapsed_ms) {
 // gets the distance from the enemy entity to the player
 float AISystem::get_distance_to_player(Entity entity) {
 
-	Entity player = registry.players.entities[0];
-	auto& player_motion = registry.motions.get(player);
-	auto& enemy_motion = registry.motions.get(entity);
+	Entity player = registry().players.entities[0];
+	auto& player_motion = registry().motions.get(player);
+	auto& enemy_motion = registry().motions.get(entity);
 
 	// Euclidean distance
 	return length(player_motion.position - enemy_motion.position);
@@ -183,9 +198,9 @@ float AISystem::get_distance_to_player(Entity entity) {
 
 // checks if enemy is currently set to combat state, and if so then enemy rotates to player and shoots
 void AISystem::shoot_if_aggro(Entity entity, float elapsed_ms) {
-	auto& enemy = registry.enemies.get(entity);
+	auto& enemy = registry().enemies.get(entity);
 
-	if (registry.players.entities.empty()) {
+	if (registry().players.entities.empty()) {
 		return;
 	}
 
@@ -198,10 +213,10 @@ void AISystem::shoot_if_aggro(Entity entity, float elapsed_ms) {
 
 // rotates enemy to face player
 void AISystem::update_enemy_rotation(Entity entity, float elapsed_ms) {
-	Entity player = registry.players.entities[0];
-	auto& player_motion = registry.motions.get(player);
-	auto& enemy_motion = registry.motions.get(entity);
-	auto& enemy = registry.enemies.get(entity);
+	Entity player = registry().players.entities[0];
+	auto& player_motion = registry().motions.get(player);
+	auto& enemy_motion = registry().motions.get(entity);
+	auto& enemy = registry().enemies.get(entity);
 
 	// normalize angle for current to [0, 360)
 	float currentAngle = fmod(enemy_motion.angle, 360.f);
@@ -246,12 +261,12 @@ void AISystem::update_enemy_rotation(Entity entity, float elapsed_ms) {
 
 // lerp function
 void AISystem::move_toward_player_lerp(Entity entity, float elapsed_ms) {
-	Entity player = registry.players.entities[0];
-	auto& player_motion = registry.motions.get(player);
-	auto& enemy_motion = registry.motions.get(entity);
+	Entity player = registry().players.entities[0];
+	auto& player_motion = registry().motions.get(player);
+	auto& enemy_motion = registry().motions.get(entity);
 	vec2 direction = normalize(player_motion.position - enemy_motion.position);
 
-	vec2 target_velocity = direction * registry.enemies.get(entity).speed;
+	vec2 target_velocity = direction * registry().enemies.get(entity).speed;
 	float smooth_constant = 10.f;
 	float time_adjusted_constant = 1.0f - expf(-smooth_constant * (elapsed_ms / 1000.f));
 	enemy_motion.velocity = lerp(enemy_motion.velocity, target_velocity, time_adjusted_constant);
@@ -259,29 +274,29 @@ void AISystem::move_toward_player_lerp(Entity entity, float elapsed_ms) {
 
 // regular function no lerp
 void AISystem::move_toward_player(Entity entity) {
-	Entity player = registry.players.entities[0];
-	auto& player_motion = registry.motions.get(player);
-	auto& enemy_motion = registry.motions.get(entity);
+	Entity player = registry().players.entities[0];
+	auto& player_motion = registry().motions.get(player);
+	auto& enemy_motion = registry().motions.get(entity);
 	vec2 direction = normalize(player_motion.position - enemy_motion.position);
 
-	enemy_motion.velocity = direction * registry.enemies.get(entity).speed;
+	enemy_motion.velocity = direction * registry().enemies.get(entity).speed;
 }
 
 // shoots projectile from enemy
 void AISystem::handle_enemy_shooting(Entity entity) {
-	auto& enemy_motion = registry.motions.get(entity);
-	auto& gun = registry.guns.get(entity);
+	auto& enemy_motion = registry().motions.get(entity);
+	auto& gun = registry().guns.get(entity);
 
 	if (gun.cooldown_timer_ms > 0.) {
 		return;
 	}
 
-	if (registry.players.entities.empty()) {
+	if (registry().players.entities.empty()) {
 		return; // No player to target
 	}
 
-	Entity player = registry.players.entities[0];
-	auto& player_motion = registry.motions.get(player);
+	Entity player = registry().players.entities[0];
+	auto& player_motion = registry().motions.get(player);
 
 	// aim threshold calculation to only fire if facing player
 	float desiredAngle = glm::degrees(atan2(player_motion.position.y - enemy_motion.position.y,
@@ -306,6 +321,10 @@ void AISystem::handle_enemy_shooting(Entity entity) {
 	float angle_offset = ((rand() % 26) - 12.5);  // Random int between -12.5 and +12.5
 	float inaccurate_angle = atan2(direction_to_player.y, direction_to_player.x) + glm::radians(angle_offset);
 
+	// new projectiles join the moving SAT group, which moves Motions around, so enemy_motion must not be used in the loop
+	vec2 enemy_velocity = enemy_motion.velocity;
+	float enemy_angle = enemy_motion.angle;
+
 	for (int i = 0; i < gun.projectile_count; i++) {
 		float spread_angle = 0.f;
 		
@@ -330,30 +349,29 @@ void AISystem::handle_enemy_shooting(Entity entity) {
 	}
     add_temp_light(gun_position, {1.0, 0.6, 0.2}, 200, 1.f, true, 100.f);
 	gun.cooldown_timer_ms = gun.cooldown_ms;
-	create_animation(gun_position, enemy_motion.velocity, { 20.0f, 20.0f }, enemy_motion.angle, std::vector<TEXTURE_ASSET_ID>{TEXTURE_ASSET_ID::MUZZLE_FLASH0, TEXTURE_ASSET_ID::MUZZLE_FLASH1, TEXTURE_ASSET_ID::MUZZLE_FLASH2},
+	create_animation(gun_position, enemy_velocity, { 20.0f, 20.0f }, enemy_angle, MUZZLE_FLASH_CLIP,
 		true, false, 50.0f, Z_INDEX::MUZZLE_FLASH);
 	audio->play_sound(gun.sound_effect, 10);
 
 	// alert all enemies in the same room as the player
-	for (Entity& other_enemy : registry.enemies.entities) {
+	for (auto [other_enemy, other_enemy_comp] : registry().view<Enemy>()) {
 		if (other_enemy == entity) {
 			continue;
 		}
 		if (is_in_same_room(other_enemy, entity)) {
-			if (registry.enemies.get(other_enemy).state == ENEMY_STATE::IDLE) {
-				registry.enemies.get(other_enemy).state = ENEMY_STATE::PURSUIT;
+			if (other_enemy_comp.state == ENEMY_STATE::IDLE) {
+				other_enemy_comp.state = ENEMY_STATE::PURSUIT;
 			}
 			// invalidate the cached path so a new path is computed
-			if (registry.pathComponents.has(other_enemy)) {
-				auto& pathComp = registry.pathComponents.get(other_enemy);
-				pathComp.valid = false;
+			if (PathComponent* pathComp = registry().pathComponents.find(other_enemy)) {
+				pathComp->valid = false;
 			}
 		}
 	}
 }
 
 vec2 AISystem::get_enemy_gun_position(Entity entity) {
-	auto& enemy_motion = registry.motions.get(entity);
+	auto& enemy_motion = registry().motions.get(entity);
 	vec2 gun_offset = vec2(enemy_motion.scale.x / 2, 0);
 	float rad = glm::radians(enemy_motion.angle);
 	vec2 rotated_offset = {
@@ -367,28 +385,28 @@ vec2 AISystem::get_enemy_gun_position(Entity entity) {
 // and then update the timer, like in AnimationSystem::progress_timers()
 // this will be faster
 void AISystem::progress_timers(float elapsed_ms, Entity entity) {
-	auto& gun = registry.guns.get(entity);
+	auto& gun = registry().guns.get(entity);
 	if (gun.cooldown_timer_ms > 0) {
 		gun.cooldown_timer_ms = gun.cooldown_timer_ms - elapsed_ms;
 	}
 }
 
 void AISystem::move_away_from_player(Entity enemy) {
-	Entity player = registry.players.entities[0];
-	auto& player_motion = registry.motions.get(player);
-	auto& enemy_motion = registry.motions.get(enemy);
+	Entity player = registry().players.entities[0];
+	auto& player_motion = registry().motions.get(player);
+	auto& enemy_motion = registry().motions.get(enemy);
 	vec2 direction = normalize(player_motion.position - enemy_motion.position);
 	// todo: insert stuff here to check collisions
 
-	enemy_motion.velocity = -direction * registry.enemies.get(enemy).speed;
+	enemy_motion.velocity = -direction * registry().enemies.get(enemy).speed;
 }
 
 bool AISystem::is_in_same_room(Entity a, Entity b) {
 	// Make sure both entities have Motion components. 
-	auto& aMotion = registry.motions.get(a);
-	auto& bMotion = registry.motions.get(b);
-	int current_level = registry.gameProgress.components[0].level;
-	Map& map = registry.maps.components[current_level];
+	auto& aMotion = registry().motions.get(a);
+	auto& bMotion = registry().motions.get(b);
+	int current_level = registry().gameProgress.components[0].level;
+	Map& map = registry().maps.components[current_level];
 	ivec2 aGrid = world_to_grid_coords(aMotion.position.x, aMotion.position.y);
 	ivec2 bGrid = world_to_grid_coords(bMotion.position.x, bMotion.position.y);
 	return (map.room_mask[aGrid.y][aGrid.x] == map.room_mask[bGrid.y][bGrid.x]);
@@ -3,14 +3,17 @@
 #include "common.hpp"
 #include "render_system.hpp"
 #include "tinyECS/registry.hpp"
+#include "world.hpp"
 #include "audio_system.hpp"
 
 #include <memory>
 #include "decision_tree_ai.hpp"
 
-class AISystem
+class AISystem : public GameSystem
 {
 public:
+	using GameSystem::GameSystem;
+
 	void step(float elapsed_ms);
 
 	void init(RenderSystem* renderer, AudioSystem* audio);
@@ -59,5 +62,8 @@ private:
 
 	std::unique_ptr<decision_node> decisionTree;
 
+	// per enemy in the order of registry().enemies, the action the decision tree picked this frame
+	std::vector<ENEMY_ACTION> decisions;
+
 };
 
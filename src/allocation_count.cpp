@@ -0,0 +1,26 @@
+#include "common.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Count every heap allocation so the main loop can report allocations per frame
+static std::atomic<uint64_t> heap_allocations{ 0 };
+
+uint64_t allocation_count() {
+	return heap_allocations.load(std::memory_order_relaxed);
+}
+
+void* operator new(std::size_t size) {
+	heap_allocations.fetch_add(1, std::memory_order_relaxed);
+	if (void* p = std::malloc(size ? size : 1))
+		return p;
+	throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+	std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+	std::free(p);
+}
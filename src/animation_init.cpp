@@ -1,25 +1,65 @@
 #include "animation_init.hpp"
 #include "tinyECS/registry.hpp"
 #include <iostream>
+#include <array>
+
+static const AnimationClip blood_splatter = { {
+	TEXTURE_ASSET_ID::BLOOD_SPLATTER_0, TEXTURE_ASSET_ID::BLOOD_SPLATTER_1, TEXTURE_ASSET_ID::BLOOD_SPLATTER_2, TEXTURE_ASSET_ID::BLOOD_SPLATTER_3,
+	TEXTURE_ASSET_ID::BLOOD_SPLATTER_4, TEXTURE_ASSET_ID::BLOOD_SPLATTER_5, TEXTURE_ASSET_ID::BLOOD_SPLATTER_6, TEXTURE_ASSET_ID::BLOOD_SPLATTER_7
+} };
+static const AnimationClip muzzle_flash = { { TEXTURE_ASSET_ID::MUZZLE_FLASH0, TEXTURE_ASSET_ID::MUZZLE_FLASH1, TEXTURE_ASSET_ID::MUZZLE_FLASH2 } };
+static const AnimationClip slash = { { TEXTURE_ASSET_ID::SLASH_0, TEXTURE_ASSET_ID::SLASH_1, TEXTURE_ASSET_ID::SLASH_2, TEXTURE_ASSET_ID::SLASH_3 } };
+static const AnimationClip damage_indicator = { {
+	TEXTURE_ASSET_ID::DAMAGE_INDICATOR_0, TEXTURE_ASSET_ID::DAMAGE_INDICATOR_1, TEXTURE_ASSET_ID::DAMAGE_INDICATOR_2, TEXTURE_ASSET_ID::DAMAGE_INDICATOR_3
+} };
+static const AnimationClip wall_particle = { {
+	TEXTURE_ASSET_ID::WALL_PARTICLE_1, TEXTURE_ASSET_ID::WALL_PARTICLE_2, TEXTURE_ASSET_ID::WALL_PARTICLE_3, TEXTURE_ASSET_ID::WALL_PARTICLE_4,
+	TEXTURE_ASSET_ID::WALL_PARTICLE_5
+} };
+static const AnimationClip cinematic_cutscene = { {
+	TEXTURE_ASSET_ID::CINEMAITC_CUTSCENE_0, TEXTURE_ASSET_ID::CINEMAITC_CUTSCENE_1, TEXTURE_ASSET_ID::CINEMAITC_CUTSCENE_2,
+	TEXTURE_ASSET_ID::CINEMAITC_CUTSCENE_3, TEXTURE_ASSET_ID::CINEMAITC_CUTSCENE_4, TEXTURE_ASSET_ID::CINEMAITC_CUTSCENE_5,
+	TEXTURE_ASSET_ID::CINEMAITC_CUTSCENE_6, TEXTURE_ASSET_ID::CINEMAITC_CUTSCENE_7, TEXTURE_ASSET_ID::CINEMAITC_CUTSCENE_8
+} };
+
+const AnimationClip* const BLOOD_SPLATTER_CLIP = &blood_splatter;
+const AnimationClip* const MUZZLE_FLASH_CLIP = &muzzle_flash;
+const AnimationClip* const SLASH_CLIP = &slash;
+const AnimationClip* const DAMAGE_INDICATOR_CLIP = &damage_indicator;
+const AnimationClip* const WALL_PARTICLE_CLIP = &wall_particle;
+const AnimationClip* const CINEMATIC_CUTSCENE_CLIP = &cinematic_cutscene;
+
+// one clip per texture, so that a still clip is an index instead of a lookup
+static const std::array<AnimationClip, texture_count> still_clips = [] {
+	std::array<AnimationClip, texture_count> clips;
+	for (int i = 0; i < texture_count; i++) {
+		clips[i].frames = { (TEXTURE_ASSET_ID)i };
+	}
+	return clips;
+}();
+
+const AnimationClip* still_clip(TEXTURE_ASSET_ID texture) {
+	return &still_clips[(int)texture];
+}
 
 // create an animation and specify if the animation is playing, looping, and the duration between animations
-Entity create_animation(vec2 pos, vec2 vel, vec2 scale, float angle, std::vector<TEXTURE_ASSET_ID> textures, bool playing, bool looping, float change_ms, Z_INDEX z_index, bool is_ui_element, bool no_lighting) {
-	Entity entity = Entity();
-	Animation& animation = registry.animations.emplace(entity);
-	animation.textures = textures;
+Entity create_animation(vec2 pos, vec2 vel, vec2 scale, float angle, const AnimationClip* clip, bool playing, bool looping, float change_ms, Z_INDEX z_index, bool is_ui_element, bool no_lighting) {
+	Entity entity = registry().create();
+	Animation& animation = registry().animations.emplace(entity);
+	animation.clip = clip;
 	animation.playing = playing;
 	animation.looping = looping;
 	animation.counter_ms = change_ms;
 	animation.change_time_ms = change_ms;
 
-	Motion& motion = registry.motions.emplace(entity);
+	Motion& motion = registry().motions.emplace(entity);
 	motion.position = pos;
 	motion.velocity = vel;
 	motion.angle = angle;
 	motion.scale = scale;
 
-	registry.renderRequests.emplace(entity, RenderRequest{
-		animation.textures[animation.state],
+	registry().renderRequests.emplace(entity, RenderRequest{
+		clip->frames[animation.state],
 		EFFECT_ASSET_ID::TEXTURED,
 		GEOMETRY_BUFFER_ID::SPRITE,
 		z_index,
@@ -27,20 +67,20 @@ Entity create_animation(vec2 pos, vec2 vel, vec2 scale, float angle, std::vector
 	});
 
 	if (is_ui_element) {
-		registry.uis.emplace(entity);
+		registry().uis.emplace(entity);
 	} else if (no_lighting) {
-		registry.textureWithoutLighting.emplace(entity);
+		registry().textureWithoutLighting.emplace(entity);
 	}
 
 	return entity;
 }
 
 void toggle_animation(Entity& entity, bool is_playing) {
-	Animation& animation = registry.animations.get(entity);
+	Animation& animation = registry().animations.get(entity);
 	animation.playing = is_playing;
 }
 
 void toggle_looping(Entity& entity, bool is_looping) {
-	Animation& animation = registry.animations.get(entity);
+	Animation& animation = registry().animations.get(entity);
 	animation.looping = is_looping;
 }
\ No newline at end of file
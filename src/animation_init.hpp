@@ -3,7 +3,18 @@
 #include "common.hpp"
 #include "tinyECS/components.hpp"
 
-Entity create_animation(vec2 pos, vec2 vel, vec2 scale, float angle, std::vector<TEXTURE_ASSET_ID> textures, bool playing, bool looping, float change_ms, Z_INDEX z_index, bool is_ui_element = false, bool no_lighting = false);
+// The clips of the effects, built once before main and shared by all animations and worlds
+extern const AnimationClip* const BLOOD_SPLATTER_CLIP;
+extern const AnimationClip* const MUZZLE_FLASH_CLIP;
+extern const AnimationClip* const SLASH_CLIP;
+extern const AnimationClip* const DAMAGE_INDICATOR_CLIP;
+extern const AnimationClip* const WALL_PARTICLE_CLIP;
+extern const AnimationClip* const CINEMATIC_CUTSCENE_CLIP;
+
+// The clip that shows a single texture, e.g. a title card
+const AnimationClip* still_clip(TEXTURE_ASSET_ID texture);
+
+Entity create_animation(vec2 pos, vec2 vel, vec2 scale, float angle, const AnimationClip* clip, bool playing, bool looping, float change_ms, Z_INDEX z_index, bool is_ui_element = false, bool no_lighting = false);
 
 void toggle_animation(Entity& entity, bool is_playing);
 
@@ -11,14 +11,13 @@ void AnimationSystem::init() {
 
 // update texture in renderRequest
 void AnimationSystem::update_render(Entity& entity, Animation& animation) {
-	RenderRequest& rr = registry.renderRequests.get(entity);
-	rr.used_texture = animation.textures[animation.state];
+	RenderRequest& rr = registry().renderRequests.get(entity);
+	rr.used_texture = animation.clip->frames[animation.state];
 }
 
 // progress the timers all animations
 void AnimationSystem::progress_timers(float elapsed_ms) {
-	for (auto& entity : registry.animations.entities) {
-		Animation& animation = registry.animations.get(entity);
+	for (Animation& animation : registry().animations.components) {
 		if (animation.playing) {
 			animation.counter_ms -= elapsed_ms;
 		}
@@ -27,15 +26,18 @@ void AnimationSystem::progress_timers(float elapsed_ms) {
 
 // updates animation states
 void AnimationSystem::update_animation() {
-	for (auto& entity : registry.animations.entities) {
-		Animation& animation = registry.animations.get(entity);
+	auto& animations = registry().animations;
+	for (uint i = 0; i < animations.size(); i++) {
+		Entity entity = animations.entities[i];
+		Animation& animation = animations.components[i];
 		if (animation.counter_ms <= 0.0f) {
 			animation.state += 1;
-			int current_state = animation.state % animation.textures.size();
+			int current_state = animation.state % animation.clip->frames.size();
 			// remove animation if looping is false. Else the state goes back to 0
 			if (current_state == 0) {
 				if (!animation.looping) {
-					registry.remove_all_components_of(entity);
+					// deferred so the loop does not skip the animation swapped into slot i
+					registry().commands.destroy(entity);
 					continue;
 				}
 				else {
@@ -3,9 +3,12 @@
 #include "tinyECS/entity.hpp"
 #include "tinyECS/components.hpp"
 #include <render_system.hpp>
+#include "world.hpp"
 
-class AnimationSystem {
+class AnimationSystem : public GameSystem {
 public:
+    using GameSystem::GameSystem;
+
     void init();
 
     void update_animation();
@@ -73,3 +73,6 @@ void print_2d_vector(std::vector<std::vector<int>>& vec);
 vec2 lerp(vec2 start, vec2 end, float time);
 
 int get_rand(int range_start, int range_end);
+
+// Number of heap allocations made through operator new since startup
+uint64_t allocation_count();
@@ -6,7 +6,7 @@
 #include "tinyECS/registry.hpp"
 #include "a_star_pathfinding.hpp"
 #include <glm/trigonometric.hpp>
-// (Ensure this header gives access to registry.enemies, registry.players, etc.)
+// (Ensure this header gives access to registry().enemies, registry().players, etc.)
 
 // holds a condition and branches to a child node based on whether condition returns true or false
 condition_node::condition_node(std::function<bool(Entity)> cond,
@@ -36,12 +36,12 @@ ENEMY_ACTION action_node::evaluate(Entity enemy) {
 
 // Helper function
 float get_distance_to_player(Entity enemy) {
-    if (registry.players.entities.empty()) {
+    if (registry().players.entities.empty()) {
         return 1e6f; // return a very large value
     } 
-    Entity player = registry.players.entities[0];
-    auto& enemy_motion = registry.motions.get(enemy);
-    auto& player_motion = registry.motions.get(player);
+    Entity player = registry().players.entities[0];
+    auto& enemy_motion = registry().motions.get(enemy);
+    auto& player_motion = registry().motions.get(player);
     return length(player_motion.position - enemy_motion.position);
 }
 
@@ -52,14 +52,14 @@ bool is_within_range(Entity enemy, float range) {
 
 // helper function
 bool is_enemy_in_same_room_as_player(Entity enemy) {
-    if (registry.players.entities.empty() || registry.maps.components.empty())
+    if (registry().players.entities.empty() || registry().maps.components.empty())
         return false;
 
-    Entity player = registry.players.entities[0];
-    auto& enemyMotion = registry.motions.get(enemy);
-    auto& playerMotion = registry.motions.get(player);
-    int current_level = registry.gameProgress.components[0].level;
-    Map& map = registry.maps.components[current_level];
+    Entity player = registry().players.entities[0];
+    auto& enemyMotion = registry().motions.get(enemy);
+    auto& playerMotion = registry().motions.get(player);
+    int current_level = registry().gameProgress.components[0].level;
+    Map& map = registry().maps.components[current_level];
 
     ivec2 player_grid_pos = world_to_grid_coords(playerMotion.position.x, playerMotion.position.y);
     ivec2 enemy_grid_pos = world_to_grid_coords(enemyMotion.position.x, enemyMotion.position.y);
@@ -70,25 +70,25 @@ bool is_enemy_in_same_room_as_player(Entity enemy) {
 
 // Check for line-of-sight using a_star_pathfinding function.
 bool enemy_has_los_to_player(Entity enemy) {
-    if (registry.players.entities.empty() || registry.maps.components.empty())
+    if (registry().players.entities.empty() || registry().maps.components.empty())
         return false;
-    Entity player = registry.players.entities[0];
-    auto& enemy_motion = registry.motions.get(enemy);
-    auto& player_motion = registry.motions.get(player);
+    Entity player = registry().players.entities[0];
+    auto& enemy_motion = registry().motions.get(enemy);
+    auto& player_motion = registry().motions.get(player);
     // Call the global has_line_of_sight from a_star_pathfinding.cpp.
-    int current_level = registry.gameProgress.components[0].level;
-    Map& map = registry.maps.components[current_level];
+    int current_level = registry().gameProgress.components[0].level;
+    Map& map = registry().maps.components[current_level];
     return has_line_of_sight(enemy_motion.position, player_motion.position, map);
 };
 
 // returns true if enemy facing player
 bool is_facing_player(Entity enemy) {
-    if (registry.players.entities.empty())
+    if (registry().players.entities.empty())
         return false;
 
-    Entity player = registry.players.entities[0];
-    auto& enemy_motion = registry.motions.get(enemy);
-    auto& player_motion = registry.motions.get(player);
+    Entity player = registry().players.entities[0];
+    auto& enemy_motion = registry().motions.get(enemy);
+    auto& player_motion = registry().motions.get(player);
 
     // vector from the enemy to the player
     vec2 to_player = player_motion.position - enemy_motion.position;
@@ -116,16 +116,16 @@ bool is_facing_player(Entity enemy) {
 
 // returns true if the the enemy has reached its destination ie. last known player location
 bool has_path_reached(Entity enemy) {
-    if (!registry.pathComponents.has(enemy))
+    if (!registry().pathComponents.has(enemy))
         return false;
-    auto& pc = registry.pathComponents.get(enemy);
+    auto& pc = registry().pathComponents.get(enemy);
     bool ret_val = pc.current_index >= pc.waypoints.size();
     //std::cout << "has path reached: " << ret_val << std::endl;
     return ret_val;
 }
 
 bool has_path_validated(Entity enemy) {
-    return registry.pathComponents.get(enemy).valid == true;
+    return registry().pathComponents.get(enemy).valid == true;
 }
 
 std::unique_ptr<decision_node> build_decision_tree() {
@@ -151,17 +151,17 @@ std::unique_ptr<decision_node> build_decision_tree() {
         },
         std::make_unique<condition_node>(
             [](Entity enemy) -> bool {
-                return is_within_range(enemy, registry.enemies.get(enemy).backoff_range);
+                return is_within_range(enemy, registry().enemies.get(enemy).backoff_range);
             },
             std::make_unique<action_node>(ENEMY_ACTION::ACTION_BACKOFF),
             std::make_unique<condition_node>(
                 [](Entity enemy) -> bool {
-                    return is_within_range(enemy, registry.enemies.get(enemy).attack_range);
+                    return is_within_range(enemy, registry().enemies.get(enemy).attack_range);
                 },
                 std::make_unique<action_node>(ENEMY_ACTION::ACTION_COMBAT),
                 std::make_unique<condition_node>(
                     [](Entity enemy) -> bool {
-                        return is_within_range(enemy, registry.enemies.get(enemy).pursuit_range);
+                        return is_within_range(enemy, registry().enemies.get(enemy).pursuit_range);
                     },
                     std::make_unique<action_node>(ENEMY_ACTION::ACTION_PURSUIT),
                     std::make_unique<action_node>(ENEMY_ACTION::ACTION_IDLE)
@@ -218,17 +218,17 @@ std::unique_ptr<decision_node> build_decision_tree() {
             },
             std::make_unique<condition_node>(
                 [](Entity enemy) -> bool {
-                    return is_within_range(enemy, registry.enemies.get(enemy).backoff_range);
+                    return is_within_range(enemy, registry().enemies.get(enemy).backoff_range);
                 },
                 std::make_unique<action_node>(ENEMY_ACTION::ACTION_BACKOFF),
                 std::make_unique<condition_node>(
                     [](Entity enemy) -> bool {
-                        return is_within_range(enemy, registry.enemies.get(enemy).attack_range);
+                        return is_within_range(enemy, registry().enemies.get(enemy).attack_range);
                     },
                     std::make_unique<action_node>(ENEMY_ACTION::ACTION_COMBAT),
                     std::make_unique<condition_node>(
                         [](Entity enemy) -> bool {
-                            return is_within_range(enemy, registry.enemies.get(enemy).pursuit_range);
+                            return is_within_range(enemy, registry().enemies.get(enemy).pursuit_range);
                         },
                         std::make_unique<action_node>(ENEMY_ACTION::ACTION_PURSUIT),
                         std::make_unique<action_node>(ENEMY_ACTION::ACTION_IDLE)
@@ -257,12 +257,12 @@ std::unique_ptr<decision_node> build_decision_tree() {
         },
         std::make_unique<condition_node>(
             [](Entity enemy) -> bool {
-                return is_within_range(enemy, registry.enemies.get(enemy).backoff_range);
+                return is_within_range(enemy, registry().enemies.get(enemy).backoff_range);
             },
             std::make_unique<action_node>(ENEMY_ACTION::ACTION_BACKOFF),
             std::make_unique<condition_node>(
                 [](Entity enemy) -> bool {
-                    return is_within_range(enemy, registry.enemies.get(enemy).attack_range);
+                    return is_within_range(enemy, registry().enemies.get(enemy).attack_range);
                 },
                 std::make_unique<action_node>(ENEMY_ACTION::ACTION_COMBAT),
                 std::make_unique<action_node>(ENEMY_ACTION::ACTION_PURSUIT)
@@ -282,13 +282,13 @@ std::unique_ptr<decision_node> build_decision_tree() {
         */
 
         [](Entity enemy) -> bool {
-            return is_within_range(enemy, registry.enemies.get(enemy).backoff_range);
+            return is_within_range(enemy, registry().enemies.get(enemy).backoff_range);
         },
         std::make_unique<action_node>(ENEMY_ACTION::ACTION_BACKOFF),
         std::make_unique<condition_node>(
             [](Entity enemy) -> bool {
                 return (is_facing_player(enemy) && 
-                    is_within_range(enemy, registry.enemies.get(enemy).backoff_range) && 
+                    is_within_range(enemy, registry().enemies.get(enemy).backoff_range) && 
                     enemy_has_los_to_player(enemy));
             },
             std::make_unique<action_node>(ENEMY_ACTION::ACTION_COMBAT),
@@ -299,17 +299,17 @@ std::unique_ptr<decision_node> build_decision_tree() {
     // root tree. does these checks and from them branches to each sub tree
     auto root = std::make_unique<condition_node>(
         [](Entity enemy) -> bool {
-            return (registry.enemies.get(enemy).state == ENEMY_STATE::IDLE); // check if enemy state is IDLE
+            return (registry().enemies.get(enemy).state == ENEMY_STATE::IDLE); // check if enemy state is IDLE
         },
         std::move(idle_branch), // if true then move to idle branch
         std::make_unique<condition_node>( // if false then
             [](Entity enemy) -> bool {
-                return (registry.enemies.get(enemy).state == ENEMY_STATE::PURSUIT); // check if enemy state is pursuit
+                return (registry().enemies.get(enemy).state == ENEMY_STATE::PURSUIT); // check if enemy state is pursuit
             },
             std::move(pursuit_branch), // if true then move to pursuit branch
             std::make_unique<condition_node>( // if false then
                 [](Entity enemy) -> bool {
-                    return (registry.enemies.get(enemy).state == ENEMY_STATE::COMBAT); // check if enemy state is COMBAT
+                    return (registry().enemies.get(enemy).state == ENEMY_STATE::COMBAT); // check if enemy state is COMBAT
                 },
                 std::move(combat_branch), // if true then move to combat branch
                 std::move(backoff_branch) // if false then must be in backoff, move to backoff branch
@@ -0,0 +1,67 @@
+#include "dynamic_grid.hpp"
+
+void DynamicGrid::clear(float cell_size)
+{
+	inverse_cell_size = 1.f / cell_size;
+	items.clear();
+	large_items.clear();
+	bucket_mask = 0;
+	bucket_start.assign(2, 0);
+	bucket_items.clear();
+}
+
+uint32_t DynamicGrid::add(vec2 min, vec2 max)
+{
+	items.push_back({ min, max });
+	return (uint32_t)items.size() - 1;
+}
+
+void DynamicGrid::build()
+{
+	// one entry per covered cell, at least two buckets per entry keeps the shared buckets rare
+	size_t entries = 0;
+	large_items.clear();
+	for (uint32_t i = 0; i < items.size(); i++) {
+		if (is_large(items[i])) {
+			large_items.push_back(i);
+			continue;
+		}
+		ivec2 lo = cell_of(items[i].min);
+		ivec2 hi = cell_of(items[i].max);
+		entries += (size_t)(hi.x - lo.x + 1) * (hi.y - lo.y + 1);
+	}
+	uint32_t bucket_count = 16;
+	while (bucket_count < entries * 2)
+		bucket_count *= 2;
+	bucket_mask = bucket_count - 1;
+
+	// counting sort: count the entries of every bucket, turn the counts into start offsets, then scatter
+	bucket_start.assign(bucket_count + 1, 0);
+	for (const Item& item : items) {
+		if (is_large(item))
+			continue;
+		ivec2 lo = cell_of(item.min);
+		ivec2 hi = cell_of(item.max);
+		for (int y = lo.y; y <= hi.y; y++)
+			for (int x = lo.x; x <= hi.x; x++)
+				bucket_start[bucket_of(x, y) + 1]++;
+	}
+	for (uint32_t b = 0; b < bucket_count; b++)
+		bucket_start[b + 1] += bucket_start[b];
+
+	bucket_items.resize(entries);
+	// found doubles as the write cursor of every bucket, it is cleared by the next query
+	found.assign(bucket_start.begin(), bucket_start.end() - 1);
+	for (uint32_t i = 0; i < items.size(); i++) {
+		if (is_large(items[i]))
+			continue;
+		ivec2 lo = cell_of(items[i].min);
+		ivec2 hi = cell_of(items[i].max);
+		for (int y = lo.y; y <= hi.y; y++)
+			for (int x = lo.x; x <= hi.x; x++)
+				bucket_items[found[bucket_of(x, y)]++] = i;
+	}
+
+	if (stamps.size() < items.size())
+		stamps.resize(items.size(), 0);
+}
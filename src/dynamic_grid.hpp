@@ -0,0 +1,112 @@
+#pragma once
+
+#include "common.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// Broadphase for bodies that move every frame, rebuilt from scratch instead of updated.
+// Every item is added with its bounding box, then build() bins the items into hashed cells with a counting sort,
+// so the items of a cell end up next to each other in one array. Nothing is allocated once the buffers have grown.
+// Cells that hash to the same bucket share it, which only adds candidates for the narrow phase to reject.
+class DynamicGrid
+{
+public:
+	// Items covering more cells than this on either axis skip the cells and are returned by every query
+	static constexpr int MAX_ITEM_CELLS = 16;
+
+	// Forget all items, the grid is empty until the next build()
+	void clear(float cell_size);
+
+	// Returns the index of the item, indices count up from 0 in the order of the calls
+	uint32_t add(vec2 min, vec2 max);
+
+	void build();
+
+	size_t size() const { return items.size(); }
+
+	// Calls fn(item) once for every item whose box overlaps [min, max], in increasing order of the item indices.
+	// Only sees the items added before the last build()
+	template <typename Fn>
+	void query(vec2 min, vec2 max, Fn fn)
+	{
+		found.clear();
+		if (++stamp == 0) {
+			std::fill(stamps.begin(), stamps.end(), 0);
+			stamp = 1;
+		}
+		ivec2 lo = cell_of(min);
+		ivec2 hi = cell_of(max);
+		// a query covering more cells than there are buckets would visit every bucket anyway
+		if ((int64_t)(hi.x - lo.x + 1) * (hi.y - lo.y + 1) > (int64_t)bucket_mask + 1) {
+			for (uint32_t item = 0; item < items.size(); item++)
+				visit(item, min, max);
+		}
+		else {
+			for (int y = lo.y; y <= hi.y; y++) {
+				for (int x = lo.x; x <= hi.x; x++) {
+					uint32_t bucket = bucket_of(x, y);
+					for (uint32_t i = bucket_start[bucket]; i < bucket_start[bucket + 1]; i++)
+						visit(bucket_items[i], min, max);
+				}
+			}
+			for (uint32_t item : large_items)
+				visit(item, min, max);
+		}
+
+		std::sort(found.begin(), found.end());
+		for (uint32_t item : found)
+			fn(item);
+	}
+
+private:
+	struct Item
+	{
+		vec2 min;
+		vec2 max;
+	};
+
+	ivec2 cell_of(vec2 position) const
+	{
+		return { (int)std::floor(position.x * inverse_cell_size), (int)std::floor(position.y * inverse_cell_size) };
+	}
+
+	uint32_t bucket_of(int x, int y) const
+	{
+		return ((uint32_t)x * 73856093u ^ (uint32_t)y * 19349663u) & bucket_mask;
+	}
+
+	bool is_large(const Item& item) const
+	{
+		ivec2 lo = cell_of(item.min);
+		ivec2 hi = cell_of(item.max);
+		return hi.x - lo.x >= MAX_ITEM_CELLS || hi.y - lo.y >= MAX_ITEM_CELLS;
+	}
+
+	// Adds an item to found the first time a query sees it, if the boxes overlap
+	void visit(uint32_t item, vec2 min, vec2 max)
+	{
+		if (stamps[item] == stamp)
+			return;
+		stamps[item] = stamp;
+		const Item& bounds = items[item];
+		if (bounds.max.x < min.x || max.x < bounds.min.x || bounds.max.y < min.y || max.y < bounds.min.y)
+			return;
+		found.push_back(item);
+	}
+
+	float inverse_cell_size = 1.f;
+	std::vector<Item> items;
+	std::vector<uint32_t> large_items;
+
+	// bucket b holds bucket_items[bucket_start[b], bucket_start[b + 1])
+	uint32_t bucket_mask = 0;
+	std::vector<uint32_t> bucket_start = { 0, 0 };
+	std::vector<uint32_t> bucket_items;
+
+	// per item, the query that saw it last, so an item spanning several cells is reported once
+	std::vector<uint32_t> stamps;
+	uint32_t stamp = 0;
+	std::vector<uint32_t> found;
+};
@@ -2,8 +2,9 @@
 
 #include <iostream>
 
-InputSystem::InputSystem() :
-    inputs(registry.inputs.emplace(Entity()))
+InputSystem::InputSystem(World& world) :
+    GameSystem(world),
+    inputs(registry().inputs.emplace(registry().create()))
 {
 	inputs.keys.emplace(GLFW_KEY_ESCAPE, false);
 	inputs.keys.emplace(GLFW_KEY_W, false);
@@ -18,12 +19,18 @@ InputSystem::InputSystem() :
 	inputs.keys.emplace(GLFW_KEY_F, false);
 	inputs.keys.emplace(GLFW_KEY_LEFT_SHIFT, false);
 	inputs.keys.emplace(GLFW_KEY_ENTER, false);
+	inputs.keys.emplace(GLFW_KEY_F9, false);
+	inputs.keys.emplace(GLFW_KEY_F10, false);
+	inputs.keys.emplace(GLFW_KEY_F11, false);
 
 	inputs.key_down_events.emplace(GLFW_MOUSE_BUTTON_LEFT, false);
 	inputs.key_down_events.emplace(GLFW_MOUSE_BUTTON_RIGHT, false);
 	inputs.key_down_events.emplace(GLFW_KEY_SPACE, false);
 	inputs.key_down_events.emplace(GLFW_KEY_ENTER, false);
 	inputs.key_down_events.emplace(GLFW_KEY_R, false);
+	inputs.key_down_events.emplace(GLFW_KEY_F9, false);
+	inputs.key_down_events.emplace(GLFW_KEY_F10, false);
+	inputs.key_down_events.emplace(GLFW_KEY_F11, false);
 }
 
 void InputSystem::step() {
@@ -33,7 +40,7 @@ void InputSystem::step() {
 }
 
 InputSystem::~InputSystem() {
-    registry.inputs.clear();
+    registry().inputs.clear();
 }
 
 void InputSystem::init(GLFWwindow* window) {
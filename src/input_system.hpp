@@ -4,11 +4,12 @@
 #include "tinyECS/tiny_ecs.hpp"
 #include "tinyECS/components.hpp"
 #include "tinyECS/registry.hpp"
+#include "world.hpp"
 
-class InputSystem
+class InputSystem : public GameSystem
 {
 public:
-    InputSystem();
+    InputSystem(World& world);
     ~InputSystem();
 
     void step();
@@ -21,6 +21,9 @@
 #include "animation_system.hpp"
 #include "ui_system.hpp"
 #include "ai_system.hpp"
+#include "transform_system.hpp"
+#include "scheduler.hpp"
+#include "world.hpp"
 #include <thread>
 
 using Clock = std::chrono::high_resolution_clock;
@@ -28,21 +31,26 @@ using Clock = std::chrono::high_resolution_clock;
 // Entry point
 int main()
 {
-	// global systems
-	AISystem	    ai_system;
-	WorldSystem     world_system;
-	RenderSystem    renderer_system;
+	// the game's entities and threads, everything below works on it
+	World world;
+	world.make_current();
+
+	// systems of the world
+	AISystem	    ai_system(world);
+	WorldSystem     world_system(world);
+	RenderSystem    renderer_system(world);
 	AudioSystem     audio_system;
-	PhysicsSystem   physics_system;
-	InputSystem     input_system;
-	PlayerSystem    player_system;
-	MapSystem map_system;
-	AnimationSystem animation_system;
-	UISystem ui_system;
-
-	registry.map_system = &map_system;
-	registry.audio_system = &audio_system;
-	registry.ui_system = &ui_system;
+	PhysicsSystem   physics_system(world);
+	InputSystem     input_system(world);
+	PlayerSystem    player_system(world);
+	MapSystem map_system(world);
+	AnimationSystem animation_system(world);
+	UISystem ui_system(world);
+	TransformSystem transform_system(world);
+
+	world.map_system = &map_system;
+	world.audio_system = &audio_system;
+	world.ui_system = &ui_system;
 
 	// initialize window
 	GLFWwindow* window = world_system.create_window();
@@ -58,20 +66,21 @@ int main()
 	audio_system.init();
 	input_system.init(window);
 	world_system.init(&renderer_system, &audio_system);
+	physics_system.init();
 	map_system.init(&renderer_system);
 	ai_system.init(&renderer_system, &audio_system);
 	player_system.init(&renderer_system, &audio_system, &world_system, window);
 	animation_system.init();
 	ui_system.init(window, &world_system, &renderer_system, &audio_system);
 	
-	Entity fps_entity = Entity();
-	UI& fps_ui = registry.uis.emplace(fps_entity);
+	Entity fps_entity = registry().create();
+	UI& fps_ui = registry().uis.emplace(fps_entity);
 
-	Motion& fps_motion = registry.motions.emplace(fps_entity);
+	Motion& fps_motion = registry().motions.emplace(fps_entity);
 	fps_motion.position = { 1800, 30 };
 	fps_motion.scale = glm::vec2(.5f, .5f);
 
-	Text& fps_counter = registry.texts.emplace(fps_entity);
+	Text& fps_counter = registry().texts.emplace(fps_entity);
 	fps_counter.color = { 1.f, 1.f, 1.f };
 	fps_counter.content = "";
 
@@ -84,11 +93,64 @@ int main()
 	float target_fps = (debugging.limit_fps > 0) ? debugging.limit_fps : video_mode->refreshRate;
 	float render_interval = 1.f / target_fps;
 
+	// The systems of a frame in their single thread order (CK: be mindful of the order of your systems and rearrange this list only if necessary).
+	// Each system declares what it reads and writes, the scheduler runs systems that do not conflict at the same time.
+	// registry().flush_commands() is a sync point, structural changes deferred by the systems before it are applied there
+	SystemSchedule title_schedule;
+	title_schedule.add("player", SystemAccess::exclusive(), [&](float ms) { player_system.step(ms); });
+	title_schedule.add("animation", SystemAccess().write<Animation, RenderRequest>().use(SYSTEM_RESOURCE::ENTITIES), [&](float ms) { animation_system.step(ms); });
+	title_schedule.add("flush", SystemAccess::exclusive(), [](float) { registry().flush_commands(); });
+	title_schedule.add("ui", SystemAccess::exclusive(), [&](float ms) { ui_system.step(ms); });
+
+	SystemSchedule playing_schedule;
+	playing_schedule.add("world", SystemAccess::exclusive(), [&](float ms) { world_system.step(ms); });
+	playing_schedule.add("flush", SystemAccess::exclusive(), [](float) { registry().flush_commands(); });
+	// shooting spawns projectiles, lights and muzzle flashes
+	playing_schedule.add("ai",
+		SystemAccess()
+			.read<Player, Map, GameProgress>()
+			.write<Enemy, Motion, Gun, PathComponent>()
+			.write<Projectile, AABB, Collidable, MovingCollidable, MovingSAT, Pickup, RenderRequest, Light, RemoveTimer, Animation, TextureWithoutLighting>()
+			.use(SYSTEM_RESOURCE::ENTITIES).use(SYSTEM_RESOURCE::AUDIO),
+		[&](float ms) { ai_system.step(ms); });
+	// only the health and stamina bars, they read nothing the AI writes and run next to it
+	playing_schedule.add("hud", SystemAccess().read<Player, Dash>().write<UI>(), [&](float) { ui_system.update_bars(); });
+	playing_schedule.add("physics",
+		SystemAccess()
+			.read<Projectile, Player, Map, GameProgress, Mesh*>()
+			.read<AABB, Collidable, CircleBound, StaticCollidable, MovingCollidable, MovingCircle, MovingSAT, meshCollidable>()
+			.write<Motion, Collision, RenderRequest, SpatialHash>()
+			.write<Gun, Pickup, TextureWithoutLighting>() // thrown guns that come to rest become pickups
+			.use(SYSTEM_RESOURCE::ENTITIES),
+		[&](float ms) { physics_system.step(ms); });
+	playing_schedule.add("transforms", SystemAccess().write<Parent, Motion>(), [&](float ms) { transform_system.step(ms); });
+	// only counts the animations down, so it runs next to physics
+	playing_schedule.add("animation timers", SystemAccess().write<Animation>(), [&](float ms) { animation_system.progress_timers(ms); });
+	playing_schedule.add("flush", SystemAccess::exclusive(), [](float) { registry().flush_commands(); });
+	playing_schedule.add("player", SystemAccess::exclusive(), [&](float ms) { player_system.step(ms); });
+	playing_schedule.add("animation", SystemAccess().write<Animation, RenderRequest>().use(SYSTEM_RESOURCE::ENTITIES), [&](float) { animation_system.update_animation(); });
+	playing_schedule.add("flush", SystemAccess::exclusive(), [](float) { registry().flush_commands(); });
+	// skipping the cinematic destroys it, starts the music and the level title and changes the game state
+	playing_schedule.add("ui",
+		SystemAccess()
+			.read<Input, Player, Gun>()
+			.write<UI, Text, RenderRequest, Motion, Animation, TextureWithoutLighting>()
+			.use(SYSTEM_RESOURCE::ENTITIES).use(SYSTEM_RESOURCE::AUDIO).use(SYSTEM_RESOURCE::GAME_STATE),
+		[&](float ms) { ui_system.step(ms); });
+	playing_schedule.add("collisions", SystemAccess::exclusive(), [&](float ms) { world_system.handle_collisions(ms); });
+	playing_schedule.add("input", SystemAccess().write<Input>(), [&](float) { input_system.step(); });
+
+	// one thread is the main thread, which works on the schedule as well
+	unsigned int hardware_threads = std::thread::hardware_concurrency();
+	world.start_workers(hardware_threads > 1 ? std::min(hardware_threads - 1, MAX_THREADS - 1) : 0);
+
 	// variable timestep loop
 	auto t = Clock::now();
 	auto last_frame_time = t;
 	auto last_render_time = t;
 	int frame_count = 0;
+	uint64_t last_allocation_count = allocation_count();
+	float systems_ms = 0.f; // time spent in the scheduled systems since the last FPS print
 
 	while (!world_system.is_over()) {
 		// processes system messages, if this wasn't present the window would become unresponsive
@@ -117,6 +179,13 @@ int main()
 			std::string new_title = "Cyber-Yaga Vindicta " + fps_value + " FPS / " + ms + " ms";
 			glfwSetWindowTitle(window, new_title.c_str());
 			std::cout << "FPS: " << fps_value << " FPS / " << ms << " ms" << std::endl;
+			uint64_t allocations = allocation_count();
+			if (debugging.profiling) {
+				std::cout << "Allocations: " << std::fixed << std::setprecision(1) << (allocations - last_allocation_count) / (float)frame_count << " per frame" << std::endl;
+				std::cout << "Systems: " << std::setprecision(3) << systems_ms / frame_count << " ms per frame on " << world.scheduler.thread_count() << " threads" << std::endl;
+			}
+			last_allocation_count = allocations;
+			systems_ms = 0.f;
 
 			//int fps_calc = std::min((int)fps, 60);
 			fps_counter.content = "FPS: " + fps_value;
@@ -126,22 +195,16 @@ int main()
 		}
 
 
-		// CK: be mindful of the order of your systems and rearrange this list only if necessary
+		auto systems_start = Clock::now();
 		if (world_system.get_game_state() == GameState::TITLE_SCREEN) {
-			player_system.step(elapsed_ms);
-			animation_system.step(elapsed_ms);
-			ui_system.step(elapsed_ms);
+			world.scheduler.run(title_schedule, elapsed_ms);
 		}
 		else {
-			world_system.step(elapsed_ms);
-			ai_system.step(elapsed_ms);
-			physics_system.step(elapsed_ms);
-			player_system.step(elapsed_ms);
-			animation_system.step(elapsed_ms);
-			ui_system.step(elapsed_ms);
-			world_system.handle_collisions(elapsed_ms);
-			input_system.step();
+			world.scheduler.run(playing_schedule, elapsed_ms);
 		}
+		systems_ms += (float)(std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - systems_start)).count() / 1000;
+
+		registry().end_frame_stats();
 
 		if (std::chrono::duration<float>(t - last_render_time).count() >= render_interval) {
 			renderer_system.draw();
@@ -9,6 +9,14 @@
 #include <fstream>
 #include <iostream>
 #include <map>
+#include <atomic>
+
+// Unique ids for tiles and rooms, these are keys into the map and never entities. Shared by all worlds
+static std::atomic<int> map_object_id_count{ 1 };
+
+static int new_map_object_id() {
+    return map_object_id_count++;
+}
 
 Map create_map_struct(int grid_width, int grid_height) {
     Map map;
@@ -25,8 +33,8 @@ Map create_map_struct(int grid_width, int grid_height) {
 }
 
 Entity create_map(int grid_width, int grid_height) {
-    Entity ent = Entity();    
-    registry.maps.insert(ent, create_map_struct(grid_width, grid_height));
+    Entity ent = registry().create();    
+    registry().maps.insert(ent, create_map_struct(grid_width, grid_height));
     return ent;
 }
 
@@ -78,7 +86,7 @@ void add_tile_to_room(Room& room, ivec2 pos, Tile tile) {
     }
 
 	WALL_DIRECTION direction = get_wall_direction(tile.texture);
-    int id = (int)Entity();
+    int id = new_map_object_id();
     room.room_tiles.emplace(id, tile);
     for (int i = y; i < y + height; i++) {
         for (int j = x; j < x + width; j++) {
@@ -142,7 +150,7 @@ bool add_room_to_map(Map& map, Room& room, ivec2 pos) {
     }
 
     fill_missing_with_floor(room);
-    int room_id = (int)Entity();
+    int room_id = new_map_object_id();
 
     for (const auto& [id, tile] : room.room_tiles) {
         map.tiles.emplace(id, tile);
@@ -204,15 +212,15 @@ void add_light(Map& map, vec2 pos, vec3 color, float radius, float intensity, fl
 }
 
 void add_temp_light(vec2 pos, vec3 color, float radius, float intensity, bool is_local, float timer) {
-    Entity entity = Entity();
-    Light& light = registry.lights.emplace(entity);
+    Entity entity = registry().create();
+    Light& light = registry().lights.emplace(entity);
     light.color = color;
     light.position = pos;
     light.radius = radius;
     light.intensity = intensity;
     light.is_local = is_local;
 
-    RemoveTimer& removeTimer = registry.removeTimers.emplace(entity);
+    RemoveTimer& removeTimer = registry().removeTimers.emplace(entity);
     removeTimer.remaining_time = timer;
 }
 
@@ -239,7 +247,7 @@ void update_tile_grid(Map& map) {
 }
 
 void set_tile(Map& map, ivec2 pos, Tile tile) {
-    int id = (int)Entity();
+    int id = new_map_object_id();
 
     map.tile_id_grid[pos.y][pos.x] = tile.id;
     map.tile_object_grid[pos.y][pos.x] = id;
@@ -305,7 +313,7 @@ Map load_map_from_file(const std::string& name) {
         }
         auto [tileset_name, lid] = global_to_local_id(gid, tilesets);
 		Tile tile = get_tile_from_tileset(tileset_name, lid);
-		int tile_id = (int)Entity();
+		int tile_id = new_map_object_id();
         map.tiles.emplace(tile_id, tile);
 		map.tile_object_grid[y][x] = tile_id;
 		map.tile_id_grid[y][x] = map.tiles[tile_id].id;
@@ -414,8 +422,8 @@ const Prop get_prop_from_tileset(const std::string& tileset_name, int lid) {
 
 void create_map_0() {
     Map map_struct = create_map_struct(50, 100);
-    Entity map_entity = Entity();
-    Map& map = registry.maps.insert(map_entity, map_struct);
+    Entity map_entity = registry().create();
+    Map& map = registry().maps.insert(map_entity, map_struct);
 
     map.start_location = {16, 28};
     map.music = MUSIC_ASSET_ID::MUSIC1;
@@ -557,8 +565,8 @@ void create_map_0() {
 
 void create_map_1() {
     Map map_struct = create_map_struct(50, 100);
-    Entity map_entity = Entity();
-    Map& map = registry.maps.insert(map_entity, map_struct);
+    Entity map_entity = registry().create();
+    Map& map = registry().maps.insert(map_entity, map_struct);
 
     map.start_location = {22, 43};
     map.music = MUSIC_ASSET_ID::MUSIC2;
@@ -785,8 +793,8 @@ void create_map_1() {
 
 void create_map_2() {
     Map file_map = load_map_from_file("level2");
-    Entity map_entity = Entity();
-    Map& map = registry.maps.insert(map_entity, file_map);
+    Entity map_entity = registry().create();
+    Map& map = registry().maps.insert(map_entity, file_map);
 
     map.start_location = {18, 43};
     map.music = MUSIC_ASSET_ID::MUSIC3;
@@ -854,8 +862,8 @@ void create_map_2() {
 
 void create_map_3() {
     Map file_map = load_map_from_file("level3");
-    Entity map_entity = Entity();
-    Map& map = registry.maps.insert(map_entity, file_map);
+    Entity map_entity = registry().create();
+    Map& map = registry().maps.insert(map_entity, file_map);
 
     map.start_location = {25, 46};
     map.music = MUSIC_ASSET_ID::MUSIC4;
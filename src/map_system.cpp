@@ -1,17 +1,23 @@
 #include "map_system.hpp"
 #include "tinyECS/tiny_ecs.hpp"
 #include "tinyECS/registry.hpp"
+#include "world.hpp"
+#include "audio_system.hpp"
+#include "ui_system.hpp"
 #include "physics_system_init.hpp"
 #include "ai_system_init.hpp"
 #include "input_system.hpp"
 #include <cmath>
 #include <iostream>
+#include <unordered_set>
 #include "map_init.hpp"
 #include "animation_init.hpp"
 #include "player_system.hpp"
 
 void MapSystem::init(RenderSystem* renderer) {
 	this->renderer = renderer;
+	registry().on_construct<Door>().connect<&MapSystem::on_door_constructed>(this);
+	registry().on_destroy<Door>().connect<&MapSystem::on_door_destroyed>(this);
 	create_map_0();
 	create_map_1();
 	create_map_2();
@@ -20,28 +26,42 @@ void MapSystem::init(RenderSystem* renderer) {
 }
 
 void MapSystem::load_map(int map_entity_index) {
-	Map& map = registry.maps.components[map_entity_index];
+	Map& map = registry().maps.components[map_entity_index];
 	update_tile_grid(map);
 	set_active_map(map);
 	render_map();
 	spawn_map_pickups();
 	spawn_map_enemies();
+	registry().reset_peak_sizes();
 }
 
 void MapSystem::set_active_map(Map& map) {
 	current_map = &map;
 }
 
+void MapSystem::on_door_constructed(Entity door_entity) {
+	Door& door = registry().doors.get(door_entity);
+	registry().maps.components[door.level].prop_doors[door.cell] = door_entity;
+}
+
+// Broken doors and the doors of a level that is left are taken out of the index, the door layout itself stays
+void MapSystem::on_door_destroyed(Entity door_entity) {
+	Door& door = registry().doors.get(door_entity);
+	auto& prop_doors = registry().maps.components[door.level].prop_doors;
+	auto it = prop_doors.find(door.cell);
+	if (it != prop_doors.end() && it->second == door_entity) {
+		prop_doors.erase(it);
+	}
+}
+
 void MapSystem::load_next_map() {
-	if (registry.gameProgress.components[0].level+1 == registry.maps.entities.size()) {
+	if (registry().gameProgress.components[0].level+1 == registry().maps.entities.size()) {
 		create_animation(
-			{ registry.screen_state.resolution_x / 2, registry.screen_state.resolution_y / 2 },
+			{ registry().screen_state.resolution_x / 2, registry().screen_state.resolution_y / 2 },
 			{ 0.f, 0.f },
-			{ registry.screen_state.resolution_x, registry.screen_state.resolution_y },
+			{ registry().screen_state.resolution_x, registry().screen_state.resolution_y },
 			0.f,
-			std::vector<TEXTURE_ASSET_ID>{
-				TEXTURE_ASSET_ID::GAME_END_TEXT
-			},
+			still_clip(TEXTURE_ASSET_ID::GAME_END_TEXT),
 			true,
 			true,
 			3000.0f,
@@ -53,22 +73,20 @@ void MapSystem::load_next_map() {
 		return;
 	}
 	derender_map();
-	GameProgress& game_progress = registry.gameProgress.components[0];
+	GameProgress& game_progress = registry().gameProgress.components[0];
 	game_progress.level++;
 	load_map(game_progress.level);
 
 	if (!debugging.disable_music) {
-		registry.audio_system->play_music(current_map->music, 14);
+		world().audio_system->play_music(current_map->music, 14);
 	}
 
 	create_animation(
-		{registry.screen_state.resolution_x/2, registry.screen_state.resolution_y/2},
+		{registry().screen_state.resolution_x/2, registry().screen_state.resolution_y/2},
 		{ 0.f, 0.f },
-		{registry.screen_state.resolution_x, registry.screen_state.resolution_y},
+		{registry().screen_state.resolution_x, registry().screen_state.resolution_y},
 		0.f,
-		std::vector<TEXTURE_ASSET_ID>{
-			current_map->level_title,
-		},
+		still_clip(current_map->level_title),
 		true,
 		false,
 		3000.0f,
@@ -77,24 +95,24 @@ void MapSystem::load_next_map() {
 		true
 	);
 
-	Entity player_entity = registry.players.entities[0];
-	Player& player_component = registry.players.get(player_entity);
+	Entity player_entity = registry().players.entities[0];
+	Player& player_component = registry().players.modify(player_entity);
 	player_component.health = STARTING_PLAYER_HEALTH;
-	Motion& player_motion = registry.motions.get(player_entity);
+	Motion& player_motion = registry().motions.get(player_entity);
 	player_motion.position = grid_to_world_coord(current_map->start_location.x, current_map->start_location.y);
-	registry.guns.remove(player_entity);
+	registry().guns.remove(player_entity);
 	create_gun(player_entity, current_map->gun_type);
-	registry.ui_system->update_gun_ui();
+	world().ui_system->update_gun_ui();
 	update_player_sprite();
 }
 
-void MapSystem::make_narrow_vertical_door(Entity door_entity, Motion motion, Map& map) {
-	Entity e1 = Entity();
-	Motion& m1 = registry.motions.insert(e1, motion);
-	Entity e2 = Entity();
-	Motion& m2 = registry.motions.insert(e2, motion);
-	Entity e3 = Entity();
-	Motion& m3 = registry.motions.insert(e3, motion);
+Entity MapSystem::make_narrow_vertical_door(Entity door_entity, Motion motion, Map& map) {
+	Entity e1 = registry().create();
+	Motion& m1 = registry().motions.insert(e1, motion);
+	Entity e2 = registry().create();
+	Motion& m2 = registry().motions.insert(e2, motion);
+	Entity e3 = registry().create();
+	Motion& m3 = registry().motions.insert(e3, motion);
 
 	m1.position = { m1.position.x - 4, m1.position.y + 97 };
 	m2.position = { m2.position.x - 4, m2.position.y - 152 };
@@ -104,12 +122,12 @@ void MapSystem::make_narrow_vertical_door(Entity door_entity, Motion motion, Map
 	m1.scale = { m1.scale.x * .8, m1.scale.y * .5 };
 	m2.scale = { m2.scale.x * .8, m2.scale.y * .5 };
 
-	Entity e4 = Entity();
-	Motion& m4 = registry.motions.insert(e4, motion);
-	Entity e5 = Entity();
-	Motion& m5 = registry.motions.insert(e5, motion);
-	Entity e6 = Entity();
-	Motion& m6 = registry.motions.insert(e6, motion);
+	Entity e4 = registry().create();
+	Motion& m4 = registry().motions.insert(e4, motion);
+	Entity e5 = registry().create();
+	Motion& m5 = registry().motions.insert(e5, motion);
+	Entity e6 = registry().create();
+	Motion& m6 = registry().motions.insert(e6, motion);
 	m4.position = { m4.position.x + 64, m4.position.y - 152 };
 	m5.position = { m5.position.x + 64, m5.position.y + 97 };
 	m6.position = { m6.position.x + 64, m6.position.y - 29 };
@@ -122,12 +140,12 @@ void MapSystem::make_narrow_vertical_door(Entity door_entity, Motion motion, Map
 	m4.scale = { m4.scale.x * .8, m4.scale.y * .5 };
 	m5.scale = { m5.scale.x * .8, m5.scale.y * .5 };
 
-	Entity e7 = Entity();
-	Motion& m7 = registry.motions.insert(e7, motion);
+	Entity e7 = registry().create();
+	Motion& m7 = registry().motions.insert(e7, motion);
 	m7.position = { m7.position.x + 65, m7.position.y - 28};
 	m7.angle += 180;
 
-	registry.renderRequests.insert(
+	registry().renderRequests.insert(
 		e1,
 		{
 			TEXTURE_ASSET_ID::DOOR_RIGHT,
@@ -139,7 +157,7 @@ void MapSystem::make_narrow_vertical_door(Entity door_entity, Motion motion, Map
 			TEXTURE_ASSET_ID::DOOR_RIGHT_NORMAL
 		}
 	);
-	registry.renderRequests.insert(
+	registry().renderRequests.insert(
 		e2,
 		{
 			TEXTURE_ASSET_ID::DOOR_LEFT,
@@ -152,7 +170,7 @@ void MapSystem::make_narrow_vertical_door(Entity door_entity, Motion motion, Map
 		}
 	);
 	
-	registry.renderRequests.insert(
+	registry().renderRequests.insert(
 		e3,
 		{
 			TEXTURE_ASSET_ID::DOOR_TOP,
@@ -165,7 +183,7 @@ void MapSystem::make_narrow_vertical_door(Entity door_entity, Motion motion, Map
 		}
 	);
 	
-	registry.renderRequests.insert(
+	registry().renderRequests.insert(
 		e4,
 		{
 			TEXTURE_ASSET_ID::DOOR_RIGHT,
@@ -178,7 +196,7 @@ void MapSystem::make_narrow_vertical_door(Entity door_entity, Motion motion, Map
 		}
 	);
 	
-	registry.renderRequests.insert(
+	registry().renderRequests.insert(
 		e5,
 		{
 			TEXTURE_ASSET_ID::DOOR_LEFT,
@@ -191,7 +209,7 @@ void MapSystem::make_narrow_vertical_door(Entity door_entity, Motion motion, Map
 		}
 	);
 	
-	registry.renderRequests.insert(
+	registry().renderRequests.insert(
 		e6,
 		{
 			TEXTURE_ASSET_ID::DOOR_TOP,
@@ -204,7 +222,7 @@ void MapSystem::make_narrow_vertical_door(Entity door_entity, Motion motion, Map
 		}
 	);
 
-	registry.renderRequests.insert(
+	registry().renderRequests.insert(
 		e7,
 		{
 			TEXTURE_ASSET_ID::DOOR,
@@ -217,22 +235,20 @@ void MapSystem::make_narrow_vertical_door(Entity door_entity, Motion motion, Map
 		}
 	);
 
-	map.prop_doors_pair.push_back({ door_entity, {e1, e2, e3, e4, e5, e6, e7}});
-	for (auto& pair : map.prop_doors_pair) {
-		for (auto& entity : pair.second) {
-			current_map->rendered_entities.push_back(entity);
-		}
+	for (Entity part : { e1, e2, e3, e4, e5, e6, e7 }) {
+		current_map->rendered_entities.push_back(part);
 	}
+	return e7;
 }
 
-void MapSystem::make_narrow_horizontal_door(Entity door_entity, Motion motion, Map& map) {
+Entity MapSystem::make_narrow_horizontal_door(Entity door_entity, Motion motion, Map& map) {
 
-	Entity e1 = Entity();
-	Motion& m1 = registry.motions.insert(e1, motion);
-	Entity e2 = Entity();
-	Motion& m2 = registry.motions.insert(e2, motion);
-	Entity e3 = Entity();
-	Motion& m3 = registry.motions.insert(e3, motion);
+	Entity e1 = registry().create();
+	Motion& m1 = registry().motions.insert(e1, motion);
+	Entity e2 = registry().create();
+	Motion& m2 = registry().motions.insert(e2, motion);
+	Entity e3 = registry().create();
+	Motion& m3 = registry().motions.insert(e3, motion);
 
 	m1.position = { m1.position.x + 165, m1.position.y + 4 };
 	m2.position = { m2.position.x - 107, m2.position.y + 2 };
@@ -242,12 +258,12 @@ void MapSystem::make_narrow_horizontal_door(Entity door_entity, Motion motion, M
 	m1.scale = { m1.scale.x * .5, m1.scale.y * .8 };
 	m2.scale = { m2.scale.x * .5, m2.scale.y * .8 };
 
-	Entity e4 = Entity();
-	Motion& m4 = registry.motions.insert(e4, motion);
-	Entity e5 = Entity();
-	Motion& m5 = registry.motions.insert(e5, motion);
-	Entity e6 = Entity();
-	Motion& m6 = registry.motions.insert(e6, motion);
+	Entity e4 = registry().create();
+	Motion& m4 = registry().motions.insert(e4, motion);
+	Entity e5 = registry().create();
+	Motion& m5 = registry().motions.insert(e5, motion);
+	Entity e6 = registry().create();
+	Motion& m6 = registry().motions.insert(e6, motion);
 	m4.position = { m4.position.x - 105, m4.position.y - 62 };
 	m5.position = { m5.position.x + 167, m5.position.y - 60 };
 	m6.position = { m6.position.x + 30 , m6.position.y - 61 };
@@ -260,12 +276,12 @@ void MapSystem::make_narrow_horizontal_door(Entity door_entity, Motion motion, M
 	m4.scale = { m4.scale.x * .5, m4.scale.y * .8 };
 	m5.scale = { m5.scale.x * .5, m5.scale.y * .8 };
 
-	Entity e7 = Entity();
-	Motion& m7 = registry.motions.insert(e7, motion);
+	Entity e7 = registry().create();
+	Motion& m7 = registry().motions.insert(e7, motion);
 	m7.position = { m7.position.x + 29, m7.position.y - 65 };
 	m7.angle += 180;
 
-	registry.renderRequests.insert(
+	registry().renderRequests.insert(
 		e1,
 		{
 			TEXTURE_ASSET_ID::DOOR_RIGHT,
@@ -277,7 +293,7 @@ void MapSystem::make_narrow_horizontal_door(Entity door_entity, Motion motion, M
 			TEXTURE_ASSET_ID::DOOR_RIGHT_NORMAL
 		}
 	);
-	registry.renderRequests.insert(
+	registry().renderRequests.insert(
 		e2,
 		{
 			TEXTURE_ASSET_ID::DOOR_LEFT,
@@ -290,7 +306,7 @@ void MapSystem::make_narrow_horizontal_door(Entity door_entity, Motion motion, M
 		}
 	);
 	
-	registry.renderRequests.insert(
+	registry().renderRequests.insert(
 		e3,
 		{
 			TEXTURE_ASSET_ID::DOOR_TOP,
@@ -303,7 +319,7 @@ void MapSystem::make_narrow_horizontal_door(Entity door_entity, Motion motion, M
 		}
 	);
 	
-	registry.renderRequests.insert(
+	registry().renderRequests.insert(
 		e4,
 		{
 			TEXTURE_ASSET_ID::DOOR_RIGHT,
@@ -316,7 +332,7 @@ void MapSystem::make_narrow_horizontal_door(Entity door_entity, Motion motion, M
 		}
 	);
 	
-	registry.renderRequests.insert(
+	registry().renderRequests.insert(
 		e5,
 		{
 			TEXTURE_ASSET_ID::DOOR_LEFT,
@@ -329,7 +345,7 @@ void MapSystem::make_narrow_horizontal_door(Entity door_entity, Motion motion, M
 		}
 	);
 	
-	registry.renderRequests.insert(
+	registry().renderRequests.insert(
 		e6,
 		{
 			TEXTURE_ASSET_ID::DOOR_TOP,
@@ -341,7 +357,7 @@ void MapSystem::make_narrow_horizontal_door(Entity door_entity, Motion motion, M
 			TEXTURE_ASSET_ID::DOOR_TOP_NORMAL
 		}
 	);
-	registry.renderRequests.insert(
+	registry().renderRequests.insert(
 		e7,
 		{
 			TEXTURE_ASSET_ID::DOOR,
@@ -354,22 +370,19 @@ void MapSystem::make_narrow_horizontal_door(Entity door_entity, Motion motion, M
 		}
 	);
 
-	map.prop_doors_pair.push_back({ door_entity, {e1, e2, e3, e4, e5, e6, e7} });
-
-	for (auto& pair : map.prop_doors_pair) {
-		for (auto& entity : pair.second) {
-			current_map->rendered_entities.push_back(entity);
-		}
+	for (Entity part : { e1, e2, e3, e4, e5, e6, e7 }) {
+		current_map->rendered_entities.push_back(part);
 	}
+	return e7;
 }
 
-void MapSystem::make_vertical_door(Entity door_entity, Motion motion, Map& map) {
-	Entity e1 = Entity();
-	Motion& m1 = registry.motions.insert(e1, motion);
-	Entity e2 = Entity();
-	Motion& m2 = registry.motions.insert(e2, motion);
-	Entity e3 = Entity();
-	Motion& m3 = registry.motions.insert(e3, motion);
+Entity MapSystem::make_vertical_door(Entity door_entity, Motion motion, Map& map) {
+	Entity e1 = registry().create();
+	Motion& m1 = registry().motions.insert(e1, motion);
+	Entity e2 = registry().create();
+	Motion& m2 = registry().motions.insert(e2, motion);
+	Entity e3 = registry().create();
+	Motion& m3 = registry().motions.insert(e3, motion);
 
 	m1.position = { m1.position.x - 4, m1.position.y + 208 };
 	m2.position = { m2.position.x - 4, m2.position.y - 208 };
@@ -379,12 +392,12 @@ void MapSystem::make_vertical_door(Entity door_entity, Motion motion, Map& map)
 	m1.scale = { m1.scale.x * .8, m1.scale.y * .5 };
 	m2.scale = { m2.scale.x * .8, m2.scale.y * .5 };
 
-	Entity e4 = Entity();
-	Motion& m4 = registry.motions.insert(e4, motion);
-	Entity e5 = Entity();
-	Motion& m5 = registry.motions.insert(e5, motion);
-	Entity e6 = Entity();
-	Motion& m6 = registry.motions.insert(e6, motion);
+	Entity e4 = registry().create();
+	Motion& m4 = registry().motions.insert(e4, motion);
+	Entity e5 = registry().create();
+	Motion& m5 = registry().motions.insert(e5, motion);
+	Entity e6 = registry().create();
+	Motion& m6 = registry().motions.insert(e6, motion);
 	m4.position = { m4.position.x + 64, m4.position.y - 208 };
 	m5.position = { m5.position.x + 64, m5.position.y + 208 };
 	m6.position = { m6.position.x + 64, m6.position.y - 4 };
@@ -397,12 +410,12 @@ void MapSystem::make_vertical_door(Entity door_entity, Motion motion, Map& map)
 	m4.scale = { m4.scale.x * .8, m4.scale.y * .5 };
 	m5.scale = { m5.scale.x * .8, m5.scale.y * .5 };
 
-	Entity e7 = Entity();
-	Motion& m7 = registry.motions.insert(e7, motion);
+	Entity e7 = registry().create();
+	Motion& m7 = registry().motions.insert(e7, motion);
 	m7.position = { m7.position.x + 65, m7.position.y  };
 	m7.angle += 180;
 
-	registry.renderRequests.insert(
+	registry().renderRequests.insert(
 		e1,
 		{
 			TEXTURE_ASSET_ID::DOOR_RIGHT,
@@ -414,7 +427,7 @@ void MapSystem::make_vertical_door(Entity door_entity, Motion motion, Map& map)
 			TEXTURE_ASSET_ID::DOOR_RIGHT_NORMAL
 		}
 	);
-	registry.renderRequests.insert(
+	registry().renderRequests.insert(
 		e2,
 		{
 			TEXTURE_ASSET_ID::DOOR_LEFT,
@@ -427,7 +440,7 @@ void MapSystem::make_vertical_door(Entity door_entity, Motion motion, Map& map)
 		}
 	);
 	
-	registry.renderRequests.insert(
+	registry().renderRequests.insert(
 		e3,
 		{
 			TEXTURE_ASSET_ID::DOOR_TOP,
@@ -440,7 +453,7 @@ void MapSystem::make_vertical_door(Entity door_entity, Motion motion, Map& map)
 		}
 	);
 	
-	registry.renderRequests.insert(
+	registry().renderRequests.insert(
 		e4,
 		{
 			TEXTURE_ASSET_ID::DOOR_RIGHT,
@@ -453,7 +466,7 @@ void MapSystem::make_vertical_door(Entity door_entity, Motion motion, Map& map)
 		}
 	);
 	
-	registry.renderRequests.insert(
+	registry().renderRequests.insert(
 		e5,
 		{
 			TEXTURE_ASSET_ID::DOOR_LEFT,
@@ -466,7 +479,7 @@ void MapSystem::make_vertical_door(Entity door_entity, Motion motion, Map& map)
 		}
 	);
 	
-	registry.renderRequests.insert(
+	registry().renderRequests.insert(
 		e6,
 		{
 			TEXTURE_ASSET_ID::DOOR_TOP,
@@ -479,7 +492,7 @@ void MapSystem::make_vertical_door(Entity door_entity, Motion motion, Map& map)
 		}
 	);
 
-	registry.renderRequests.insert(
+	registry().renderRequests.insert(
 		e7,
 		{
 			TEXTURE_ASSET_ID::DOOR,
@@ -492,23 +505,20 @@ void MapSystem::make_vertical_door(Entity door_entity, Motion motion, Map& map)
 		}
 	);
 
-	map.prop_doors_pair.push_back({ door_entity, {e1, e2, e3, e4, e5, e6, e7} });
-
-	for (auto& pair : map.prop_doors_pair) {
-		for (auto& entity : pair.second) {
-			current_map->rendered_entities.push_back(entity);
-		}
+	for (Entity part : { e1, e2, e3, e4, e5, e6, e7 }) {
+		current_map->rendered_entities.push_back(part);
 	}
+	return e7;
 }
 
-void MapSystem::make_horizontal_door(Entity door_entity, Motion motion, Map& map) {
+Entity MapSystem::make_horizontal_door(Entity door_entity, Motion motion, Map& map) {
 	
-	Entity e1 = Entity();
-	Motion& m1 = registry.motions.insert(e1, motion);
-	Entity e2 = Entity();
-	Motion& m2 = registry.motions.insert(e2, motion);
-	Entity e3 = Entity();
-	Motion& m3 = registry.motions.insert(e3, motion);
+	Entity e1 = registry().create();
+	Motion& m1 = registry().motions.insert(e1, motion);
+	Entity e2 = registry().create();
+	Motion& m2 = registry().motions.insert(e2, motion);
+	Entity e3 = registry().create();
+	Motion& m3 = registry().motions.insert(e3, motion);
 
 	m1.position = { m1.position.x + 207, m1.position.y + 5 };
 	m2.position = { m2.position.x - 210, m2.position.y + 3 };
@@ -518,12 +528,12 @@ void MapSystem::make_horizontal_door(Entity door_entity, Motion motion, Map& map
 	m1.scale = { m1.scale.x * .5, m1.scale.y * .8 };
 	m2.scale = { m2.scale.x * .5, m2.scale.y * .8 };
 
-	Entity e4 = Entity();
-	Motion& m4 = registry.motions.insert(e4, motion);
-	Entity e5 = Entity();
-	Motion& m5 = registry.motions.insert(e5, motion);
-	Entity e6 = Entity();
-	Motion& m6 = registry.motions.insert(e6, motion);
+	Entity e4 = registry().create();
+	Motion& m4 = registry().motions.insert(e4, motion);
+	Entity e5 = registry().create();
+	Motion& m5 = registry().motions.insert(e5, motion);
+	Entity e6 = registry().create();
+	Motion& m6 = registry().motions.insert(e6, motion);
 	m4.position = { m4.position.x - 207, m4.position.y - 65 };
 	m5.position = { m5.position.x + 210, m5.position.y - 63 };
 	m6.position = { m6.position.x , m6.position.y - 64 };
@@ -536,12 +546,12 @@ void MapSystem::make_horizontal_door(Entity door_entity, Motion motion, Map& map
 	m4.scale = { m4.scale.x * .5, m4.scale.y * .8 };
 	m5.scale = { m5.scale.x * .5, m5.scale.y * .8 };
 
-	Entity e7 = Entity();
-	Motion& m7 = registry.motions.insert(e7, motion);
+	Entity e7 = registry().create();
+	Motion& m7 = registry().motions.insert(e7, motion);
 	m7.position = { m7.position.x, m7.position.y - 65 };
 	m7.angle += 180;
 
-	registry.renderRequests.insert(
+	registry().renderRequests.insert(
 		e1,
 		{
 			TEXTURE_ASSET_ID::DOOR_RIGHT,
@@ -553,7 +563,7 @@ void MapSystem::make_horizontal_door(Entity door_entity, Motion motion, Map& map
 			TEXTURE_ASSET_ID::DOOR_RIGHT_NORMAL
 		}
 	);
-	registry.renderRequests.insert(
+	registry().renderRequests.insert(
 		e2,
 		{
 			TEXTURE_ASSET_ID::DOOR_LEFT,
@@ -565,7 +575,7 @@ void MapSystem::make_horizontal_door(Entity door_entity, Motion motion, Map& map
 			TEXTURE_ASSET_ID::DOOR_LEFT_NORMAL
 		}
 	);
-	registry.renderRequests.insert(
+	registry().renderRequests.insert(
 		e3,
 		{
 			TEXTURE_ASSET_ID::DOOR_TOP,
@@ -578,7 +588,7 @@ void MapSystem::make_horizontal_door(Entity door_entity, Motion motion, Map& map
 		}
 	);
 
-	registry.renderRequests.insert(
+	registry().renderRequests.insert(
 		e4,
 		{
 			TEXTURE_ASSET_ID::DOOR_RIGHT,
@@ -590,7 +600,7 @@ void MapSystem::make_horizontal_door(Entity door_entity, Motion motion, Map& map
 			TEXTURE_ASSET_ID::DOOR_RIGHT_NORMAL
 		}
 	);
-	registry.renderRequests.insert(
+	registry().renderRequests.insert(
 		e5,
 		{
 			TEXTURE_ASSET_ID::DOOR_LEFT,
@@ -602,7 +612,7 @@ void MapSystem::make_horizontal_door(Entity door_entity, Motion motion, Map& map
 			TEXTURE_ASSET_ID::DOOR_LEFT_NORMAL
 		}
 	);
-	registry.renderRequests.insert(
+	registry().renderRequests.insert(
 		e6,
 		{
 			TEXTURE_ASSET_ID::DOOR_TOP,
@@ -615,7 +625,7 @@ void MapSystem::make_horizontal_door(Entity door_entity, Motion motion, Map& map
 		}
 	);
 
-	registry.renderRequests.insert(
+	registry().renderRequests.insert(
 		e7,
 		{
 			TEXTURE_ASSET_ID::DOOR,
@@ -628,39 +638,43 @@ void MapSystem::make_horizontal_door(Entity door_entity, Motion motion, Map& map
 		}
 	);
 
-	map.prop_doors_pair.push_back({ door_entity, {e1, e2, e3, e4, e5, e6, e7} });
-	for (auto& pair : map.prop_doors_pair) {
-		for (auto& entity : pair.second) {
-			current_map->rendered_entities.push_back(entity);
-		}
+	for (Entity part : { e1, e2, e3, e4, e5, e6, e7 }) {
+		current_map->rendered_entities.push_back(part);
 	}
+	return e7;
 }
 
 void MapSystem::make_door(Entity door_entity,Motion& motion, Map& map, bool vertical_door, int size) {
-
+	// the door parts are inserted into registry().motions, which can move the door's Motion, so work on a copy
+	Motion door_motion = motion;
+	Entity second_leaf;
 	if (size == 2) {
 		if (vertical_door) {
-			motion.angle += 90;
-			make_vertical_door(door_entity, motion, map);
-			motion.position = { motion.position.x - 2, motion.position.y };
+			door_motion.angle += 90;
+			second_leaf = make_vertical_door(door_entity, door_motion, map);
+			door_motion.position = { door_motion.position.x - 2, door_motion.position.y };
 		}
 		else {
-			make_horizontal_door(door_entity, motion, map);
-			motion.position = { motion.position.x, motion.position.y + 7 };
+			second_leaf = make_horizontal_door(door_entity, door_motion, map);
+			door_motion.position = { door_motion.position.x, door_motion.position.y + 7 };
 		}
 	}
 	else {
 		if (vertical_door) {
-			motion.angle += 90;
-			make_narrow_vertical_door(door_entity, motion, map);
-			motion.position = { motion.position.x - 4, motion.position.y - 27};
+			door_motion.angle += 90;
+			second_leaf = make_narrow_vertical_door(door_entity, door_motion, map);
+			door_motion.position = { door_motion.position.x - 4, door_motion.position.y - 27};
 		}
 		else {
-			make_narrow_horizontal_door(door_entity, motion, map);
-			motion.position = { motion.position.x + 28, motion.position.y + 8 };
+			second_leaf = make_narrow_horizontal_door(door_entity, door_motion, map);
+			door_motion.position = { door_motion.position.x + 28, door_motion.position.y + 8 };
 		}
 	}
-	registry.renderRequests.insert(
+	registry().motions.get(door_entity) = door_motion;
+	// the second leaf follows the door and breaks together with it, the frame parts stay
+	registry().set_parent(second_leaf, door_entity);
+
+	registry().renderRequests.insert(
 		door_entity,
 		{
 			TEXTURE_ASSET_ID::DOOR,
@@ -678,14 +692,14 @@ void MapSystem::render_map() {
 	find_and_create_shadow_casters();
 	renderer->set_map_texture(*current_map);
 	
-	Entity base_map_ent = Entity();
-	Motion& motion = registry.motions.emplace(base_map_ent);
+	Entity base_map_ent = registry().create();
+	Motion& motion = registry().motions.emplace(base_map_ent);
 	motion.angle = 0.f;
 	motion.velocity = { 0.0f, 0.0f };
 	motion.position = { GRID_CELL_SIZE * current_map->grid_width * 0.5f, GRID_CELL_SIZE * current_map->grid_height * 0.5f};
 	motion.scale = vec2({ GRID_CELL_SIZE * current_map->grid_width, GRID_CELL_SIZE * current_map->grid_height });
 
-	registry.renderRequests.insert(
+	registry().renderRequests.insert(
 		base_map_ent,
 		{
 			TEXTURE_ASSET_ID::TEXTURE_COUNT, 
@@ -699,8 +713,8 @@ void MapSystem::render_map() {
 	current_map->rendered_entities.push_back(base_map_ent);
 
 	for (Light& light : current_map->lights) {
-		Entity light_ent = Entity();
-		Light& new_light = registry.lights.emplace(light_ent);
+		Entity light_ent = registry().create();
+		Light& new_light = registry().lights.emplace(light_ent);
 		new_light.color = light.color;
 		new_light.position = light.position;
 		new_light.radius = light.radius;
@@ -710,36 +724,28 @@ void MapSystem::render_map() {
 		current_map->rendered_entities.push_back(light_ent);
 	}
 
+	// door locations as a set, so that finding out whether a prop is a door does not scan the door list for every prop
+	std::unordered_set<ivec2, ivec2_hash> door_cells(current_map->prop_doors_list.begin(), current_map->prop_doors_list.end());
+
 	for (const auto& [pos, prop] : current_map->props) {
-		Entity entity = Entity();
-		Motion& motion = registry.motions.emplace(entity);
+		Entity entity = registry().create();
+		Motion& motion = registry().motions.emplace(entity);
 		motion.angle = prop.angle;
 		motion.velocity = { 0.0f, 0.0f };
 		motion.position = grid_to_world_coord(pos.x, pos.y);
 		motion.scale = vec2({ GRID_CELL_SIZE * prop.size.x, GRID_CELL_SIZE * prop.size.y});
 
 		// see if prop is door
-		int current_level = registry.gameProgress.components[0].level;
-		Map& map = registry.maps.components[current_level];
-		bool found = false;
-		bool is_vertical = false;
-		int size = 1;
-		for (const auto& door_loc : map.prop_doors_list) {
-			if (door_loc.x == pos.x && door_loc.y == pos.y) {
-				found = true;
-				Prop door_prop = map.props[door_loc];
-				is_vertical = door_prop.vertical;
-				size = door_prop.prop_size;
-				break;
-			}
-		}
+		int current_level = registry().gameProgress.components[0].level;
+		Map& map = registry().maps.components[current_level];
+		bool found = door_cells.count(ivec2(pos)) != 0;
 
 		if (found) {
-			map.prop_doors[pos] = entity;
-			make_door(entity, motion, map, is_vertical, size);
+			registry().doors.insert(entity, { pos, current_level });
+			make_door(entity, motion, map, prop.vertical, prop.prop_size);
 		}
 		else {
-			registry.renderRequests.insert(
+			registry().renderRequests.insert(
 				entity,
 				{
 					prop.texture,
@@ -754,10 +760,10 @@ void MapSystem::render_map() {
 		}
 
 		if (prop.collidable) {
-			registry.staticCollidables.emplace(entity);
-			AABB& aabb = registry.AABBs.emplace(entity);
+			AABB& aabb = registry().AABBs.emplace(entity);
 			aabb.collision_box = prop.collision_size * (float)GRID_CELL_SIZE;
 			aabb.offset = prop.collision_offset * (float)GRID_CELL_SIZE;
+			registry().staticCollidables.emplace(entity);
 			if (found) {
 				current_map->tile_id_grid[pos.y][pos.x] = TILE_ID::CLOSED_DOOR;
 			}
@@ -772,36 +778,37 @@ void MapSystem::render_map() {
 	
 	find_and_create_wall_sections();
 	current_map->information_props = current_map->props;
+	freeze_static_bodies(current_map->rendered_entities);
 	clear_and_set_spatial_hash();
 }
 
 void MapSystem::derender_map() {
 	for (auto& entity : current_map->rendered_entities) {
-		registry.remove_all_components_of(entity);
+		registry().destroy(entity);
 	}
 
-	while (!registry.staticCollidables.entities.empty()) {
-		registry.remove_all_components_of(registry.staticCollidables.entities.back());
+	while (!registry().staticCollidables.entities.empty()) {
+		registry().destroy(registry().staticCollidables.entities.back());
 	}
 
-	while (!registry.shadowCasters.entities.empty()) {
-		registry.remove_all_components_of(registry.shadowCasters.entities.back());
+	while (!registry().shadowCasters.entities.empty()) {
+		registry().destroy(registry().shadowCasters.entities.back());
 	}
 
-	while (!registry.pickups.entities.empty()) {
-		registry.remove_all_components_of(registry.pickups.entities.back());
+	while (!registry().pickups.entities.empty()) {
+		registry().destroy(registry().pickups.entities.back());
 	}
 
-	while (!registry.enemies.entities.empty()) {
-		registry.remove_all_components_of(registry.enemies.entities.back());
+	while (!registry().enemies.entities.empty()) {
+		registry().destroy(registry().enemies.entities.back());
 	}
 
-	while (!registry.deadEnemies.entities.empty()) {
-		registry.remove_all_components_of(registry.deadEnemies.entities.back());
+	while (!registry().deadEnemies.entities.empty()) {
+		registry().destroy(registry().deadEnemies.entities.back());
 	}
 
-	while (!registry.instructionMessages.entities.empty()) {
-		registry.remove_all_components_of(registry.instructionMessages.entities.back());
+	while (!registry().instructionMessages.entities.empty()) {
+		registry().destroy(registry().instructionMessages.entities.back());
 	}
 
 	current_map->rendered_entities.clear();
@@ -840,7 +847,7 @@ void MapSystem::find_and_create_shadow_casters() {
 			}
 			
 			if (in_segment && (!is_valid_edge || current_is_top_edge != is_top_edge)) {
-				ShadowCaster& shadow_caster = registry.shadowCasters.emplace(Entity());
+				ShadowCaster& shadow_caster = registry().shadowCasters.emplace(registry().create());
 				
 				if (is_top_edge) {
 					shadow_caster.start = grid_to_world_coord(segment_start_x, y) + vec2(-GRID_CELL_SIZE / 2.0, -GRID_CELL_SIZE / 2.0);
@@ -873,7 +880,7 @@ void MapSystem::find_and_create_shadow_casters() {
                                 wall_directions[y][x] == WALL_DIRECTION::BOTTOM_LEFT);
             
             if (in_segment && !is_valid_edge) {
-                ShadowCaster& shadow_caster = registry.shadowCasters.emplace(Entity());
+                ShadowCaster& shadow_caster = registry().shadowCasters.emplace(registry().create());
                 shadow_caster.start = grid_to_world_coord(x, segment_start_y) + vec2(-GRID_CELL_SIZE / 2.0, -GRID_CELL_SIZE / 2.0);
                 shadow_caster.end = grid_to_world_coord(x, y - 1) + vec2(-GRID_CELL_SIZE / 2.0, GRID_CELL_SIZE / 2.0);
                 
@@ -899,7 +906,7 @@ void MapSystem::find_and_create_shadow_casters() {
                                 wall_directions[y][x] == WALL_DIRECTION::BOTTOM_RIGHT);
             
             if (in_segment && !is_valid_edge) {
-                ShadowCaster& shadow_caster = registry.shadowCasters.emplace(Entity());
+                ShadowCaster& shadow_caster = registry().shadowCasters.emplace(registry().create());
                 shadow_caster.start = grid_to_world_coord(x, segment_start_y) + vec2(GRID_CELL_SIZE / 2.0, -GRID_CELL_SIZE / 2.0);
                 shadow_caster.end = grid_to_world_coord(x, y - 1) + vec2(GRID_CELL_SIZE / 2.0, GRID_CELL_SIZE / 2.0);
                 
@@ -958,18 +965,18 @@ void MapSystem::find_and_create_wall_sections() {
 }
 
 void MapSystem::create_wall_section(int start_x, int start_y, int end_x, int end_y) {
-	Entity wall_ent = Entity();
-	StaticCollidable& wall = registry.staticCollidables.emplace(wall_ent);
-	Motion& motion = registry.motions.emplace(wall_ent);
+	Entity wall_ent = registry().create();
+	Motion& motion = registry().motions.emplace(wall_ent);
 	motion.angle = 0.f;
 	motion.velocity = { 0, 0 };
 	motion.position = (grid_to_world_coord(start_x, start_y) + grid_to_world_coord(end_x, end_y))/2.f;
 	motion.scale = vec2({ (end_x - start_x + 1) * GRID_CELL_SIZE, (end_y - start_y + 1) * GRID_CELL_SIZE});
-
-	registry.collidables.emplace(wall_ent);
-	AABB& aabb = registry.AABBs.emplace(wall_ent);
+	registry().collidables.emplace(wall_ent);
+	AABB& aabb = registry().AABBs.emplace(wall_ent);
 	aabb.collision_box = motion.scale;
 	aabb.offset = { 0.f, 0.f };
+	// after the Motion and AABB are set, the spatial hash reads them when the static is added
+	registry().staticCollidables.emplace(wall_ent);
 
 	current_map->rendered_entities.push_back(wall_ent);
 }
@@ -3,9 +3,12 @@
 
 #include "tinyECS/entity.hpp"
 #include "render_system.hpp"
+#include "world.hpp"
 
-class MapSystem {
+class MapSystem : public GameSystem {
 public:
+	using GameSystem::GameSystem;
+
 	Map* current_map;
 
     void init(RenderSystem* renderer);
@@ -32,15 +35,18 @@ public:
 
 	void make_door(Entity door_entity, Motion& motion, Map& map, bool vertical_door, int size);
 
-	void make_narrow_vertical_door(Entity door_entity, Motion motion, Map& map);
+	Entity make_narrow_vertical_door(Entity door_entity, Motion motion, Map& map);
 
-	void make_narrow_horizontal_door(Entity door_entity, Motion motion, Map& map);
+	Entity make_narrow_horizontal_door(Entity door_entity, Motion motion, Map& map);
 
-	void make_horizontal_door(Entity door_entity, Motion motion, Map& map);
+	Entity make_horizontal_door(Entity door_entity, Motion motion, Map& map);
 
-	void make_vertical_door(Entity door_entity, Motion motion, Map& map);
+	Entity make_vertical_door(Entity door_entity, Motion motion, Map& map);
 
 private:
+	// Listeners of registry().doors, keep Map::prop_doors pointing at the live door entities
+	void on_door_constructed(Entity door_entity);
+	void on_door_destroyed(Entity door_entity);
 
 	RenderSystem* renderer;
 };
\ No newline at end of file
@@ -0,0 +1,79 @@
+#include "motion_integration.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define PHYSICS_USE_SSE2
+#endif
+
+// The integration kernel loads Motion as eight packed floats
+static_assert(sizeof(Motion) == 8 * sizeof(float), "Motion layout changed, update integrate_motions");
+
+void integrate_motion(Motion& motion, float delta_time)
+{
+	motion.position += motion.velocity * delta_time;
+	motion.angle = (int)(motion.angle + motion.angle_velocity) % 360;
+	if (motion.angle < 0) motion.angle += 360;
+}
+
+#ifdef PHYSICS_USE_SSE2
+// Integrates 4 bodies. Each Motion is two rows of 4 floats, { px, py, angle_velocity, angle } and
+// { vx, vy, sx, sy }, which are transposed so that every register holds one field of all 4 bodies.
+// Returns false without writing anything if an angle is too large to be handled exactly in floats.
+static inline bool integrate_motions_x4(Motion* m, __m128 dt)
+{
+	__m128 px = _mm_loadu_ps(&m[0].position.x);
+	__m128 py = _mm_loadu_ps(&m[1].position.x);
+	__m128 av = _mm_loadu_ps(&m[2].position.x);
+	__m128 ang = _mm_loadu_ps(&m[3].position.x);
+	_MM_TRANSPOSE4_PS(px, py, av, ang);
+
+	__m128 vx = _mm_loadu_ps(&m[0].velocity.x);
+	__m128 vy = _mm_loadu_ps(&m[1].velocity.x);
+	__m128 sx = _mm_loadu_ps(&m[2].velocity.x);
+	__m128 sy = _mm_loadu_ps(&m[3].velocity.x);
+	_MM_TRANSPOSE4_PS(vx, vy, sx, sy);
+
+	// (int)(angle + angle_velocity) % 360, kept exact by doing the math on integral floats below 2^23
+	__m128 sum = _mm_add_ps(ang, av);
+	__m128 abs_sum = _mm_andnot_ps(_mm_set1_ps(-0.f), sum);
+	if (_mm_movemask_ps(_mm_cmpge_ps(abs_sum, _mm_set1_ps(8388608.f))))
+		return false;
+	__m128 full = _mm_set1_ps(360.f);
+	__m128 t = _mm_cvtepi32_ps(_mm_cvttps_epi32(sum));
+	__m128 q = _mm_cvtepi32_ps(_mm_cvttps_epi32(_mm_mul_ps(t, _mm_set1_ps(1.f / 360.f))));
+	__m128 r = _mm_sub_ps(t, _mm_mul_ps(q, full));
+	// the quotient can be off by one, fold the remainder back into (-360, 360)
+	r = _mm_sub_ps(r, _mm_and_ps(_mm_cmpge_ps(r, full), full));
+	r = _mm_add_ps(r, _mm_and_ps(_mm_cmple_ps(r, _mm_set1_ps(-360.f)), full));
+	// if (angle < 0) angle += 360
+	ang = _mm_add_ps(r, _mm_and_ps(_mm_cmplt_ps(r, _mm_setzero_ps()), full));
+
+	px = _mm_add_ps(px, _mm_mul_ps(vx, dt));
+	py = _mm_add_ps(py, _mm_mul_ps(vy, dt));
+
+	_MM_TRANSPOSE4_PS(px, py, av, ang);
+	_mm_storeu_ps(&m[0].position.x, px);
+	_mm_storeu_ps(&m[1].position.x, py);
+	_mm_storeu_ps(&m[2].position.x, av);
+	_mm_storeu_ps(&m[3].position.x, ang);
+	return true;
+}
+#endif
+
+void integrate_motions(Motion* motions, size_t count, float delta_time)
+{
+	size_t i = 0;
+#ifdef PHYSICS_USE_SSE2
+	__m128 dt = _mm_set1_ps(delta_time);
+	for (; i + 8 <= count; i += 8) {
+		for (size_t j = i; j < i + 8; j += 4) {
+			if (!integrate_motions_x4(motions + j, dt)) {
+				for (size_t k = j; k < j + 4; k++)
+					integrate_motion(motions[k], delta_time);
+			}
+		}
+	}
+#endif
+	for (; i < count; i++)
+		integrate_motion(motions[i], delta_time);
+}
@@ -4,14 +4,45 @@
 #include "tinyECS/tiny_ecs.hpp"
 #include "tinyECS/components.hpp"
 #include "tinyECS/registry.hpp"
+#include "world.hpp"
+#include "dynamic_grid.hpp"
+#include "sat_batch.hpp"
+
+#include <array>
+#include <vector>
 
 // A simple physics system that moves rigid bodies and checks for collision
-class PhysicsSystem
+class PhysicsSystem : public GameSystem
 {
 public:
+	// Connects the spatial hash to the static collidables
+	void init();
+
 	void step(float elapsed_ms);
 
-	PhysicsSystem()
+	using GameSystem::GameSystem;
+
+private:
+	// A moving circle body as it is at the start of the collision checks
+	struct MovingCircleBody
 	{
-	}
+		Entity entity;
+		Motion* motion;
+		CircleBound* bound;
+		vec2 center;
+	};
+
+	// Moving bodies of the current frame: the circles first, followed by the SAT bodies in group order
+	DynamicGrid moving_grid;
+	std::vector<MovingCircleBody> moving_circles;
+
+	// statics near the body being checked, reused by every query of the spatial hash
+	std::vector<Entity> static_candidates;
+	// shapes of static_candidates, tested against the body four at a time
+	StaticBatch static_batch;
+
+	// per entity index, where every projectile was before the step moved it
+	std::vector<vec2> sweep_starts;
+	// per SAT body, the static a swept projectile stopped at
+	std::vector<Entity> swept_statics;
 };
\ No newline at end of file
@@ -1,4 +1,7 @@
 #include "physics_system_init.hpp"
+#include "sat_batch.hpp"
+#include <algorithm>
+#include <limits>
 
 ivec2 world_pos_to_hash_cell(SpatialHash& hash, vec2 pos) {
 	float cell_size = hash.cell_size;
@@ -11,73 +14,311 @@ ivec2 world_pos_to_hash_cell(SpatialHash& hash, vec2 pos) {
     return {x, y};
 }
 
-std::vector<ivec2> get_cells_for_entity(SpatialHash& hash, const Motion& motion) {
-	std::vector<ivec2> cells;
-	
+std::pair<ivec2, ivec2> get_cells_for_entity(SpatialHash& hash, const Motion& motion) {
 	ivec2 top_left = world_pos_to_hash_cell(hash, { motion.position.x - motion.scale.x / 2., motion.position.y - motion.scale.y / 2. });
 	ivec2 bottom_right = world_pos_to_hash_cell(hash, 
 		{ motion.position.x + motion.scale.x / 2.,
 		motion.position.y + motion.scale.y / 2. }
 	);
-	
+	return { top_left, bottom_right };
+}
+
+static uint32_t cell_index(const SpatialHash& hash, int x, int y) {
+	return (uint32_t)(y * hash.width + x);
+}
+
+// Caches the shape of a static and remembers its cells, to take it out again. The cells cover the bounds of the
+// shape, which is what the collision tests and sweep_statics test, so a collider offset past its Motion is still found
+static std::pair<ivec2, ivec2> track_static(SpatialHash& hash, Entity static_entity, const Motion& motion) {
+	if (hash.static_cells.size() <= static_entity.index()) {
+		hash.static_cells.resize(static_entity.index() + 1);
+		hash.query_stamps.resize(static_entity.index() + 1, 0);
+		hash.shapes.resize(static_entity.index() + 1);
+	}
+	AABB* aabb = registry().AABBs.find(static_entity);
+	StaticShape& shape = hash.shapes[static_entity.index()];
+	shape = make_static_shape(motion, aabb ? *aabb : AABB());
+	vec2 bounds_min = aabb ? shape.box_min : motion.position - motion.scale / 2.f;
+	vec2 bounds_max = aabb ? shape.box_max : motion.position + motion.scale / 2.f;
+	ivec2 top_left = world_pos_to_hash_cell(hash, bounds_min);
+	ivec2 bottom_right = world_pos_to_hash_cell(hash, bounds_max);
+	hash.static_cells[static_entity.index()] = { top_left, bottom_right, true };
+	return { top_left, bottom_right };
+}
+
+// Moves the rows apart so that every row has ROW_SLACK free slots again, the entries keep their order
+static void regrow_rows(SpatialHash& hash) {
+	std::vector<Entity> old_entities = std::move(hash.cell_entities);
+	std::vector<uint32_t> old_start = hash.cell_start;
+	uint32_t cell_count = (uint32_t)hash.cell_count.size();
+	uint32_t total = 0;
+	for (uint32_t c = 0; c < cell_count; c++) {
+		hash.cell_start[c] = total;
+		total += hash.cell_count[c] + SpatialHash::ROW_SLACK;
+	}
+	hash.cell_start[cell_count] = total;
+	hash.cell_entities.assign(total, Entity());
+	for (uint32_t c = 0; c < cell_count; c++) {
+		std::copy(old_entities.begin() + old_start[c], old_entities.begin() + old_start[c] + hash.cell_count[c], hash.cell_entities.begin() + hash.cell_start[c]);
+	}
+}
+
+// Puts a static into every cell its shape covers, behind the statics already there
+static void insert_static(SpatialHash& hash, Entity static_entity, const Motion& motion) {
+	auto [top_left, bottom_right] = track_static(hash, static_entity, motion);
 	for (int x = top_left.x; x <= bottom_right.x; ++x) {
 		for (int y = top_left.y; y <= bottom_right.y; ++y) {
-			cells.push_back({x, y});
+			uint32_t c = cell_index(hash, x, y);
+			if (hash.cell_start[c] + hash.cell_count[c] == hash.cell_start[c + 1]) {
+				regrow_rows(hash);
+			}
+			hash.cell_entities[hash.cell_start[c] + hash.cell_count[c]++] = static_entity;
 		}
 	}
-	
-	return cells;
 }
 
+// Lays out the rows of all statics in one counting sort: count the entries of every cell, turn the counts into
+// row starts, then fill the rows. A cell lists its statics in the order of registry().staticCollidables
 void add_statics_to_hash(SpatialHash& hash) {
-	for (Entity static_entity : registry.staticCollidables.entities) {
-		Motion& motion = registry.motions.get(static_entity);
-		std::vector<ivec2> cells = get_cells_for_entity(hash, motion);
-		for (auto& cell : cells) {
-			hash.grid[cell.y][cell.x].push_back(static_entity);
+	uint32_t cell_count = (uint32_t)(hash.width * hash.height);
+	hash.cell_count.assign(cell_count, 0);
+	for (Entity static_entity : registry().staticCollidables.entities) {
+		auto [top_left, bottom_right] = track_static(hash, static_entity, registry().motions.get(static_entity));
+		for (int x = top_left.x; x <= bottom_right.x; ++x) {
+			for (int y = top_left.y; y <= bottom_right.y; ++y) {
+				hash.cell_count[cell_index(hash, x, y)]++;
+			}
+		}
+	}
+
+	hash.cell_start.resize(cell_count + 1);
+	uint32_t total = 0;
+	for (uint32_t c = 0; c < cell_count; c++) {
+		hash.cell_start[c] = total;
+		total += hash.cell_count[c] + SpatialHash::ROW_SLACK;
+	}
+	hash.cell_start[cell_count] = total;
+	hash.cell_entities.assign(total, Entity());
+
+	std::fill(hash.cell_count.begin(), hash.cell_count.end(), 0);
+	for (Entity static_entity : registry().staticCollidables.entities) {
+		const SpatialHash::StaticCells& cells = hash.static_cells[static_entity.index()];
+		for (int x = cells.first.x; x <= cells.last.x; ++x) {
+			for (int y = cells.first.y; y <= cells.last.y; ++y) {
+				uint32_t c = cell_index(hash, x, y);
+				hash.cell_entities[hash.cell_start[c] + hash.cell_count[c]++] = static_entity;
+			}
 		}
 	}
 }
 
-std::vector<Entity> get_potential_collisions(SpatialHash& hash, Entity entity, Motion& motion) {
-	std::vector<Entity> candidates;
-	candidates.reserve(10);
-	std::unordered_map<Entity, bool, EntityHash> visited;
+void add_static_to_hash(Entity entity) {
+	Motion* motion = registry().motions.find(entity);
+	if (registry().spatialHashes.size() == 0 || !motion) {
+		return;
+	}
+	insert_static(registry().spatialHashes.components[0], entity, *motion);
+}
 
-	std::vector<ivec2> cells = get_cells_for_entity(hash, motion);
+void remove_static_from_hash(Entity entity) {
+	if (registry().spatialHashes.size() == 0) {
+		return;
+	}
+	SpatialHash& hash = registry().spatialHashes.components[0];
+	if (entity.index() >= hash.static_cells.size() || !hash.static_cells[entity.index()].in_hash) {
+		return;
+	}
+	SpatialHash::StaticCells& cells = hash.static_cells[entity.index()];
+	for (int x = cells.first.x; x <= cells.last.x; ++x) {
+		for (int y = cells.first.y; y <= cells.last.y; ++y) {
+			uint32_t c = cell_index(hash, x, y);
+			Entity* row = hash.cell_entities.data() + hash.cell_start[c];
+			Entity* row_end = row + hash.cell_count[c];
+			Entity* found = std::find(row, row_end, entity);
+			if (found != row_end) {
+				std::copy(found + 1, row_end, found);
+				hash.cell_count[c]--;
+			}
+		}
+	}
+	cells.in_hash = false;
+}
+
+// Starts a new query, statics marked with the returned stamp have been seen by it
+static uint32_t next_query_stamp(SpatialHash& hash) {
+	if (++hash.query_stamp == 0) {
+		std::fill(hash.query_stamps.begin(), hash.query_stamps.end(), 0);
+		hash.query_stamp = 1;
+	}
+	return hash.query_stamp;
+}
 
-	for (const auto& cell : cells) {
-		std::vector<Entity> entities = get_entities_in_cell(hash, cell);
-		for (Entity& other_entity : entities) {
-			if (other_entity == entity || visited[other_entity]) {
-				continue;
+void get_potential_collisions(SpatialHash& hash, Entity entity, const Motion& motion, std::vector<Entity>& candidates) {
+	candidates.clear();
+	next_query_stamp(hash);
+
+	auto [top_left, bottom_right] = get_cells_for_entity(hash, motion);
+	for (int x = top_left.x; x <= bottom_right.x; ++x) {
+		for (int y = top_left.y; y <= bottom_right.y; ++y) {
+			for (Entity other_entity : get_entities_in_cell(hash, { x, y })) {
+				uint32_t& stamp = hash.query_stamps[other_entity.index()];
+				if (other_entity == entity || stamp == hash.query_stamp) {
+					continue;
+				}
+				candidates.push_back(other_entity);
+				stamp = hash.query_stamp;
 			}
-			
-			candidates.push_back(other_entity);
-			visited[other_entity] = true;
 		}
+	}
+}
+
+CellEntities get_entities_in_cell(SpatialHash& hash, ivec2 pos) {
+	uint32_t c = cell_index(hash, pos.x, pos.y);
+	const Entity* row = hash.cell_entities.data() + hash.cell_start[c];
+	return { row, row + hash.cell_count[c] };
+}
 
+// Where the segment start + t * delta first comes within radius of the box of a static, tested on the two axes of the box
+static bool sweep_static_shape(const StaticShape& shape, vec2 start, vec2 delta, float radius, float& t) {
+	vec2 axes[2] = { shape.unit_normals[0], shape.unit_normals[1] };
+	// a box without width or height has a zero normal, the axes are at right angles anyway
+	if (axes[0] == vec2(0.f)) {
+		axes[0] = axes[1] == vec2(0.f) ? vec2(0.f, 1.f) : vec2(axes[1].y, -axes[1].x);
 	}
-	return candidates;
+	if (axes[1] == vec2(0.f)) {
+		axes[1] = vec2(-axes[0].y, axes[0].x);
+	}
+
+	float t_enter = 0.f;
+	float t_exit = 1.f;
+	for (const vec2& axis : axes) {
+		float min = dot(shape.corners[0], axis);
+		float max = min;
+		for (int c = 1; c < 4; c++) {
+			float projection = dot(shape.corners[c], axis);
+			min = std::min(min, projection);
+			max = std::max(max, projection);
+		}
+		min -= radius;
+		max += radius;
+
+		float from = dot(start, axis);
+		float speed = dot(delta, axis);
+		if (speed == 0.f) {
+			if (from < min || max < from) {
+				return false;
+			}
+			continue;
+		}
+		float t0 = (min - from) / speed;
+		float t1 = (max - from) / speed;
+		if (t0 > t1) {
+			std::swap(t0, t1);
+		}
+		t_enter = std::max(t_enter, t0);
+		t_exit = std::min(t_exit, t1);
+		if (t_enter > t_exit) {
+			return false;
+		}
+	}
+	t = t_enter;
+	return true;
 }
 
-std::vector<Entity> get_entities_in_cell(SpatialHash& hash, ivec2 pos) {
-	return hash.grid[pos.y][pos.x];
+bool sweep_statics(SpatialHash& hash, vec2 start, vec2 end, float radius, Entity& hit, float& hit_t) {
+	hit = Entity();
+	hit_t = 1.f;
+	if (hash.width <= 0 || hash.height <= 0) {
+		return false;
+	}
+	uint32_t stamp = next_query_stamp(hash);
+
+	float cell_size = hash.cell_size;
+	vec2 delta = end - start;
+	ivec2 cell = { (int)std::floor(start.x / cell_size), (int)std::floor(start.y / cell_size) };
+	ivec2 step = { delta.x > 0 ? 1 : -1, delta.y > 0 ? 1 : -1 };
+	// t where the segment crosses the next cell border on each axis, and the t from one border to the next
+	vec2 t_next = vec2(std::numeric_limits<float>::infinity());
+	vec2 t_step = vec2(std::numeric_limits<float>::infinity());
+	for (int axis = 0; axis < 2; axis++) {
+		if (delta[axis] == 0.f) {
+			continue;
+		}
+		float border = (cell[axis] + (step[axis] > 0 ? 1 : 0)) * cell_size;
+		t_next[axis] = (border - start[axis]) / delta[axis];
+		t_step[axis] = cell_size / std::abs(delta[axis]);
+	}
+	// a static touched by the body has a cell this close to the cell of the body's center
+	int reach = (int)std::ceil(radius / cell_size);
+
+	while (true) {
+		for (int y = cell.y - reach; y <= cell.y + reach; y++) {
+			for (int x = cell.x - reach; x <= cell.x + reach; x++) {
+				// statics outside the map are kept in the border cells
+				ivec2 pos = { std::max(0, std::min(x, hash.width - 1)), std::max(0, std::min(y, hash.height - 1)) };
+				for (Entity other_entity : get_entities_in_cell(hash, pos)) {
+					uint32_t& seen = hash.query_stamps[other_entity.index()];
+					if (seen == stamp) {
+						continue;
+					}
+					seen = stamp;
+					float t;
+					if (sweep_static_shape(hash.shapes[other_entity.index()], start, delta, radius, t) && (hit.is_null() || t < hit_t)) {
+						hit = other_entity;
+						hit_t = t;
+					}
+				}
+			}
+		}
+
+		// statics not seen yet are touched after the segment leaves this cell, if at all
+		float cell_exit = std::min(t_next.x, t_next.y);
+		if ((!hit.is_null() && hit_t <= cell_exit) || cell_exit >= 1.f) {
+			break;
+		}
+		if (t_next.x < t_next.y) {
+			cell.x += step.x;
+			t_next.x += t_step.x;
+		}
+		else {
+			cell.y += step.y;
+			t_next.y += t_step.y;
+		}
+	}
+	return !hit.is_null();
 }
 
 void clear_and_set_spatial_hash() {
-	while (!registry.spatialHashes.entities.empty()) {
-		registry.remove_all_components_of(registry.spatialHashes.entities.back());
+	while (!registry().spatialHashes.entities.empty()) {
+		registry().destroy(registry().spatialHashes.entities.back());
 	}
-	if (registry.maps.size() == 0) {
+	if (registry().maps.size() == 0) {
 		return;
 	}
 
-	int current_level = registry.gameProgress.components[0].level;
-	Map& map = registry.maps.components[current_level];
-	SpatialHash& hash = registry.spatialHashes.emplace(Entity());
+	int current_level = registry().gameProgress.components[0].level;
+	Map& map = registry().maps.components[current_level];
+	SpatialHash& hash = registry().spatialHashes.emplace(registry().create());
 	hash.height = std::ceil((map.grid_height) * GRID_CELL_SIZE) / hash.cell_size;
 	hash.width = std::ceil((map.grid_width) * GRID_CELL_SIZE) / hash.cell_size;
-	hash.grid.resize(hash.height, std::vector<std::vector<Entity>>(hash.width));
 	add_statics_to_hash(hash);
 }
+
+void update_spatial_hash() {
+	if (registry().spatialHashes.size() == 0) {
+		clear_and_set_spatial_hash();
+	}
+}
+
+void freeze_static_bodies(const std::vector<Entity>& entities) {
+	for (Entity entity : entities) {
+		Motion* motion = registry().motions.find(entity);
+		if (!motion || motion->velocity != vec2(0.f) || motion->angle_velocity != 0.f) {
+			continue;
+		}
+		// normalize the angle once, the same way integration would every frame
+		motion->angle = (int)motion->angle % 360;
+		if (motion->angle < 0) motion->angle += 360;
+		registry().motions.freeze(entity);
+	}
+}
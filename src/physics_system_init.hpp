@@ -5,12 +5,43 @@
 
 ivec2 world_pos_to_hash_cell(SpatialHash& hash, vec2 pos);
 
-std::vector<ivec2> get_cells_for_entity(SpatialHash& hash, const Motion& motion);
+// First and last cell covered by the Motion
+std::pair<ivec2, ivec2> get_cells_for_entity(SpatialHash& hash, const Motion& motion);
 
-std::vector<Entity> get_potential_collisions(SpatialHash& hash, Entity entity, Motion& motion);
+// Replaces the contents of candidates with the statics sharing a cell with the Motion, each once and in cell order.
+// Does not allocate once candidates and the hash have grown to size, so pass the same buffer every frame.
+// Queries mark the statics they see in the hash, so only one query can run on a hash at a time
+void get_potential_collisions(SpatialHash& hash, Entity entity, const Motion& motion, std::vector<Entity>& candidates);
 
+// Builds the rows of the hash from all statics, the size of the hash has to be set
 void add_statics_to_hash(SpatialHash& hash);
 
-std::vector<Entity> get_entities_in_cell(SpatialHash& hash, ivec2 pos);
+// Listeners of registry().staticCollidables, keep the spatial hash up to date when a single static is added or removed
+void add_static_to_hash(Entity entity);
+void remove_static_from_hash(Entity entity);
+
+// The statics of one cell, points into the rows of the hash until the next static is added
+struct CellEntities {
+	const Entity* first;
+	const Entity* last;
+
+	const Entity* begin() const { return first; }
+	const Entity* end() const { return last; }
+	size_t size() const { return last - first; }
+};
+
+CellEntities get_entities_in_cell(SpatialHash& hash, ivec2 pos);
+
+// Finds the first static that a body of the given radius touches while moving from start to end, for bodies too fast
+// for the overlap tests. Walks the cells of the hash along the segment (Amanatides and Woo), so the cost grows with the
+// cells crossed and the result does not depend on the frame time. hit_t is how far along the segment the static is touched,
+// 0 at start and 1 at end. Marks the statics it sees like get_potential_collisions()
+bool sweep_statics(SpatialHash& hash, vec2 start, vec2 end, float radius, Entity& hit, float& hit_t);
 
 void clear_and_set_spatial_hash();
+
+// Builds the spatial hash if there is none, changes after that are applied by the listeners above
+void update_spatial_hash();
+
+// Moves the motions of bodies that never move to the frozen tail of registry().motions so integration skips them
+void freeze_static_bodies(const std::vector<Entity>& entities);
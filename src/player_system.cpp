@@ -1,6 +1,9 @@
 #include "player_system.hpp"
 #include "tinyECS/tiny_ecs.hpp"
 #include "tinyECS/registry.hpp"
+#include "world.hpp"
+#include "map_system.hpp"
+#include "ui_system.hpp"
 #include "tinyECS/components.hpp"
 #include "input_system.hpp"
 #include "world_init.hpp"
@@ -17,11 +20,11 @@
 #include <physics_system_init.hpp>
 
 bool PlayerSystem::step(float elapsed_ms) {
-	if (registry.players.entities.empty()) {
+	if (registry().players.entities.empty()) {
 		return false;
 	}
 
-	if (world->get_game_state() == GameState::TITLE_SCREEN || world->get_game_state() == GameState::CINEMATIC) {
+	if (world_system->get_game_state() == GameState::TITLE_SCREEN || world_system->get_game_state() == GameState::CINEMATIC) {
 		update_crosshair_position();
 		return false;
 	}
@@ -32,7 +35,7 @@ bool PlayerSystem::step(float elapsed_ms) {
 	update_camera_position(elapsed_ms);
 	update_crosshair_position();
 	handle_melee();
-	if (registry.guns.has(player)) {
+	if (registry().guns.has(player)) {
 		handleShooting();
 		handle_reload();
 	}
@@ -42,67 +45,67 @@ bool PlayerSystem::step(float elapsed_ms) {
 }
 
 void PlayerSystem::updatePlayerRotation() {
-	auto& player_motion = registry.motions.get(player);
+	auto& player_motion = registry().motions.get(player);
 	vec2 player_dcs_pos = this->renderer->wcs_to_dcs(player_motion.position);
 
-	auto& inputs = registry.inputs.get(registry.inputs.entities[0]);
+	auto& inputs = registry().inputs.get(registry().inputs.entities[0]);
 	vec2 mouse_dir = inputs.mouse_pos - player_dcs_pos;
 	float angle = glm::degrees(atan2(mouse_dir.y, mouse_dir.x) + M_PI);
 	player_motion.angle = angle;
 
 	// Update laser
-	auto& laser_motion = registry.motions.get(laser);
+	auto& laser_motion = registry().motions.get(laser);
 	laser_motion.angle = angle + 180;
 	laser_motion.position = get_laser_position();
 }
 
-void PlayerSystem::init(RenderSystem* renderer, AudioSystem* audio, WorldSystem* world, GLFWwindow* window) {
+void PlayerSystem::init(RenderSystem* renderer, AudioSystem* audio, WorldSystem* world_system, GLFWwindow* window) {
 	this->renderer = renderer;
 	this->audio = audio;
-	this->world = world;
+	this->world_system = world_system;
 	this->window = window;
 
 	Entity player_entity = createPlayer(grid_to_world_coord(16, 78));
 	create_laser();
 	create_crosshair();
 	create_gun(player_entity, GUN_TYPE::PISTOL);
-	registry.walkSoundTimers.emplace(player_entity);
+	registry().walkSoundTimers.emplace(player_entity);
 }
 
 Entity PlayerSystem::createPlayer(vec2 position) {
-	if (!registry.players.entities.empty()) {
-		registry.players.clear();
+	if (!registry().players.entities.empty()) {
+		registry().players.clear();
 	}
 
-	Entity entity = Entity();
-	Player& player = registry.players.emplace(entity);
+	Entity entity = registry().create();
+	Player& player = registry().players.emplace(entity);
 	player.speed = GRID_CELL_SIZE * 5;
 	player.health = STARTING_PLAYER_HEALTH / 2;
 
 	this->player = entity;
 
 	Mesh& mesh = renderer->getMesh(GEOMETRY_BUFFER_ID::SPRITE);
-	registry.meshPtrs.emplace(entity, &mesh);
+	registry().meshPtrs.emplace(entity, &mesh);
 
-	auto& playerMotion = registry.motions.emplace(entity);
+	auto& playerMotion = registry().motions.emplace(entity);
 	playerMotion.position = position;
 	playerMotion.angle = 0.0f;
 	playerMotion.velocity = glm::vec2(0.0f, 0.0f);
 	playerMotion.scale = glm::vec2(GRID_CELL_SIZE * 2.8, GRID_CELL_SIZE * 2.8);
 
-	registry.movingCollidables.emplace(entity);
-	registry.movingCircleCollidables.emplace(entity);
-	Collidable& collidable = registry.collidables.emplace(entity);
-	CircleBound& circle_bound = registry.circlebounds.emplace(entity);
+	registry().movingCollidables.emplace(entity);
+	registry().movingCircleCollidables.emplace(entity);
+	Collidable& collidable = registry().collidables.emplace(entity);
+	CircleBound& circle_bound = registry().circlebounds.emplace(entity);
 	circle_bound.collision_radius = GRID_CELL_SIZE / 2.;
 	circle_bound.offset = { 0.f, 0.f };
 
-	Dash& dash = registry.dashes.emplace(entity);
+	Dash& dash = registry().dashes.emplace(entity);
 	dash.dash_speed = GRID_CELL_SIZE * 17;
 
-	Melee& melee = registry.melees.emplace(entity);
+	Melee& melee = registry().melees.emplace(entity);
 
-	RenderRequest& render = registry.renderRequests.emplace(entity, RenderRequest{
+	RenderRequest& render = registry().renderRequests.emplace(entity, RenderRequest{
 		TEXTURE_ASSET_ID::PLAYER_SHOOTING_PISTOL,
 		EFFECT_ASSET_ID::TEXTURED,
 		GEOMETRY_BUFFER_ID::SPRITE,
@@ -113,33 +116,33 @@ Entity PlayerSystem::createPlayer(vec2 position) {
 	render.outline_color_a = vec3(0.0, 0.75, 0.65);
 	render.outline_color_b = vec3(0.0, 1.0, 0.9);
 
-	 Entity camera_entity = registry.cameras.entities[0];
-	 Motion& camera_motion = registry.motions.get(camera_entity);
+	 Entity camera_entity = registry().cameras.entities[0];
+	 Motion& camera_motion = registry().motions.get(camera_entity);
 	 camera_motion.position = playerMotion.position;
 
 	return entity;
 }
 
 Entity PlayerSystem::create_laser() {
-	if (!registry.lasers.entities.empty()) {
-		registry.lasers.clear();
+	if (!registry().lasers.entities.empty()) {
+		registry().lasers.clear();
 	}
 
-	Entity entity = Entity();
-	Laser& laser = registry.lasers.emplace(entity);
+	Entity entity = registry().create();
+	Laser& laser = registry().lasers.emplace(entity);
 
 	this->laser = entity;
 
 	Mesh& mesh = renderer->getMesh(GEOMETRY_BUFFER_ID::SPRITE);
-	registry.meshPtrs.emplace(entity, &mesh);
+	registry().meshPtrs.emplace(entity, &mesh);
 
-	auto& playerMotion = registry.motions.emplace(entity);
+	auto& playerMotion = registry().motions.emplace(entity);
 	playerMotion.position = get_laser_position();
 	playerMotion.angle = 0.0f;
 	playerMotion.velocity = glm::vec2(0.0f, 0.0f);
 	playerMotion.scale = glm::vec2(200.0f, 200.0f);
 
-	registry.renderRequests.emplace(entity, RenderRequest{
+	registry().renderRequests.emplace(entity, RenderRequest{
 		TEXTURE_ASSET_ID::LASER,
 		EFFECT_ASSET_ID::TEXTURED, 
 		GEOMETRY_BUFFER_ID::SPRITE,
@@ -149,15 +152,15 @@ Entity PlayerSystem::create_laser() {
 }
 
 void PlayerSystem::create_crosshair() {
-	Entity entity = Entity();
+	Entity entity = registry().create();
 	this->crosshair = entity;
 
-	auto& crosshair_motion = registry.motions.emplace(entity);
+	auto& crosshair_motion = registry().motions.emplace(entity);
 	crosshair_motion.position = {200, 200};
 	crosshair_motion.scale = glm::vec2(20.0f, 20.0f);
 
-	registry.uis.emplace(entity);
-	registry.renderRequests.emplace(entity, RenderRequest{
+	registry().uis.emplace(entity);
+	registry().renderRequests.emplace(entity, RenderRequest{
 		TEXTURE_ASSET_ID::CROSSHAIR,
 		EFFECT_ASSET_ID::TEXTURED, 
 		GEOMETRY_BUFFER_ID::SPRITE,
@@ -167,8 +170,8 @@ void PlayerSystem::create_crosshair() {
 }
 
 void PlayerSystem::progress_timers(float elapsed_ms) {
-	if (registry.guns.has(this->player)) {
-		auto& gun = registry.guns.get(this->player);
+	if (registry().guns.has(this->player)) {
+		auto& gun = registry().guns.get(this->player);
 		if (gun.cooldown_timer_ms > 0) {
 			gun.cooldown_timer_ms = gun.cooldown_timer_ms - elapsed_ms;
 		}
@@ -178,18 +181,18 @@ void PlayerSystem::progress_timers(float elapsed_ms) {
 		}
 	}
 	
-	auto& walkSoundTimer = registry.walkSoundTimers.get(this->player);
+	auto& walkSoundTimer = registry().walkSoundTimers.get(this->player);
 	if (walkSoundTimer.counter_ms > 0) {
 		walkSoundTimer.counter_ms = max(0.0f, walkSoundTimer.counter_ms - elapsed_ms);
 	}
 
-	auto& meleeTimer = registry.melees.get(this->player);
+	auto& meleeTimer = registry().melees.get(this->player);
 	if (meleeTimer.counter_ms > 0) {
 		meleeTimer.counter_ms = max(0.0f, meleeTimer.counter_ms - elapsed_ms);
 	}
 
-	auto& dash_timer = registry.dashes.get(this->player);
-	auto& player_component = registry.players.get(this->player);
+	auto& dash_timer = registry().dashes.get(this->player);
+	auto& player_component = registry().players.get(this->player);
 	// Reduce invincibility timer
 	if (dash_timer.invincibility_timer_ms > 0.0f) {
 		dash_timer.invincibility_timer_ms = dash_timer.invincibility_timer_ms - elapsed_ms;
@@ -201,6 +204,7 @@ void PlayerSystem::progress_timers(float elapsed_ms) {
 	// Reduce cooldown timer
 	if (dash_timer.cooldown_timer > 0.0f) {
 		dash_timer.cooldown_timer = dash_timer.cooldown_timer - elapsed_ms;
+		registry().dashes.mark_changed(this->player);
 	}
 
 	if (dash_timer.ghost_timer_ms > 0.f) {
@@ -212,21 +216,21 @@ void PlayerSystem::progress_timers(float elapsed_ms) {
 	}
 
 
-	if (registry.reloads.has(player)) {
-		Reload& reload = registry.reloads.get(player);
+	if (registry().reloads.has(player)) {
+		Reload& reload = registry().reloads.get(player);
 		reload.remaining_time -= elapsed_ms;
 	}
 }
 
 void PlayerSystem::handle_melee() {
-	auto& input = registry.inputs.get(registry.inputs.entities[0]);
+	auto& input = registry().inputs.get(registry().inputs.entities[0]);
 
 	// Shoot projectile if left button is pressed
 	if (!input.keys[GLFW_KEY_F] && !input.keys[GLFW_KEY_LEFT_SHIFT]) {
 		return;
 	}
 
-	Melee& melee = registry.melees.get(player);
+	Melee& melee = registry().melees.get(player);
 	if (melee.counter_ms <= melee.melee_cooldown_ms - melee.melee_hit_ms) {
 		melee.is_melee = false;
 	}
@@ -244,14 +248,14 @@ void PlayerSystem::handle_melee() {
 	melee.melee_cooldown = true;
 	melee.counter_ms = melee.melee_cooldown_ms;
 
-	Motion& motion = registry.motions.get(player);
+	Motion& motion = registry().motions.get(player);
 	audio->play_sound(SOUND_ASSET_ID::SLASH, 40);
 
 	// Melee Animation
 	create_animation(
 		motion.position, motion.velocity, { 300.0f, 200.0f },
 		motion.angle + 180,
-		std::vector<TEXTURE_ASSET_ID>{TEXTURE_ASSET_ID::SLASH_0, TEXTURE_ASSET_ID::SLASH_1, TEXTURE_ASSET_ID::SLASH_2, TEXTURE_ASSET_ID::SLASH_3},
+		SLASH_CLIP,
 		true, false, 50.0f, Z_INDEX::MUZZLE_FLASH);
 
 	// Melee Hit Detection
@@ -260,8 +264,8 @@ void PlayerSystem::handle_melee() {
 
 
 	// code to check if projectiles hit door. Refactor to check if melee hits doors
-	int current_level = registry.gameProgress.components[0].level;
-	Map& map = registry.maps.components[current_level];
+	int current_level = registry().gameProgress.components[0].level;
+	Map& map = registry().maps.components[current_level];
 
 	for (auto it = map.prop_doors_list.begin(); it != map.prop_doors_list.end(); ) {
 		vec2 door_loc = grid_to_world_coord(it->x, it->y);
@@ -290,14 +294,6 @@ void PlayerSystem::handle_melee() {
 		auto door_it = map.prop_doors.find(*it);
 		if (door_it != map.prop_doors.end()) {
 			Entity entity = door_it->second;
-			Entity entity2;
-			for (auto& pair : map.prop_doors_pair) {
-				if (pair.first == entity) {
-					entity2 = pair.second.back();
-					break;
-				}
-			}
-
 			Prop prop1 = map.props[door_it->first];
 
 			vec2 away_from_player = normalize(door_loc - motion.position);
@@ -306,18 +302,18 @@ void PlayerSystem::handle_melee() {
 
 			audio->play_sound(SOUND_ASSET_ID::DOOR_BREAKING, 20);
 
-			// Remove from all relevant maps
+			// Remove from the layout, map.prop_doors follows the destroyed entity (see MapSystem::on_door_destroyed)
 			map.props.erase(*it);
-			registry.remove_all_components_of(entity);
-			registry.remove_all_components_of(entity2);
-			clear_and_set_spatial_hash();
+			// the second leaf is a child of the door and goes with it
+			registry().destroy(entity);
+			// the door leaves the spatial hash right away, see remove_static_from_hash
 		}
 
 		it = map.prop_doors_list.erase(it);
 	}
 
-	for (Entity enemy : registry.enemies.entities) {
-		Motion& enemy_motion = registry.motions.get(enemy);
+	for (Entity enemy : registry().enemies.entities) {
+		Motion& enemy_motion = registry().motions.get(enemy);
 
 		// Vector from player to enemy
 		vec2 delta_pos = enemy_motion.position - motion.position;
@@ -337,23 +333,23 @@ void PlayerSystem::handle_melee() {
 		if (std::abs(enemy_angle) <= melee_half_angle || std::abs(delta_position.x) <= delta_difference && std::abs(delta_position.y) <= delta_difference) {
 			//std::cout << "MELEE HIT!" << std::endl;
 
-			auto& enemy_comp = registry.enemies.get(enemy);
+			auto& enemy_comp = registry().enemies.get(enemy);
 
 			enemy_comp.health -= melee.melee_damage;
 
 			if (enemy_comp.health <= 0) {
 				SOUND_ASSET_ID random_enemy_hit_sound = static_cast<SOUND_ASSET_ID>(get_rand(static_cast<int>(SOUND_ASSET_ID::ENEMY_HIT_1), static_cast<int>(SOUND_ASSET_ID::ENEMY_HIT_8)));
 				audio->play_sound(random_enemy_hit_sound, 5);
-				registry.guns.remove(enemy);
+				registry().guns.remove(enemy);
 				create_dead_enemy(enemy_motion.position, enemy_motion.angle);
 				spawn_pickup(enemy_motion.position, 0, PICKUP_TYPE::GUN, 10, GUN_TYPE::PISTOL);
 
-				registry.remove_all_components_of(enemy);
+				registry().destroy(enemy);
 
-				if (registry.enemies.size() - registry.tutorialEnemies.size() <= 0) {
+				if (registry().enemies.size() - registry().tutorialEnemies.size() <= 0) {
 					// TODO: Why do we do this check in two places
 					std::cout << "Level cleared" << std::endl;
-					registry.map_system->load_next_map();
+					::world().map_system->load_next_map();
 				}
 			}
 			else {
@@ -365,16 +361,7 @@ void PlayerSystem::handle_melee() {
 				enemy_motion.velocity,
 				{ 150.f, 150.f },
 				motion.angle + 90.f,
-				std::vector<TEXTURE_ASSET_ID>{
-				TEXTURE_ASSET_ID::BLOOD_SPLATTER_0,
-					TEXTURE_ASSET_ID::BLOOD_SPLATTER_1,
-					TEXTURE_ASSET_ID::BLOOD_SPLATTER_2,
-					TEXTURE_ASSET_ID::BLOOD_SPLATTER_3,
-					TEXTURE_ASSET_ID::BLOOD_SPLATTER_4,
-					TEXTURE_ASSET_ID::BLOOD_SPLATTER_5,
-					TEXTURE_ASSET_ID::BLOOD_SPLATTER_6,
-					TEXTURE_ASSET_ID::BLOOD_SPLATTER_7,
-			},
+				BLOOD_SPLATTER_CLIP,
 				true,
 				false,
 				50.0f,
@@ -385,34 +372,34 @@ void PlayerSystem::handle_melee() {
 }
 
 void PlayerSystem::handleShooting() {
-	auto& input = registry.inputs.get(registry.inputs.entities[0]);
+	auto& input = registry().inputs.get(registry().inputs.entities[0]);
 
 	// Shoot projectile if left button is pressed
 	if (!input.keys[GLFW_MOUSE_BUTTON_LEFT] && !input.key_down_events[GLFW_MOUSE_BUTTON_RIGHT]) {
 		return;
 	}
 
-	if (!registry.guns.has(player)) {
+	if (!registry().guns.has(player)) {
 		return;
 	}
 
-	auto& gun = registry.guns.get(player);
+	auto& gun = registry().guns.get(player);
 
 	if (input.key_down_events[GLFW_MOUSE_BUTTON_RIGHT]) {
 		if (gun.throw_timer_ms > 0.f) {
 			return;
 		}
-		auto& player_motion = registry.motions.get(player);
+		auto& player_motion = registry().motions.get(player);
 		vec2 player_dcs_pos = this->renderer->wcs_to_dcs(player_motion.position);
 		vec2 mouse_dir = normalize(input.mouse_pos - player_dcs_pos);
 		vec2 projectile_velocity = mouse_dir * 1000.f;
 		vec2 gun_position = get_gun_position();
 		Entity projectile_entity = createProjectile(gun_position, { GRID_CELL_SIZE * 0.75, GRID_CELL_SIZE * 0.75 }, projectile_velocity, player_motion.angle + 180.0f, 2.f, 
 			gun.damage * 5, true, gun.thrown_sprite, true);
-		Gun& new_gun = registry.guns.insert(projectile_entity, gun);
+		Gun& new_gun = registry().guns.insert(projectile_entity, gun);
 		new_gun.throw_timer_ms = new_gun.throw_cooldown_time;
-		registry.guns.remove(player);
-		registry.ui_system->update_gun_ui();
+		registry().guns.remove(player);
+		::world().ui_system->update_gun_ui();
 		return;
 	}
 
@@ -420,7 +407,7 @@ void PlayerSystem::handleShooting() {
 		return;
 	}
 
-	if (registry.reloads.has(player)) {
+	if (registry().reloads.has(player)) {
 		return;
 	}
 
@@ -428,16 +415,18 @@ void PlayerSystem::handleShooting() {
 
 	if (gun.current_magazine == 0) {
 		audio->play_sound(gun.click_effect, 50);
-		registry.inputs.components[0].key_down_events[GLFW_KEY_R] = true;
+		registry().inputs.components[0].key_down_events[GLFW_KEY_R] = true;
 		return;
 	}
 
 	gun.current_magazine--;
-	auto& player_motion = registry.motions.get(player);
+	registry().guns.mark_changed(player);
+	auto& player_motion = registry().motions.get(player);
 	vec2 player_dcs_pos = this->renderer->wcs_to_dcs(player_motion.position);
 	vec2 mouse_dir = normalize(input.mouse_pos - player_dcs_pos);
 	vec2 projectile_velocity = mouse_dir * gun.projectile_speed;
 	vec2 gun_position = get_gun_position();
+	float player_angle = player_motion.angle;
 
 	for (int i = 0; i < gun.projectile_count; i++) {
 		float spread_angle = 0.f;
@@ -461,7 +450,7 @@ void PlayerSystem::handleShooting() {
 			gun_position, 
 			{ 15, 15 }, 
 			projectile_velocity, 
-			player_motion.angle + 180.0f + spread_angle,
+			player_angle + 180.0f + spread_angle,
 			0.f, 
 			gun.damage, 
 			true, 
@@ -475,19 +464,20 @@ void PlayerSystem::handleShooting() {
 	// M1: creative element #23: Audio feedback
 	// Play gunshot sound when user shoots projectile  
 	audio->play_sound(gun.sound_effect, 15);
-	create_animation(gun_position, player_motion.velocity, {20.0f, 20.0f}, player_motion.angle + 180, std::vector<TEXTURE_ASSET_ID>{TEXTURE_ASSET_ID::MUZZLE_FLASH0, TEXTURE_ASSET_ID::MUZZLE_FLASH1, TEXTURE_ASSET_ID::MUZZLE_FLASH2},
+	// the new projectiles joined the moving SAT group, which moves Motions around, so the player's is looked up again
+	create_animation(gun_position, registry().motions.get(player).velocity, {20.0f, 20.0f}, player_angle + 180, MUZZLE_FLASH_CLIP,
 					 true, false, 50.0f, Z_INDEX::MUZZLE_FLASH);
     add_temp_light(gun_position, {1.0, 0.6, 0.2}, 200, 1.f, true, 100.f);
 
-	player_motion.velocity -= mouse_dir * GRID_CELL_SIZE * gun.recoil_pushback;
+	registry().motions.get(player).velocity -= mouse_dir * GRID_CELL_SIZE * gun.recoil_pushback;
 
 	// alert all enemies in the same room as the player
-	for (Entity& enemy : registry.enemies.entities) {
+	for (Entity& enemy : registry().enemies.entities) {
 		if (is_enemy_in_same_room_as_player(enemy)) {
-			registry.enemies.get(enemy).state = ENEMY_STATE::PURSUIT;
+			registry().enemies.get(enemy).state = ENEMY_STATE::PURSUIT;
 			// invalidate the cached path so a new path is computed
-			if (registry.pathComponents.has(enemy)) {
-				auto& pathComp = registry.pathComponents.get(enemy);
+			if (registry().pathComponents.has(enemy)) {
+				auto& pathComp = registry().pathComponents.get(enemy);
 				pathComp.valid = false;
 			}
 		}
@@ -496,11 +486,11 @@ void PlayerSystem::handleShooting() {
 
 // handles dashing mechanics
 void PlayerSystem::handle_dash(float elapsed_ms) {
-	auto& player_component = registry.players.get(player);
-	auto& player_motion = registry.motions.get(player);
-	auto& player_inputs = registry.inputs.get(registry.inputs.entities[0]);
-	auto& player_dash = registry.dashes.get(player);
-	auto& player_render = registry.renderRequests.get(player);
+	auto& player_component = registry().players.get(player);
+	auto& player_motion = registry().motions.get(player);
+	auto& player_inputs = registry().inputs.get(registry().inputs.entities[0]);
+	auto& player_dash = registry().dashes.get(player);
+	auto& player_render = registry().renderRequests.get(player);
 
 	float target_transparency = player_dash.invincibility_timer_ms > 0. ? 1.0f : 0.0f;
 	if (player_render.outline_transparency != target_transparency) {
@@ -533,15 +523,15 @@ void PlayerSystem::handle_dash(float elapsed_ms) {
 
 	if (player_dash.ghost_timer_ms > 0.f && player_dash.ghost_spawn_ms <= 0.f) {
 		float time_factor = player_dash.ghost_timer_ms / player_dash.ghost_duration;
-		Entity ghost_entity = Entity();
-		Motion& ghost_motion = registry.motions.insert(ghost_entity, player_motion);
+		Entity ghost_entity = registry().create();
+		Motion& ghost_motion = registry().motions.insert(ghost_entity, player_motion);
 		ghost_motion.velocity = { 0.f, 0.f };
-		RenderRequest& ghost_render = registry.renderRequests.insert(ghost_entity, player_render);
+		RenderRequest& ghost_render = registry().renderRequests.insert(ghost_entity, player_render);
 		ghost_render.outline_transparency = 0.;
 		float alpha = mix(0.3f, 0.1f, time_factor);
 		ghost_render.alpha = alpha;
 		ghost_render.z_index = Z_INDEX::PLAYER_DASH;
-		RemoveTimer& timer = registry.removeTimers.emplace(ghost_entity);
+		RemoveTimer& timer = registry().removeTimers.emplace(ghost_entity);
 		
 		const vec3 colors[] = {
 			vec3(0.0f, 1.0f, 0.624f),
@@ -556,7 +546,7 @@ void PlayerSystem::handle_dash(float elapsed_ms) {
 		int color_j = min(5.f, color_i + 1.f);
 		float mix_factor = color_pos - color_i;
 		vec3 color = mix(colors[color_i], colors[color_j], mix_factor);
-		registry.colors.insert(ghost_entity, color);
+		registry().colors.insert(ghost_entity, color);
 		timer.remaining_time = DASH_GHOST_DURATION_TIMER_MS;
 
 		player_dash.ghost_spawn_ms = DASH_GHOST_TIMER_MS;
@@ -575,6 +565,7 @@ void PlayerSystem::handle_dash(float elapsed_ms) {
 		// Start both invincibility and cooldown timers at the same time
 		player_dash.invincibility_timer_ms = player_dash.invincibility_duration;
 		player_dash.cooldown_timer = player_dash.dash_cooldown_ms;
+		registry().dashes.mark_changed(player);
 		player_dash.curr_distance = 0.0f;
 		player_dash.ghost_timer_ms = player_dash.ghost_duration;
 
@@ -596,14 +587,15 @@ void PlayerSystem::handle_dash(float elapsed_ms) {
 }
 
 void PlayerSystem::handle_reload() {
-	auto& player_inputs = registry.inputs.components[0];
-	if (!registry.guns.has(player)) {
+	auto& player_inputs = registry().inputs.components[0];
+	if (!registry().guns.has(player)) {
 		return;
 	}
-	auto& player_gun = registry.guns.get(player);
-	if (registry.reloads.has(player)) {
-		Reload& reload = registry.reloads.get(player);
+	auto& player_gun = registry().guns.get(player);
+	if (registry().reloads.has(player)) {
+		Reload& reload = registry().reloads.get(player);
 		if (reload.remaining_time <= 0.f) {
+			registry().guns.mark_changed(player);
 			if (reload.one_at_a_time) {
 				if (player_gun.current_magazine < player_gun.magazine_size && player_gun.remaining_bullets > 0) {
 					player_gun.current_magazine += 1;
@@ -614,18 +606,18 @@ void PlayerSystem::handle_reload() {
 						audio->play_sound(player_gun.reload_effect, 50);
 					} else {
 						audio->play_sound(player_gun.rack_effect, 50);
-						registry.reloads.remove(player);
+						registry().reloads.remove(player);
 					}
 				} else {
 					audio->play_sound(player_gun.rack_effect, 50);
-					registry.reloads.remove(player);
+					registry().reloads.remove(player);
 				}
 			} else {
 				int amount_to_reload = player_gun.magazine_size - player_gun.current_magazine;
 				int bullets_to_transfer = min(amount_to_reload, player_gun.remaining_bullets);
 				player_gun.current_magazine += bullets_to_transfer;
 				player_gun.remaining_bullets -= bullets_to_transfer;
-				registry.reloads.remove(player);
+				registry().reloads.remove(player);
 			}
 		}
 		return;
@@ -635,7 +627,7 @@ void PlayerSystem::handle_reload() {
 		return;
 	}
 
-	Reload& reload = registry.reloads.emplace(player);
+	Reload& reload = registry().reloads.emplace(player);
 	reload.remaining_time = player_gun.reload_time;
 	reload.one_at_a_time = player_gun.reload_one_at_a_time;
 	audio->play_sound(player_gun.reload_effect, 50);
@@ -644,9 +636,9 @@ void PlayerSystem::handle_reload() {
 
 // changes player velocity to direction of input
 void PlayerSystem::update_player_velocity(float elapsed_ms) {
-	auto& playerMotion = registry.motions.get(player);
-	auto& playerInputs = registry.inputs.get(registry.inputs.entities[0]);
-	auto& playerComponent = registry.players.get(player);
+	auto& playerMotion = registry().motions.get(player);
+	auto& playerInputs = registry().inputs.get(registry().inputs.entities[0]);
+	auto& playerComponent = registry().players.get(player);
 	float speed = playerComponent.speed;
 	
 	// reset velocity
@@ -667,7 +659,7 @@ void PlayerSystem::update_player_velocity(float elapsed_ms) {
 	targetVelocity = (targetVelocity / (velocity_length + epsilon)) * speed;
 
 	if (length(targetVelocity) != 0) {
-		auto& walkSoundTimer = registry.walkSoundTimers.get(this->player);
+		auto& walkSoundTimer = registry().walkSoundTimers.get(this->player);
 		if (walkSoundTimer.counter_ms == 0) {
 			// M1: creative element #23: Audio feedback
 			// Play footstep sound when user walks around
@@ -685,11 +677,11 @@ void PlayerSystem::update_player_velocity(float elapsed_ms) {
 }
 
 void PlayerSystem::update_camera_position(float elapsed_ms) {
-	Entity camera_entity = registry.cameras.entities[0];
-	Input& input = registry.inputs.components[0];
-	Camera& camera = registry.cameras.components[0];
-	Motion& player_motion = registry.motions.get(player);
-	Motion& camera_motion = registry.motions.get(camera_entity);
+	Entity camera_entity = registry().cameras.entities[0];
+	Input& input = registry().inputs.components[0];
+	Camera& camera = registry().cameras.components[0];
+	Motion& player_motion = registry().motions.get(player);
+	Motion& camera_motion = registry().motions.get(camera_entity);
 
 	vec2 mouse_wc = renderer->dcs_to_wcs(camera_motion, input.mouse_pos);
 	vec2 player_to_mouse_vector = mouse_wc - player_motion.position;
@@ -714,14 +706,14 @@ void PlayerSystem::update_camera_position(float elapsed_ms) {
 }
 
 void PlayerSystem::update_crosshair_position() {
-	Motion& crosshair_motion = registry.motions.get(crosshair);
-	auto& inputs = registry.inputs.get(registry.inputs.entities[0]);
+	Motion& crosshair_motion = registry().motions.get(crosshair);
+	auto& inputs = registry().inputs.get(registry().inputs.entities[0]);
 
 	crosshair_motion.position = inputs.mouse_pos;
 }
 
 vec2 PlayerSystem::get_gun_position() {
-	auto& player_motion = registry.motions.get(player);
+	auto& player_motion = registry().motions.get(player);
 	vec2 gun_offset = vec2(-player_motion.scale.x/2, 0);
 	float rad = glm::radians(player_motion.angle);
 	vec2 rotated_offset = {
@@ -732,7 +724,7 @@ vec2 PlayerSystem::get_gun_position() {
 }
 
 vec2 PlayerSystem::get_laser_position() {
-	auto& player_motion = registry.motions.get(player);
+	auto& player_motion = registry().motions.get(player);
 	float laser_size = 200;
 	vec2 laser_offset = vec2(-(player_motion.scale.x/2 + laser_size/2), 0);
 	float rad = glm::radians(player_motion.angle);
@@ -746,25 +738,16 @@ vec2 PlayerSystem::get_laser_position() {
 void player_got_shot(Entity projectile, AudioSystem* audio) {
 	audio->play_sound(SOUND_ASSET_ID::BULLET_HIT_FLESH_1, 25);
 
-	Entity player = registry.players.entities[0];
-	Motion& projectile_motion = registry.motions.get(projectile);
-	Motion& player_motion = registry.motions.get(player);
+	Entity player = registry().players.entities[0];
+	Motion& projectile_motion = registry().motions.get(projectile);
+	Motion& player_motion = registry().motions.get(player);
 
 	create_animation(
 		player_motion.position, 
 		{ 0.f, 0.f },
 		{ 150.f, 150.f },
 		projectile_motion.angle + 270.f,
-		std::vector<TEXTURE_ASSET_ID>{
-			TEXTURE_ASSET_ID::BLOOD_SPLATTER_0,
-			TEXTURE_ASSET_ID::BLOOD_SPLATTER_1,
-			TEXTURE_ASSET_ID::BLOOD_SPLATTER_2,
-			TEXTURE_ASSET_ID::BLOOD_SPLATTER_3,
-			TEXTURE_ASSET_ID::BLOOD_SPLATTER_4,
-			TEXTURE_ASSET_ID::BLOOD_SPLATTER_5,
-			TEXTURE_ASSET_ID::BLOOD_SPLATTER_6,
-			TEXTURE_ASSET_ID::BLOOD_SPLATTER_7,
-		},
+		BLOOD_SPLATTER_CLIP,
 		true,
 		false,
 		30.0f,
@@ -776,12 +759,7 @@ void player_got_shot(Entity projectile, AudioSystem* audio) {
 		{ 0.f, 0.f },
 		{ 300.f, 300.f },
 		projectile_motion.angle + 90.f,
-		std::vector<TEXTURE_ASSET_ID>{
-			TEXTURE_ASSET_ID::DAMAGE_INDICATOR_0,
-			TEXTURE_ASSET_ID::DAMAGE_INDICATOR_1,
-			TEXTURE_ASSET_ID::DAMAGE_INDICATOR_2,
-			TEXTURE_ASSET_ID::DAMAGE_INDICATOR_3,
-		},
+		DAMAGE_INDICATOR_CLIP,
 		true,
 		false,
 		50.0f,
@@ -792,7 +770,7 @@ void player_got_shot(Entity projectile, AudioSystem* audio) {
 }
 
 void PlayerSystem::handle_exit() {
-	auto& input = registry.inputs.get(registry.inputs.entities[0]);
+	auto& input = registry().inputs.get(registry().inputs.entities[0]);
 
 	if (!input.keys[GLFW_KEY_ESCAPE]) {
 		return;
@@ -802,10 +780,10 @@ void PlayerSystem::handle_exit() {
 }
 
 void update_player_sprite() {
-	if (!registry.players.entities.empty()) {
-		Entity& player_entity = registry.players.entities[0];
-		Gun& player_gun = registry.guns.get(player_entity);
-		RenderRequest& player_render_request = registry.renderRequests.get(player_entity);
+	if (!registry().players.entities.empty()) {
+		Entity& player_entity = registry().players.entities[0];
+		Gun& player_gun = registry().guns.get(player_entity);
+		RenderRequest& player_render_request = registry().renderRequests.get(player_entity);
 		if (player_gun.gun_type == GUN_TYPE::SHOTGUN) {
 			player_render_request.used_texture = TEXTURE_ASSET_ID::PLAYER_SHOOTING_SHOTGUN;
 		} else {
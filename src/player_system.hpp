@@ -4,15 +4,18 @@
 #include "render_system.hpp"
 #include "audio_system.hpp"
 #include <world_system.hpp>
+#include "world.hpp"
 
-class PlayerSystem {
+class PlayerSystem : public GameSystem {
 public:
+	using GameSystem::GameSystem;
+
     // Updates the player's rotation to face the mouse
     void updatePlayerRotation();
 
 	bool step(float elapsed_ms);
 
-	void init(RenderSystem* renderer, AudioSystem* audio, WorldSystem* world, GLFWwindow* window);
+	void init(RenderSystem* renderer, AudioSystem* audio, WorldSystem* world_system, GLFWwindow* window);
 
     void progress_timers(float elapsed_ms);
 
@@ -46,7 +49,7 @@ private:
 
 	RenderSystem* renderer;
     AudioSystem* audio;
-    WorldSystem* world;
+    WorldSystem* world_system;
 	GLFWwindow* window;
 
     vec2 get_gun_position();
@@ -12,25 +12,22 @@
 
 void RenderSystem::drawTexturedMesh(Entity entity, const mat3 &projection)
 {
-	//Motion &motion = registry.motions.get(entity);
+	//Motion &motion = registry().motions.get(entity);
 	// Transformation code, see Rendering and Transformation in the template
 	// specification for more info Incrementally updates transformation matrix,
 	// thus ORDER IS IMPORTANT
 	Transform transform;
 
-	if (registry.motions.has(entity)) {
-		Motion& motion = registry.motions.get(entity);
-		transform.translate(motion.position);
-		transform.scale(motion.scale);
-		transform.rotate(radians(motion.angle));
+	if (registry().motions.has(entity)) {
+		transform.mat = world_matrix(registry().motions.get(entity));
 	}
-	else if (registry.buttons.has(entity)) {
-		UIButton& btn = registry.buttons.get(entity);
+	else if (registry().buttons.has(entity)) {
+		UIButton& btn = registry().buttons.get(entity);
 		transform.translate(btn.position);
 		transform.scale(btn.scale);
 	}
-	else if (registry.text.has(entity)) {
-		TitleScreenText& text = registry.text.get(entity);
+	else if (registry().text.has(entity)) {
+		TitleScreenText& text = registry().text.get(entity);
 		transform.translate(text.position);
 		transform.scale(text.scale);
 	}
@@ -40,8 +37,8 @@ void RenderSystem::drawTexturedMesh(Entity entity, const mat3 &projection)
 	transform.scale(motion.scale);
 	transform.rotate(radians(motion.angle));*/
 
-	assert(registry.renderRequests.has(entity));
-	const RenderRequest &render_request = registry.renderRequests.get(entity);
+	assert(registry().renderRequests.has(entity));
+	const RenderRequest &render_request = registry().renderRequests.get(entity);
 
 	const GLuint used_effect_enum = (GLuint)EFFECT_ASSET_ID::TEXTURED;
 	const GLuint program = (GLuint)effects[used_effect_enum];
@@ -84,21 +81,21 @@ void RenderSystem::drawTexturedMesh(Entity entity, const mat3 &projection)
 		GLuint texture_id = texture_gl_handles[(GLuint)render_request.used_texture];
 		glBindTexture(GL_TEXTURE_2D, texture_id);
 	}
-	else if (registry.renderRequests.get(entity).texture_origin == TEXTURE_ORIGIN_ID::MAP) {
-		int current_level = registry.gameProgress.components[0].level;
-		Map& map = registry.maps.components[current_level];
+	else if (registry().renderRequests.get(entity).texture_origin == TEXTURE_ORIGIN_ID::MAP) {
+		int current_level = registry().gameProgress.components[0].level;
+		Map& map = registry().maps.components[current_level];
 		glBindTexture(GL_TEXTURE_2D, map.map_texture);
 	}
 	gl_has_errors();
 
 	// Getting uniform locations for glUniform* calls
 	GLint color_uloc = glGetUniformLocation(program, "fcolor");
-	const vec3 color = registry.colors.has(entity) ? registry.colors.get(entity) : vec3(1);
+	const vec3 color = registry().colors.has(entity) ? registry().colors.get(entity) : vec3(1);
 	glUniform3fv(color_uloc, 1, (float *)&color);
 	gl_has_errors();
 
 	GLint alpha_uloc = glGetUniformLocation(program, "alpha");
-	glUniform1f(alpha_uloc, registry.renderRequests.get(entity).alpha);
+	glUniform1f(alpha_uloc, registry().renderRequests.get(entity).alpha);
 	gl_has_errors();
 	
 	GLint outline_loc = glGetUniformLocation(program, "outline_transparency");
@@ -137,17 +134,15 @@ void RenderSystem::drawTexturedMesh(Entity entity, const mat3 &projection)
 
 void RenderSystem::drawTexturedNormal(Entity entity, const mat3 &projection)
 {
-	Motion &motion = registry.motions.get(entity);
+	Motion &motion = registry().motions.get(entity);
 	// Transformation code, see Rendering and Transformation in the template
 	// specification for more info Incrementally updates transformation matrix,
 	// thus ORDER IS IMPORTANT
 	Transform transform;
-	transform.translate(motion.position);
-	transform.scale(motion.scale);
-	transform.rotate(radians(motion.angle));
+	transform.mat = world_matrix(motion);
 
-	assert(registry.renderRequests.has(entity));
-	const RenderRequest &render_request = registry.renderRequests.get(entity);
+	assert(registry().renderRequests.has(entity));
+	const RenderRequest &render_request = registry().renderRequests.get(entity);
 
 	const GLuint used_effect_enum = (GLuint)EFFECT_ASSET_ID::TEXTURED_WITH_NORMAL;
 	const GLuint program = (GLuint)effects[used_effect_enum];
@@ -187,20 +182,20 @@ void RenderSystem::drawTexturedNormal(Entity entity, const mat3 &projection)
 
 	gl_has_errors();
 
-	assert(registry.renderRequests.has(entity));
-	if (registry.renderRequests.get(entity).texture_origin == TEXTURE_ORIGIN_ID::FILE) { // TODO: See if we can refactor to remove if and assert
+	assert(registry().renderRequests.has(entity));
+	if (registry().renderRequests.get(entity).texture_origin == TEXTURE_ORIGIN_ID::FILE) { // TODO: See if we can refactor to remove if and assert
 		glActiveTexture(GL_TEXTURE0);
-		GLuint texture_id = texture_gl_handles[(GLuint)registry.renderRequests.get(entity).used_texture];
+		GLuint texture_id = texture_gl_handles[(GLuint)registry().renderRequests.get(entity).used_texture];
 		glBindTexture(GL_TEXTURE_2D, texture_id);
 
 		glActiveTexture(GL_TEXTURE1);
-		texture_id = texture_gl_handles[(GLuint)registry.renderRequests.get(entity).texture_normal];
+		texture_id = texture_gl_handles[(GLuint)registry().renderRequests.get(entity).texture_normal];
 		glBindTexture(GL_TEXTURE_2D, texture_id);
 	}
-	else if (registry.renderRequests.get(entity).texture_origin == TEXTURE_ORIGIN_ID::MAP) {
+	else if (registry().renderRequests.get(entity).texture_origin == TEXTURE_ORIGIN_ID::MAP) {
 		glActiveTexture(GL_TEXTURE0);
-		int current_level = registry.gameProgress.components[0].level;
-		Map& map = registry.maps.components[current_level];
+		int current_level = registry().gameProgress.components[0].level;
+		Map& map = registry().maps.components[current_level];
 		glBindTexture(GL_TEXTURE_2D, map.map_texture);
 
 		glActiveTexture(GL_TEXTURE1);
@@ -210,7 +205,7 @@ void RenderSystem::drawTexturedNormal(Entity entity, const mat3 &projection)
 
 	// Getting uniform locations for glUniform* calls
 	GLint color_uloc = glGetUniformLocation(program, "fcolor");
-	const vec3 color = registry.colors.has(entity) ? registry.colors.get(entity) : vec3(1);
+	const vec3 color = registry().colors.has(entity) ? registry().colors.get(entity) : vec3(1);
 	glUniform3fv(color_uloc, 1, (float *)&color);
 	gl_has_errors();
 
@@ -259,7 +254,7 @@ void RenderSystem::renderText(Text& text, Motion& motion, mat3 projection_matrix
     std::unordered_map<GLuint, std::vector<float>> batchedVertices;
     float offset = 0.f;
     for (char c : text.content) {
-        Character character = registry.character_map[c];
+        Character character = registry().character_map[c];
 
         float xpos = motion.position.x + offset + character.Bearing.x;
         float ypos = motion.position.y - character.Bearing.y;
@@ -329,7 +324,7 @@ void RenderSystem::drawToScreen()
 
 	glUniform1f(time_uloc, (float)(glfwGetTime() * 10.0f));
 	
-	ScreenState& screen = registry.screen_state;
+	ScreenState& screen = registry().screen_state;
 	glUniform1f(glitch_start_uloc, screen.glitch_remaining_ms);
 	glUniform1f(glitch_duration_uloc, screen.glitch_duration);
 	gl_has_errors();
@@ -383,34 +378,22 @@ void RenderSystem::draw()
 	gl_has_errors();
 
 	mat3 projection_2D = createProjectionMatrix();
+	update_world_matrices();
 
 	if (debugging.wireframe) {
 		glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
 	}
 
 	// Draw renderRequests in order of their z_index
-	// This runs in linear time in relation to the number of renderRequests
-	// Sorting would have been O(n*log(n))
-	for (int z_index=0; z_index < (int)Z_INDEX::NO_LIGHTING; z_index++) {
-		for (int i=0; i < registry.renderRequests.size(); i++) {
-			Entity entity = registry.renderRequests.entities[i];
-			RenderRequest& renderRequest = registry.renderRequests.components[i];
-			if (z_index == (int) renderRequest.z_index && registry.motions.has(entity) && !renderRequest.is_ui_element) {
-				drawTexturedMesh(entity, projection_2D);
-			}
-		}
+	update_draw_order();
+	for (Entity entity : draw_order) {
+		drawTexturedMesh(entity, projection_2D);
 	}
 
 	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, base_texture_normal, 0);
 
-	for (int z_index=0; z_index < (int)Z_INDEX::NO_LIGHTING; z_index++) {
-		for (int i=0; i < registry.renderRequests.size(); i++) {
-			Entity entity = registry.renderRequests.entities[i];
-			RenderRequest& renderRequest = registry.renderRequests.components[i];
-			if (z_index == (int) renderRequest.z_index && registry.motions.has(entity) && !renderRequest.is_ui_element) {
-				drawTexturedNormal(entity, projection_2D);
-			}
-		}
+	for (Entity entity : draw_order) {
+		drawTexturedNormal(entity, projection_2D);
 	}
 
 	if (debugging.wireframe) {
@@ -425,17 +408,51 @@ void RenderSystem::draw()
 
 	drawTextureIgnoreLighting(projection_2D);
 	drawUI(ortho_matrix);
+	world_matrices_valid = false;
 
 	// flicker-free display with a double buffer
 	glfwSwapBuffers(window);
 	gl_has_errors();
 }
 
+// Computes the world matrix of every Motion in one pass over the dense array, instead of building a Transform per draw call.
+// Each matrix is translate * scale * rotate, the same as the Transform chain, written out directly.
+void RenderSystem::update_world_matrices()
+{
+	const std::vector<Motion>& motions = registry().motions.components;
+	world_matrices.resize(motions.size());
+	for (size_t i = 0; i < motions.size(); i++) {
+		const Motion& motion = motions[i];
+		float c = cosf(radians(motion.angle));
+		float s = sinf(radians(motion.angle));
+		world_matrices[i] = {
+			{ motion.scale.x * c, motion.scale.y * s, 0.f },
+			{ -motion.scale.x * s, motion.scale.y * c, 0.f },
+			{ motion.position.x, motion.position.y, 1.f }
+		};
+	}
+	world_matrices_valid = true;
+}
+
+// The precomputed matrix of a Motion in registry().motions, or a freshly built one outside of draw()
+mat3 RenderSystem::world_matrix(const Motion& motion)
+{
+	size_t index = &motion - registry().motions.components.data();
+	if (world_matrices_valid && index < world_matrices.size())
+		return world_matrices[index];
+
+	Transform transform;
+	transform.translate(motion.position);
+	transform.scale(motion.scale);
+	transform.rotate(radians(motion.angle));
+	return transform.mat;
+}
+
 mat3 RenderSystem::createProjectionMatrix()
 {
 	// M1: creative element #21: Camera control 
 	// Uses camera component resolution and position to create the projection matrix, rather than having it fixed at the window size and center.
-	Motion& motion = registry.motions.get(camera_entity);
+	Motion& motion = registry().motions.get(camera_entity);
 
 	float x_pos = motion.position.x;
 	float y_pos = motion.position.y;
@@ -483,7 +500,7 @@ mat3 RenderSystem::create_inverse_projection_matrix(Motion& camera_motion) {
 }
 
 mat3 RenderSystem::create_inverse_projection_matrix() {
-	Motion& camera_motion = registry.motions.get(camera_entity);
+	Motion& camera_motion = registry().motions.get(camera_entity);
 
 	float x_pos = camera_motion.position.x;
 	float y_pos = camera_motion.position.y;
@@ -532,18 +549,18 @@ vec2 RenderSystem::dcs_to_wcs(Motion& camera_motion, vec2 dcs) {
 }
 
 Entity RenderSystem::create_tile_render_request(Tile tile, int col, int row) {
-	Entity entity = Entity();
+	Entity entity = registry().create();
 
 	Mesh& mesh = getMesh(GEOMETRY_BUFFER_ID::SPRITE);
-	registry.meshPtrs.emplace(entity, &mesh);
+	registry().meshPtrs.emplace(entity, &mesh);
 
-	auto& motion = registry.motions.emplace(entity);
+	auto& motion = registry().motions.emplace(entity);
 	motion.angle = 0.f;
 	motion.velocity = { 0.0f, 0.0f };
 	motion.position = grid_to_world_coord(col, row);
 	motion.scale = vec2({ GRID_CELL_SIZE, GRID_CELL_SIZE });
 
-	registry.renderRequests.insert(
+	registry().renderRequests.insert(
 		entity,
 		{
 			tile.texture,
@@ -646,7 +663,7 @@ void RenderSystem::set_map_texture(Map& map) {
 	for (int z_index=0; z_index < z_index_count; z_index++) {
 		for (int i=0; i < temp_entities.size(); i++) {
 			Entity entity = temp_entities[i];
-			RenderRequest& renderRequest = registry.renderRequests.components[i];
+			RenderRequest& renderRequest = registry().renderRequests.components[i];
 			if (z_index == (int) renderRequest.z_index) {
 				drawTexturedMesh(entity, projection_2D);
 			}
@@ -660,7 +677,7 @@ void RenderSystem::set_map_texture(Map& map) {
 	for (int z_index=0; z_index < z_index_count; z_index++) {
 		for (int i=0; i < temp_entities.size(); i++) {
 			Entity entity = temp_entities[i];
-			RenderRequest& renderRequest = registry.renderRequests.components[i];
+			RenderRequest& renderRequest = registry().renderRequests.components[i];
 			if (z_index == (int) renderRequest.z_index) {
 				drawTexturedNormal(entity, projection_2D);
 			}
@@ -673,11 +690,11 @@ void RenderSystem::set_map_texture(Map& map) {
 	glBindFramebuffer(GL_FRAMEBUFFER, 0);
 
 	for (Entity entity : temp_entities) {
-		registry.remove_all_components_of(entity);
+		registry().destroy(entity);
 	}
 
 	std::vector<vec3> vertices;
-	for (ShadowCaster& shadowCaster : registry.shadowCasters.components) {
+	for (ShadowCaster& shadowCaster : registry().shadowCasters.components) {
 		make_quad(vertices, shadowCaster.start.x, shadowCaster.start.y, shadowCaster.end.x, shadowCaster.end.y);
 	}
 	glBindBuffer(GL_ARRAY_BUFFER, vertex_buffers[(GLuint)GEOMETRY_BUFFER_ID::SHADOW_QUAD]);
@@ -696,13 +713,13 @@ void RenderSystem::make_quad(std::vector<vec3>& vertices, float x1, float y1, fl
 void RenderSystem::drawAllLights() {
 	mat3 projection_matrix = createProjectionMatrix();
 	mat3 inverse_projection = create_inverse_projection_matrix();
-	ScreenState& screen_state = registry.screen_state;
+	ScreenState& screen_state = registry().screen_state;
 	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, light_texture, 0);
 
 	glClearColor(screen_state.ambient_color.x, screen_state.ambient_color.y, screen_state.ambient_color.z, 1.f);
 	glClear(GL_COLOR_BUFFER_BIT);
 
-	for (Light& light : registry.lights.components) {
+	for (Light& light : registry().lights.components) {
 		if (!is_light_in_view(light, projection_matrix)) {
 			continue;
 		}
@@ -795,20 +812,49 @@ void RenderSystem::drawLight(mat3 projection_matrix, mat3 inverse_projection, Li
 	glDrawElements(GL_TRIANGLES, 3, GL_UNSIGNED_SHORT, nullptr); 
 }
 
+// Buckets the lit world entities by z_index, keeping the container order within a bucket.
+// This runs in linear time in relation to the number of renderRequests and is skipped when nothing changed
+void RenderSystem::update_draw_order() {
+	if (!registry().renderRequests.changed_since(draw_order_tick) && !registry().motions.changed_since(draw_order_tick)) {
+		return;
+	}
+	draw_order_tick = ChangeTick::checkpoint();
+
+	const int bucket_count = (int)Z_INDEX::NO_LIGHTING;
+	std::vector<unsigned int> bucket_start(bucket_count + 1, 0);
+	for (auto [entity, renderRequest, motion] : registry().view<RenderRequest, Motion>().use<RenderRequest>()) {
+		int z_index = (int)renderRequest.z_index;
+		if (z_index < bucket_count && !renderRequest.is_ui_element) {
+			bucket_start[z_index + 1]++;
+		}
+	}
+	for (int z_index = 0; z_index < bucket_count; z_index++) {
+		bucket_start[z_index + 1] += bucket_start[z_index];
+	}
+
+	draw_order.resize(bucket_start[bucket_count]);
+	for (auto [entity, renderRequest, motion] : registry().view<RenderRequest, Motion>().use<RenderRequest>()) {
+		int z_index = (int)renderRequest.z_index;
+		if (z_index < bucket_count && !renderRequest.is_ui_element) {
+			draw_order[bucket_start[z_index]++] = entity;
+		}
+	}
+}
+
 void RenderSystem::drawUI(mat3 projection) {
 	glEnable(GL_BLEND);
 	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
 	for (int z_index = (int)Z_INDEX::NO_LIGHTING; z_index < z_index_count; z_index++) {
-		for (Entity& entity : registry.uis.entities) {
-			if (registry.texts.has(entity)) {
+		for (Entity& entity : registry().uis.entities) {
+			if (registry().texts.has(entity)) {
 				if (z_index == (int)Z_INDEX::HUD) {
-					Motion& motion = registry.motions.get(entity);
-					Text& text = registry.texts.get(entity);
+					Motion& motion = registry().motions.get(entity);
+					Text& text = registry().texts.get(entity);
 					renderText(text, motion, projection);
 				}
 			} else {
-				RenderRequest& render_request = registry.renderRequests.get(entity);
+				RenderRequest& render_request = registry().renderRequests.get(entity);
 				if ((int)render_request.z_index == z_index) {
 					drawTexturedMesh(entity, projection);
 				}
@@ -822,8 +868,8 @@ void RenderSystem::drawUI(mat3 projection) {
 void RenderSystem::drawTextureIgnoreLighting(mat3 projection) {
 	glEnable(GL_BLEND);
 	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-	for (Entity& entity : registry.textureWithoutLighting.entities) {
-		RenderRequest& render_request = registry.renderRequests.get(entity);
+	for (Entity& entity : registry().textureWithoutLighting.entities) {
+		RenderRequest& render_request = registry().renderRequests.get(entity);
 		drawTexturedMesh(entity, projection);
 	}
 	glDisable(GL_BLEND);
@@ -7,10 +7,11 @@
 #include "world_init.hpp"
 #include "tinyECS/components.hpp"
 #include "tinyECS/tiny_ecs.hpp"
+#include "world.hpp"
 
 // System responsible for setting up OpenGL and for rendering all the
 // visual entities in the game
-class RenderSystem {
+class RenderSystem : public GameSystem {
 	/**
 	 * The following arrays store the assets the game will use. They are loaded
 	 * at initialization and are assumed to not be modified by the render loop.
@@ -221,6 +222,8 @@ class RenderSystem {
 	std::array<Mesh, geometry_count> meshes;
 
 public:
+	using GameSystem::GameSystem;
+
 	// Initialize the window
 	bool init(GLFWwindow* window);
 
@@ -284,6 +287,9 @@ private:
 	void drawShadowVolume(mat3 projection_matrix, Light& light);
 	void drawUI(mat3 projection);
 	void drawTextureIgnoreLighting(mat3 projection);
+	void update_draw_order();
+	void update_world_matrices();
+	mat3 world_matrix(const Motion& motion);
 
 	// Window handle
 	GLFWwindow* window;
@@ -303,6 +309,14 @@ private:
 	Entity screen_state_entity;
 	Entity camera_entity;
 
+	// Lit world entities bucketed by z_index, rebuilt only when render requests or motions change
+	std::vector<Entity> draw_order;
+	uint32_t draw_order_tick = 0;
+
+	// World matrix of every Motion in the order of registry().motions, computed once per draw()
+	std::vector<mat3> world_matrices;
+	bool world_matrices_valid = false; // only while draw() runs, entities can be created and destroyed in between
+
 	struct {
 		GLint light_pos;
 		GLint light_radius;
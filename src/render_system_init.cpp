@@ -67,9 +67,9 @@ void RenderSystem::initializeCamera()
 {
 	// M1: creative element #21: Camera control 
 	// Creates a camera component with the resolution of the window
-	Entity ent = Entity();	
-	registry.cameras.emplace(ent);
-	Motion& motion = registry.motions.emplace(ent);
+	Entity ent = registry().create();	
+	registry().cameras.emplace(ent);
+	Motion& motion = registry().motions.emplace(ent);
 
 	motion.scale = { (float)WINDOW_WIDTH_PX, (float)WINDOW_HEIGHT_PX };
 	motion.position = { motion.scale.x / 2, motion.scale.y / 2 };
@@ -239,15 +239,15 @@ void RenderSystem::initializeFonts() {
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
-		Entity char_entity = Entity();
-		Character& character = registry.characters.emplace(char_entity);
+		Entity char_entity = registry().create();
+		Character& character = registry().characters.emplace(char_entity);
 		character.TextureID = texture;
 		character.Size = { face->glyph->bitmap.width, face->glyph->bitmap.rows };
 		character.Bearing = { face->glyph->bitmap_left, face->glyph->bitmap_top };
 		character.Advance = face->glyph->advance.x;
 		character.Character = (char)c;
 
-		registry.character_map[c] = character;
+		registry().character_map[c] = character;
 	}
 	glBindTexture(GL_TEXTURE_2D, 0);
 
@@ -275,8 +275,8 @@ RenderSystem::~RenderSystem()
 	gl_has_errors();
 
 	// remove all entities created by the render system
-	while (registry.renderRequests.entities.size() > 0)
-	    registry.remove_all_components_of(registry.renderRequests.entities.back());
+	while (registry().renderRequests.entities.size() > 0)
+	    registry().destroy(registry().renderRequests.entities.back());
 }
 
 // Initialize the screen texture from a standard sprite
@@ -0,0 +1,517 @@
+#include "sat_batch.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <glm/trigonometric.hpp>
+
+// SAT_DISABLE_SIMD builds the scalar kernels on every platform, e.g. to check them against the scalar tests
+#if (defined(__SSE2__) || defined(_M_X64)) && !defined(SAT_DISABLE_SIMD)
+#include <emmintrin.h>
+#define SAT_USE_SSE2
+#endif
+
+// The kernels repeat the arithmetic of AABBCircleSAT and AABBSAT operation for operation, in the same order,
+// so that a batch gives exactly the results the scalar tests gave on the same statics
+
+// Returns the relative center of the collision object based on angle
+vec2 get_relative_center(vec2 position, float angle, vec2 offset) {
+	float radians = glm::radians(angle);
+	vec2 rotated_offset = {
+		offset.x * cos(radians) - offset.y * sin(radians),
+		offset.x * sin(radians) + offset.y * cos(radians)
+	};
+	return position + rotated_offset;
+}
+
+// Rotate a point around the origin
+static vec2 rotate_point(const vec2& point, float sin_angle, float cos_angle) {
+	return vec2{
+		point.x * cos_angle - point.y * sin_angle,
+		point.x * sin_angle + point.y * cos_angle
+	};
+}
+
+// Calculate the corners of an AABB after rotation
+std::array<vec2, 4> get_rotated_corners(const vec2& center, const vec2& size, float angle) {
+	// Half width and half height
+	float x_half = size.x / 2.0f;
+	float y_half = size.y / 2.0f;
+
+	// AABB corners before rotation
+	std::array<vec2, 4> local_corners = {{
+		{ -x_half, -y_half }, // Top-left
+		{ x_half, -y_half },  // Top-right
+		{ x_half, y_half },   // Bottom-right
+		{ -x_half, y_half }   // Bottom-left
+	}};
+
+	float radians_angle = radians(angle);
+	float sin_angle = sin(radians_angle);
+	float cos_angle = cos(radians_angle);
+
+	// Rotate each corner and apply the center position
+	std::array<vec2, 4> corners;
+    for (int i = 0; i < 4; ++i) {
+        corners[i] = rotate_point(local_corners[i], sin_angle, cos_angle);
+        corners[i].x += center.x;
+        corners[i].y += center.y;
+    }
+
+    return corners;
+}
+
+// Project a point onto an axis using dot product
+static float project_point_on_axis(const vec2& point, const vec2& axis) {
+	return point.x * axis.x + point.y * axis.y;
+}
+
+static float squared_distance(const vec2& a, const vec2& b) {
+    float dx = a.x - b.x;
+    float dy = a.y - b.y;
+    return dx * dx + dy * dy;
+}
+
+// Check if two AABBs overlap using SAT with rotation
+bool AABBSAT(vec2& center_i, std::array<vec2, 4>& corners_i, AABB& AABB_i, vec2& center_j, std::array<vec2, 4>& corners_j, AABB& AABB_j, float delta_time) {
+	// Add early exit check
+    float half_width_i = AABB_i.collision_box.x / 2.0f;
+    float half_height_i = AABB_i.collision_box.y / 2.0f;
+    float radius_i = std::sqrt(half_width_i * half_width_i + half_height_i * half_height_i);
+
+    float half_width_j = AABB_j.collision_box.x / 2.0f;
+    float half_height_j = AABB_j.collision_box.y / 2.0f;
+    float radius_j = std::sqrt(half_width_j * half_width_j + half_height_j * half_height_j);
+
+    float center_distance_squared = squared_distance(center_i, center_j);
+    float total_radius = radius_i + radius_j;
+    if (center_distance_squared > total_radius * total_radius) {
+        return false;
+    }
+
+
+	// Check for overlap along the axes defined by the edges of the AABBs
+	vec2 axes[4];
+
+	// AABBs axes (edges of both AABBs)
+	for (int i = 0; i < 4; ++i) {
+		vec2 edge_i = vec2{ corners_i[(i + 1) % 4].x - corners_i[i].x, corners_i[(i + 1) % 4].y - corners_i[i].y };
+		vec2 edge_j = vec2{ corners_j[(i + 1) % 4].x - corners_j[i].x, corners_j[(i + 1) % 4].y - corners_j[i].y };
+
+		// Calculate the normal to the edge (perpendicular axis)
+		axes[i] = vec2{ -edge_i.y, edge_i.x };  // Normal of AABB_i's edge
+		if (i >= 2) axes[i] = vec2{ -edge_j.y, edge_j.x };  // Normal of AABB_j's edge
+	}
+
+	// For each axis, project the corners of both AABBs
+	for (int i = 0; i < 4; ++i) {
+		// Project the corners of entity_i onto the axis
+		float min_i = project_point_on_axis(corners_i[0], axes[i]);
+		float max_i = min_i;
+		for (int j = 1; j < 4; ++j) {
+			// project points onto axis
+			float projection = project_point_on_axis(corners_i[j], axes[i]);
+			min_i = std::min(min_i, projection);
+			max_i = std::max(max_i, projection);
+		}
+
+		// Project the corners of entity_j onto the axis
+		float min_j = project_point_on_axis(corners_j[0], axes[i]);
+		float max_j = min_j;
+		for (int j = 1; j < 4; ++j) {
+			float projection = project_point_on_axis(corners_j[j], axes[i]);
+			min_j = std::min(min_j, projection);
+			max_j = std::max(max_j, projection);
+		}
+
+		// Check for overlap along this axis
+		if (max_i < min_j || max_j < min_i) {
+			return false;
+		}
+	}
+	// Overlap on all axes, collision detected
+	return true;
+}
+
+
+bool AABBCircleSAT(vec2& rect_center, AABB& rect_aabb, std::array<vec2, 4>& rect_corners, vec2& circle_center, CircleBound& circle_bound, Motion& circle_motion, float delta_time) {
+	// Early exit check
+	float max_rect_radius = std::max(rect_aabb.collision_box.x, rect_aabb.collision_box.y) / 2.0f;
+    float max_distance = max_rect_radius + circle_bound.collision_radius;
+	float max_distance_squared = max_distance * max_distance;
+	float center_distance_x = rect_center.x - circle_center.x;
+	float center_distance_y = rect_center.y - circle_center.y;
+	float center_distance_squared = center_distance_x * center_distance_x + center_distance_y * center_distance_y;
+    if (center_distance_squared > max_distance_squared) {
+        return false;
+    }
+
+	// Generate axes from rectangle edges
+	vec2 axes[3]; // 2 rectangle edge normals + 1 extra from circle to closest point
+	for (int i = 0; i < 2; ++i) {
+		vec2 edge = rect_corners[(i + 1) % 4] - rect_corners[i];
+		axes[i] = vec2(-edge.y, edge.x); // Perpendicular edge normal
+	}
+
+	// Find the closest corner on the rectangle to the circle's center
+	vec2 closest_point = rect_corners[0];
+	float min_dist_sq = std::numeric_limits<float>::max();
+	for (int i = 0; i < 4; ++i) {
+		vec2 corner = rect_corners[i];
+		// squared distance between corner to circle center
+		float dist_sq = (corner.x - circle_center.x) * (corner.x - circle_center.x) +
+			(corner.y - circle_center.y) * (corner.y - circle_center.y);
+		if (dist_sq < min_dist_sq) {
+			min_dist_sq = dist_sq;
+			closest_point = corner;
+		}
+	}
+
+	// axis from circle's center to closest corner on AABB
+	axes[2] = closest_point - circle_center;
+
+	// TODO: Look into working with squared distances until we have to normalize, do this for the other collision functions too
+	// SAT Projection Tests
+	for (int i = 0; i < 3; ++i) {
+		vec2 axis = axes[i];
+		float axis_length_sq = axis.x * axis.x + axis.y * axis.y;
+		if (axis_length_sq == 0) {
+			continue;
+		}
+		// normalize axis
+		axis = axis / sqrt(axis_length_sq);
+
+		// Project rectangle onto axis
+		float min_rect = project_point_on_axis(rect_corners[0], axis);
+		float max_rect = min_rect;
+		for (int j = 1; j < 4; ++j) {
+			float proj = project_point_on_axis(rect_corners[j], axis);
+			min_rect = std::min(min_rect, proj);
+			max_rect = std::max(max_rect, proj);
+		}
+
+		// Project circle onto axis
+		float proj_circle = project_point_on_axis(circle_center, axis);
+		float min_circle = proj_circle - circle_bound.collision_radius;
+		float max_circle = proj_circle + circle_bound.collision_radius;
+
+		// TODO: Don't we also have to check if the rectangle is moving and it will pass the circle?
+		// check if the circle will fully pass the rectangle in the next frame
+		vec2 circle_next_position = circle_center + circle_motion.velocity * delta_time;
+		float proj_circle_next = project_point_on_axis(circle_next_position, axis);
+		float min_circle_next = proj_circle_next - circle_bound.collision_radius;
+		float max_circle_next = proj_circle_next + circle_bound.collision_radius;
+		if ((max_rect < min_circle_next || max_circle_next < min_rect) &&
+			(max_rect < min_circle || max_circle < min_rect)) {
+			//std::cout << "Circle will pass the rectangle in the next frame!" << std::endl;
+			return false;
+		}
+
+		// If there's a gap between projections, no collision
+		if (max_rect < min_circle || max_circle < min_rect) {
+			return false;
+		}
+	}
+	// Overlap on all axes, collision detected
+	return true;
+}
+
+// given the vertices, updates from local to world coordinate
+
+StaticShape make_static_shape(const Motion& motion, const AABB& aabb) {
+	StaticShape shape;
+	shape.center = get_relative_center(motion.position, motion.angle, aabb.offset);
+	shape.box = aabb.collision_box;
+	std::array<vec2, 4> corners = get_rotated_corners(shape.center, aabb.collision_box, motion.angle);
+	shape.box_min = corners[0];
+	shape.box_max = corners[0];
+	for (int i = 0; i < 4; i++) {
+		shape.corners[i] = corners[i];
+		shape.box_min = glm::min(shape.box_min, corners[i]);
+		shape.box_max = glm::max(shape.box_max, corners[i]);
+	}
+	for (int i = 0; i < 2; i++) {
+		vec2 edge = vec2{ corners[i + 1].x - corners[i].x, corners[i + 1].y - corners[i].y };
+		shape.edge_normals[i] = vec2{ -edge.y, edge.x };
+		float length_sq = shape.edge_normals[i].x * shape.edge_normals[i].x + shape.edge_normals[i].y * shape.edge_normals[i].y;
+		shape.unit_normals[i] = length_sq == 0 ? vec2(0.f) : shape.edge_normals[i] / std::sqrt(length_sq);
+	}
+	shape.half_extent = std::max(aabb.collision_box.x, aabb.collision_box.y) / 2.0f;
+	float half_width = aabb.collision_box.x / 2.0f;
+	float half_height = aabb.collision_box.y / 2.0f;
+	shape.half_diagonal = std::sqrt(half_width * half_width + half_height * half_height);
+	shape.axis_aligned = shape.unit_normals[0] == vec2(0.f, 1.f) && shape.unit_normals[1] == vec2(-1.f, 0.f);
+	return shape;
+}
+
+void StaticBatch::gather(const SpatialHash& hash, const std::vector<Entity>& statics) {
+	count = statics.size();
+	blocks.resize((count + 3) / 4);
+	hits.resize(blocks.size() * 4);
+	for (size_t b = 0; b < blocks.size(); b++) {
+		StaticShapes4& block = blocks[b];
+		block.axis_aligned = true;
+		for (int lane = 0; lane < 4; lane++) {
+			size_t i = std::min(b * 4 + lane, count - 1);
+			const StaticShape& shape = hash.shapes[statics[i].index()];
+			block.center_x[lane] = shape.center.x;
+			block.center_y[lane] = shape.center.y;
+			block.half_extent[lane] = shape.half_extent;
+			block.half_diagonal[lane] = shape.half_diagonal;
+			for (int c = 0; c < 4; c++) {
+				block.corner_x[c][lane] = shape.corners[c].x;
+				block.corner_y[c][lane] = shape.corners[c].y;
+			}
+			for (int a = 0; a < 2; a++) {
+				block.edge_normal_x[a][lane] = shape.edge_normals[a].x;
+				block.edge_normal_y[a][lane] = shape.edge_normals[a].y;
+				block.unit_normal_x[a][lane] = shape.unit_normals[a].x;
+				block.unit_normal_y[a][lane] = shape.unit_normals[a].y;
+			}
+			block.box_min_x[lane] = shape.box_min.x;
+			block.box_min_y[lane] = shape.box_min.y;
+			block.box_max_x[lane] = shape.box_max.x;
+			block.box_max_y[lane] = shape.box_max.y;
+			block.axis_aligned = block.axis_aligned && shape.axis_aligned;
+		}
+	}
+}
+
+#ifndef SAT_USE_SSE2
+// Projects the corners of one lane onto axis
+static void project_lane(const StaticShapes4& s, int lane, vec2 axis, float& min, float& max) {
+	min = max = s.corner_x[0][lane] * axis.x + s.corner_y[0][lane] * axis.y;
+	for (int c = 1; c < 4; c++) {
+		float projection = s.corner_x[c][lane] * axis.x + s.corner_y[c][lane] * axis.y;
+		min = std::min(min, projection);
+		max = std::max(max, projection);
+	}
+}
+
+// One lane of the circle kernel, for platforms without SSE
+static bool circle_hits_lane(const StaticShapes4& s, int lane, vec2 center, float radius) {
+	float dx = s.center_x[lane] - center.x;
+	float dy = s.center_y[lane] - center.y;
+	float max_distance = s.half_extent[lane] + radius;
+	if (dx * dx + dy * dy > max_distance * max_distance)
+		return false;
+
+	vec2 closest = { s.corner_x[0][lane], s.corner_y[0][lane] };
+	float min_dist_sq = std::numeric_limits<float>::max();
+	for (int c = 0; c < 4; c++) {
+		float dist_sq = (s.corner_x[c][lane] - center.x) * (s.corner_x[c][lane] - center.x) + (s.corner_y[c][lane] - center.y) * (s.corner_y[c][lane] - center.y);
+		if (dist_sq < min_dist_sq) {
+			min_dist_sq = dist_sq;
+			closest = { s.corner_x[c][lane], s.corner_y[c][lane] };
+		}
+	}
+
+	vec2 axes[3] = {
+		{ s.unit_normal_x[0][lane], s.unit_normal_y[0][lane] },
+		{ s.unit_normal_x[1][lane], s.unit_normal_y[1][lane] },
+		closest - center
+	};
+	float length_sq = axes[2].x * axes[2].x + axes[2].y * axes[2].y;
+	if (length_sq == 0)
+		axes[2] = vec2(0.f); // skipped like an empty edge, a zero axis never separates
+	else
+		axes[2] = axes[2] / std::sqrt(length_sq);
+
+	for (const vec2& axis : axes) {
+		float min_rect, max_rect;
+		project_lane(s, lane, axis, min_rect, max_rect);
+		float projection = center.x * axis.x + center.y * axis.y;
+		if (max_rect < projection - radius || projection + radius < min_rect)
+			return false;
+	}
+	return true;
+}
+
+// One lane of the box kernel
+static bool box_hits_lane(const StaticShapes4& s, int lane, vec2 center, const std::array<vec2, 4>& corners, float half_diagonal, const vec2* moving_axes) {
+	float dx = s.center_x[lane] - center.x;
+	float dy = s.center_y[lane] - center.y;
+	float total_radius = s.half_diagonal[lane] + half_diagonal;
+	if (dx * dx + dy * dy > total_radius * total_radius)
+		return false;
+
+	vec2 axes[4] = {
+		{ s.edge_normal_x[0][lane], s.edge_normal_y[0][lane] },
+		{ s.edge_normal_x[1][lane], s.edge_normal_y[1][lane] },
+		moving_axes[0],
+		moving_axes[1]
+	};
+	for (const vec2& axis : axes) {
+		float min_static, max_static;
+		project_lane(s, lane, axis, min_static, max_static);
+		float min_moving = corners[0].x * axis.x + corners[0].y * axis.y;
+		float max_moving = min_moving;
+		for (int c = 1; c < 4; c++) {
+			float projection = corners[c].x * axis.x + corners[c].y * axis.y;
+			min_moving = std::min(min_moving, projection);
+			max_moving = std::max(max_moving, projection);
+		}
+		if (max_static < min_moving || max_moving < min_static)
+			return false;
+	}
+	return true;
+}
+
+#else
+// Min and max of the corners of four statics projected onto one axis per lane
+static inline void project_x4(const StaticShapes4& s, __m128 axis_x, __m128 axis_y, __m128& min, __m128& max) {
+	min = max = _mm_add_ps(_mm_mul_ps(_mm_load_ps(s.corner_x[0]), axis_x), _mm_mul_ps(_mm_load_ps(s.corner_y[0]), axis_y));
+	for (int c = 1; c < 4; c++) {
+		__m128 projection = _mm_add_ps(_mm_mul_ps(_mm_load_ps(s.corner_x[c]), axis_x), _mm_mul_ps(_mm_load_ps(s.corner_y[c]), axis_y));
+		min = _mm_min_ps(min, projection);
+		max = _mm_max_ps(max, projection);
+	}
+}
+
+// Circle against four statics, returns one bit per lane that touches
+static inline int circle_hits_x4(const StaticShapes4& s, __m128 cx, __m128 cy, __m128 r) {
+	__m128 dx = _mm_sub_ps(_mm_load_ps(s.center_x), cx);
+	__m128 dy = _mm_sub_ps(_mm_load_ps(s.center_y), cy);
+	__m128 max_distance = _mm_add_ps(_mm_load_ps(s.half_extent), r);
+	__m128 gap = _mm_cmpgt_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(max_distance, max_distance));
+	if (_mm_movemask_ps(gap) == 0xF)
+		return 0;
+
+	__m128 circle_min_x = _mm_sub_ps(cx, r);
+	__m128 circle_max_x = _mm_add_ps(cx, r);
+	__m128 circle_min_y = _mm_sub_ps(cy, r);
+	__m128 circle_max_y = _mm_add_ps(cy, r);
+	if (s.axis_aligned) {
+		// projecting onto (0, 1) and (-1, 0) reads y and -x, so the two edge axes are interval tests against the bounds
+		gap = _mm_or_ps(gap, _mm_cmplt_ps(_mm_load_ps(s.box_max_y), circle_min_y));
+		gap = _mm_or_ps(gap, _mm_cmplt_ps(circle_max_y, _mm_load_ps(s.box_min_y)));
+		gap = _mm_or_ps(gap, _mm_cmplt_ps(_mm_load_ps(s.box_max_x), circle_min_x));
+		gap = _mm_or_ps(gap, _mm_cmplt_ps(circle_max_x, _mm_load_ps(s.box_min_x)));
+	}
+	else {
+		for (int a = 0; a < 2; a++) {
+			__m128 axis_x = _mm_load_ps(s.unit_normal_x[a]);
+			__m128 axis_y = _mm_load_ps(s.unit_normal_y[a]);
+			__m128 min_rect, max_rect;
+			project_x4(s, axis_x, axis_y, min_rect, max_rect);
+			__m128 projection = _mm_add_ps(_mm_mul_ps(cx, axis_x), _mm_mul_ps(cy, axis_y));
+			gap = _mm_or_ps(gap, _mm_cmplt_ps(max_rect, _mm_sub_ps(projection, r)));
+			gap = _mm_or_ps(gap, _mm_cmplt_ps(_mm_add_ps(projection, r), min_rect));
+		}
+	}
+
+	// axis from the circle to the closest corner, the first corner wins a tie
+	__m128 closest_x = _mm_load_ps(s.corner_x[0]);
+	__m128 closest_y = _mm_load_ps(s.corner_y[0]);
+	__m128 min_dist_sq = _mm_set1_ps(std::numeric_limits<float>::max());
+	for (int c = 0; c < 4; c++) {
+		__m128 corner_x = _mm_load_ps(s.corner_x[c]);
+		__m128 corner_y = _mm_load_ps(s.corner_y[c]);
+		__m128 to_x = _mm_sub_ps(corner_x, cx);
+		__m128 to_y = _mm_sub_ps(corner_y, cy);
+		__m128 dist_sq = _mm_add_ps(_mm_mul_ps(to_x, to_x), _mm_mul_ps(to_y, to_y));
+		__m128 closer = _mm_cmplt_ps(dist_sq, min_dist_sq);
+		min_dist_sq = _mm_or_ps(_mm_and_ps(closer, dist_sq), _mm_andnot_ps(closer, min_dist_sq));
+		closest_x = _mm_or_ps(_mm_and_ps(closer, corner_x), _mm_andnot_ps(closer, closest_x));
+		closest_y = _mm_or_ps(_mm_and_ps(closer, corner_y), _mm_andnot_ps(closer, closest_y));
+	}
+	__m128 axis_x = _mm_sub_ps(closest_x, cx);
+	__m128 axis_y = _mm_sub_ps(closest_y, cy);
+	__m128 length_sq = _mm_add_ps(_mm_mul_ps(axis_x, axis_x), _mm_mul_ps(axis_y, axis_y));
+	__m128 length = _mm_sqrt_ps(length_sq);
+	axis_x = _mm_div_ps(axis_x, length);
+	axis_y = _mm_div_ps(axis_y, length);
+	__m128 min_rect, max_rect;
+	project_x4(s, axis_x, axis_y, min_rect, max_rect);
+	__m128 projection = _mm_add_ps(_mm_mul_ps(cx, axis_x), _mm_mul_ps(cy, axis_y));
+	__m128 corner_gap = _mm_or_ps(_mm_cmplt_ps(max_rect, _mm_sub_ps(projection, r)), _mm_cmplt_ps(_mm_add_ps(projection, r), min_rect));
+	// a zero axis is skipped
+	corner_gap = _mm_andnot_ps(_mm_cmpeq_ps(length_sq, _mm_setzero_ps()), corner_gap);
+	gap = _mm_or_ps(gap, corner_gap);
+
+	return ~_mm_movemask_ps(gap) & 0xF;
+}
+
+// Box against four statics, returns one bit per lane that touches
+static inline int box_hits_x4(const StaticShapes4& s, vec2 center, const std::array<vec2, 4>& corners, float half_diagonal, const vec2* moving_axes) {
+	__m128 dx = _mm_sub_ps(_mm_load_ps(s.center_x), _mm_set1_ps(center.x));
+	__m128 dy = _mm_sub_ps(_mm_load_ps(s.center_y), _mm_set1_ps(center.y));
+	__m128 total_radius = _mm_add_ps(_mm_load_ps(s.half_diagonal), _mm_set1_ps(half_diagonal));
+	__m128 gap = _mm_cmpgt_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(total_radius, total_radius));
+	if (_mm_movemask_ps(gap) == 0xF)
+		return 0;
+
+	// the edge axes of the statics, one per lane
+	for (int a = 0; a < 2; a++) {
+		__m128 axis_x = _mm_load_ps(s.edge_normal_x[a]);
+		__m128 axis_y = _mm_load_ps(s.edge_normal_y[a]);
+		__m128 min_static, max_static;
+		project_x4(s, axis_x, axis_y, min_static, max_static);
+		__m128 min_moving = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(corners[0].x), axis_x), _mm_mul_ps(_mm_set1_ps(corners[0].y), axis_y));
+		__m128 max_moving = min_moving;
+		for (int c = 1; c < 4; c++) {
+			__m128 projection = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(corners[c].x), axis_x), _mm_mul_ps(_mm_set1_ps(corners[c].y), axis_y));
+			min_moving = _mm_min_ps(min_moving, projection);
+			max_moving = _mm_max_ps(max_moving, projection);
+		}
+		gap = _mm_or_ps(gap, _mm_or_ps(_mm_cmplt_ps(max_static, min_moving), _mm_cmplt_ps(max_moving, min_static)));
+	}
+
+	// the edge axes of the moving box, the same in every lane
+	for (int a = 0; a < 2; a++) {
+		vec2 axis = moving_axes[a];
+		float min_moving = corners[0].x * axis.x + corners[0].y * axis.y;
+		float max_moving = min_moving;
+		for (int c = 1; c < 4; c++) {
+			float projection = corners[c].x * axis.x + corners[c].y * axis.y;
+			min_moving = std::min(min_moving, projection);
+			max_moving = std::max(max_moving, projection);
+		}
+		__m128 min_static, max_static;
+		project_x4(s, _mm_set1_ps(axis.x), _mm_set1_ps(axis.y), min_static, max_static);
+		gap = _mm_or_ps(gap, _mm_or_ps(_mm_cmplt_ps(max_static, _mm_set1_ps(min_moving)), _mm_cmplt_ps(_mm_set1_ps(max_moving), min_static)));
+	}
+
+	return ~_mm_movemask_ps(gap) & 0xF;
+}
+#endif
+
+void StaticBatch::test_circle(vec2 center, float radius) {
+#ifdef SAT_USE_SSE2
+	__m128 cx = _mm_set1_ps(center.x);
+	__m128 cy = _mm_set1_ps(center.y);
+	__m128 r = _mm_set1_ps(radius);
+	for (size_t b = 0; b < blocks.size(); b++) {
+		int mask = circle_hits_x4(blocks[b], cx, cy, r);
+		for (int lane = 0; lane < 4; lane++)
+			hits[b * 4 + lane] = (mask >> lane) & 1;
+	}
+#else
+	for (size_t b = 0; b < blocks.size(); b++)
+		for (int lane = 0; lane < 4; lane++)
+			hits[b * 4 + lane] = circle_hits_lane(blocks[b], lane, center, radius);
+#endif
+}
+
+void StaticBatch::test_box(vec2 center, const std::array<vec2, 4>& corners, vec2 box) {
+	float half_width = box.x / 2.0f;
+	float half_height = box.y / 2.0f;
+	float half_diagonal = std::sqrt(half_width * half_width + half_height * half_height);
+	// normals of the third and fourth edge, the ones AABBSAT takes from its second box
+	vec2 moving_axes[2];
+	for (int a = 0; a < 2; a++) {
+		vec2 edge = vec2{ corners[(a + 3) % 4].x - corners[a + 2].x, corners[(a + 3) % 4].y - corners[a + 2].y };
+		moving_axes[a] = vec2{ -edge.y, edge.x };
+	}
+#ifdef SAT_USE_SSE2
+	for (size_t b = 0; b < blocks.size(); b++) {
+		int mask = box_hits_x4(blocks[b], center, corners, half_diagonal, moving_axes);
+		for (int lane = 0; lane < 4; lane++)
+			hits[b * 4 + lane] = (mask >> lane) & 1;
+	}
+#else
+	for (size_t b = 0; b < blocks.size(); b++)
+		for (int lane = 0; lane < 4; lane++)
+			hits[b * 4 + lane] = box_hits_lane(blocks[b], lane, center, corners, half_diagonal, moving_axes);
+#endif
+}
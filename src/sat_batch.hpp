@@ -0,0 +1,65 @@
+#pragma once
+
+#include "common.hpp"
+#include "tinyECS/components.hpp"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// Collision shape helpers, shared by the SAT tests of the physics system and the static shape cache of the spatial hash
+vec2 get_relative_center(vec2 position, float angle, vec2 offset);
+std::array<vec2, 4> get_rotated_corners(const vec2& center, const vec2& size, float angle);
+
+// The scalar SAT tests of two boxes and of a box and a circle, each box given by its center, corners and AABB
+bool AABBSAT(vec2& center_i, std::array<vec2, 4>& corners_i, AABB& AABB_i, vec2& center_j, std::array<vec2, 4>& corners_j, AABB& AABB_j, float delta_time);
+bool AABBCircleSAT(vec2& rect_center, AABB& rect_aabb, std::array<vec2, 4>& rect_corners, vec2& circle_center, CircleBound& circle_bound, Motion& circle_motion, float delta_time);
+
+// Shape of a static collider as the SAT tests see it, from its frozen Motion and its AABB
+StaticShape make_static_shape(const Motion& motion, const AABB& aabb);
+
+// Four static shapes in structure of arrays form, lane i of every field belongs to the same static.
+// The batch kernels test one moving body against all four lanes at once.
+struct alignas(16) StaticShapes4
+{
+	float center_x[4];
+	float center_y[4];
+	float half_extent[4];
+	float half_diagonal[4];
+	float corner_x[4][4]; // [corner][lane]
+	float corner_y[4][4];
+	float edge_normal_x[2][4];
+	float edge_normal_y[2][4];
+	float unit_normal_x[2][4];
+	float unit_normal_y[2][4];
+	float box_min_x[4];
+	float box_min_y[4];
+	float box_max_x[4];
+	float box_max_y[4];
+	bool axis_aligned; // every lane is axis aligned
+};
+
+// Static shapes near one moving body, gathered from the spatial hash once and then tested by the kernels below.
+// The results match AABBCircleSAT and AABBSAT fed with the same statics, bit for bit.
+class StaticBatch
+{
+public:
+	// Copies the cached shapes of statics into blocks of four, the last block is padded with copies of the last static
+	void gather(const SpatialHash& hash, const std::vector<Entity>& statics);
+
+	size_t size() const { return count; }
+
+	// hit(i) tells if the moving body touches statics[i] of the last gather
+	bool hit(size_t i) const { return hits[i] != 0; }
+
+	// Same result as AABBCircleSAT for every static
+	void test_circle(vec2 center, float radius);
+
+	// Same result as AABBSAT with the static first for every static, corners from get_rotated_corners()
+	void test_box(vec2 center, const std::array<vec2, 4>& corners, vec2 box);
+
+private:
+	std::vector<StaticShapes4> blocks;
+	std::vector<uint8_t> hits;
+	size_t count = 0;
+};
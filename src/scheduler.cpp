@@ -0,0 +1,193 @@
+#include "scheduler.hpp"
+#include "world.hpp"
+
+#include <algorithm>
+#include <assert.h>
+#include <stdio.h>
+
+Scheduler& scheduler() {
+	return world().scheduler;
+}
+
+void SystemSchedule::add(const char* name, SystemAccess access, std::function<void(float)> run) {
+	size_t index = tasks.size();
+	Task task;
+	task.name = name;
+	task.access = access;
+	task.run = std::move(run);
+	for (size_t i = 0; i < index; i++) {
+		if (tasks[i].access.conflicts(access)) {
+			tasks[i].dependents.push_back(index);
+			task.dependency_count++;
+		}
+	}
+	tasks.push_back(std::move(task));
+}
+
+void SystemSchedule::print() const {
+	for (size_t i = 0; i < tasks.size(); i++) {
+		printf("%-20s waits for:", tasks[i].name);
+		for (size_t j = 0; j < i; j++) {
+			for (size_t dependent : tasks[j].dependents) {
+				if (dependent == i)
+					printf(" %s", tasks[j].name);
+			}
+		}
+		printf("\n");
+	}
+}
+
+Scheduler::~Scheduler() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	wake.notify_all();
+	for (std::thread& worker : workers)
+		worker.join();
+}
+
+void Scheduler::init(unsigned int worker_count, World* world) {
+	assert(worker_count < MAX_THREADS && "Per thread buffers only have room for MAX_THREADS threads");
+	for (unsigned int i = 0; i < worker_count; i++)
+		workers.emplace_back(&Scheduler::worker_loop, this, i + 1, world);
+}
+
+unsigned int Scheduler::thread_count() const {
+	return debugging.single_threaded_systems ? 1 : (unsigned int)workers.size() + 1;
+}
+
+void Scheduler::run(SystemSchedule& schedule, float elapsed_ms) {
+	// deterministic fallback, the declaration order is a valid order of the dependency graph
+	if (workers.empty() || debugging.single_threaded_systems) {
+		for (auto& task : schedule.tasks)
+			task.run(elapsed_ms);
+		return;
+	}
+
+	std::unique_lock<std::mutex> lock(mutex);
+	this->schedule = &schedule;
+	this->elapsed_ms = elapsed_ms;
+	finished = 0;
+	waiting_for.resize(schedule.tasks.size());
+	ready.clear();
+	// pushed back to front so that ready systems are picked up in declaration order
+	for (size_t i = schedule.tasks.size(); i-- > 0;) {
+		waiting_for[i] = schedule.tasks[i].dependency_count;
+		if (waiting_for[i] == 0)
+			ready.push_back(i);
+	}
+	wake.notify_all();
+
+	// the calling thread works on the schedule as well instead of only waiting for it
+	while (finished < schedule.tasks.size()) {
+		if (!help(lock))
+			wake.wait(lock);
+	}
+	this->schedule = nullptr;
+}
+
+void Scheduler::parallel_for(size_t count, size_t grain, const std::function<void(size_t, size_t)>& fn) {
+	grain = std::max<size_t>(grain, 1);
+	unsigned int threads = thread_count();
+	if (threads == 1 || count <= grain) {
+		for (size_t begin = 0; begin < count; begin += grain)
+			fn(begin, std::min(begin + grain, count));
+		return;
+	}
+
+	ParallelJob job;
+	job.fn = &fn;
+	job.grain = grain;
+	job.share_count = threads;
+	size_t share_size = (count + threads - 1) / threads;
+	for (unsigned int i = 0; i < threads; i++) {
+		job.shares[i].next = std::min(i * share_size, count);
+		job.shares[i].end = std::min((i + 1) * share_size, count);
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		jobs.push_back(&job);
+	}
+	wake.notify_all();
+
+	work_on(job);
+
+	std::unique_lock<std::mutex> lock(mutex);
+	remove_job(job);
+	job_done.wait(lock, [&job] { return job.helpers == 0; });
+}
+
+void Scheduler::worker_loop(unsigned int thread_index, World* world) {
+	ThreadIndex::current = thread_index;
+	world->make_current();
+	std::unique_lock<std::mutex> lock(mutex);
+	while (!stopping) {
+		if (!help(lock))
+			wake.wait(lock);
+	}
+}
+
+// Works on a parallel loop, or else runs one ready system. Returns false if there was nothing to do
+bool Scheduler::help(std::unique_lock<std::mutex>& lock) {
+	if (!jobs.empty()) {
+		ParallelJob& job = *jobs.back();
+		job.helpers++;
+		lock.unlock();
+		work_on(job);
+		lock.lock();
+		// every share is used up once work_on returns, so nobody needs to pick the job up again
+		remove_job(job);
+		if (--job.helpers == 0)
+			job_done.notify_all();
+		return true;
+	}
+	if (!ready.empty()) {
+		run_ready_task(lock);
+		return true;
+	}
+	return false;
+}
+
+// Takes chunks from the calling thread's share first and then from the shares of the others
+void Scheduler::work_on(ParallelJob& job) {
+	unsigned int home = ThreadIndex::current % job.share_count;
+	for (unsigned int i = 0; i < job.share_count; i++) {
+		ParallelJob::Share& share = job.shares[(home + i) % job.share_count];
+		while (true) {
+			size_t begin = share.next.fetch_add(job.grain);
+			if (begin >= share.end)
+				break;
+			(*job.fn)(begin, std::min(begin + job.grain, share.end));
+		}
+	}
+}
+
+void Scheduler::remove_job(ParallelJob& job) {
+	auto it = std::find(jobs.begin(), jobs.end(), &job);
+	if (it != jobs.end())
+		jobs.erase(it);
+}
+
+// Runs one ready system with the lock released and then releases the systems waiting for it
+void Scheduler::run_ready_task(std::unique_lock<std::mutex>& lock) {
+	size_t index = ready.back();
+	ready.pop_back();
+	SystemSchedule::Task& task = schedule->tasks[index];
+
+	lock.unlock();
+	task.run(elapsed_ms);
+	lock.lock();
+
+	finished++;
+	bool notify = finished == schedule->tasks.size();
+	for (size_t dependent : task.dependents) {
+		if (--waiting_for[dependent] == 0) {
+			ready.push_back(dependent);
+			notify = true;
+		}
+	}
+	if (notify)
+		wake.notify_all();
+}
@@ -0,0 +1,179 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "tinyECS/registry.hpp"
+#include "tinyECS/per_thread.hpp"
+
+class World;
+
+// Shared state a system can touch besides the component containers
+enum class SYSTEM_RESOURCE {
+	ENTITIES = 0,   // registry().create(), registry().destroy() and registry().commands
+	AUDIO = 1,
+	GAME_STATE = 2, // game state of the world system, screen state, renderer
+};
+
+// The containers a system reads and writes. Creating an entity with a helper like createProjectile()
+// writes every container the helper inserts into. Inserting into or removing from a container of an owning group
+// moves components in the group's other containers, so it writes all of them.
+// Two systems conflict if one of them writes something the other one reads or writes, or if they use the same resource.
+struct SystemAccess
+{
+	uint64_t reads = 0;
+	uint64_t writes = 0;
+	uint32_t resources = 0;
+
+	template <typename... Components>
+	SystemAccess& read() {
+		reads |= (ECSRegistry::signature_mask<Components>() | ... | 0);
+		return *this;
+	}
+
+	template <typename... Components>
+	SystemAccess& write() {
+		writes |= (ECSRegistry::signature_mask<Components>() | ... | 0);
+		return *this;
+	}
+
+	SystemAccess& use(SYSTEM_RESOURCE resource) {
+		resources |= 1u << (int)resource;
+		return *this;
+	}
+
+	// Conflicts with everything, for systems that touch too much to list and for sync points like flush_commands()
+	static SystemAccess exclusive() {
+		SystemAccess access;
+		access.reads = ~0ull;
+		access.writes = ~0ull;
+		access.resources = ~0u;
+		return access;
+	}
+
+	bool conflicts(const SystemAccess& other) const {
+		return (writes & (other.reads | other.writes)) || (reads & other.writes) || (resources & other.resources);
+	}
+};
+
+// The systems of one frame in their single thread order.
+// A system depends on every earlier system it conflicts with, so the dependency graph follows the declaration order
+// and running the systems one after another in that order is always valid.
+class SystemSchedule
+{
+public:
+	void add(const char* name, SystemAccess access, std::function<void(float)> run);
+
+	size_t size() const { return tasks.size(); }
+
+	// Prints every system with the systems it waits for
+	void print() const;
+
+private:
+	friend class Scheduler;
+
+	struct Task
+	{
+		const char* name;
+		SystemAccess access;
+		std::function<void(float)> run;
+		std::vector<size_t> dependents; // later systems that wait for this one
+		int dependency_count = 0;
+	};
+	std::vector<Task> tasks;
+};
+
+// Runs a SystemSchedule on the calling thread plus a pool of worker threads. Every World has its own, see scheduler().
+// Systems start as soon as all systems they depend on are done, so systems that do not conflict run at the same time.
+// Inside a system, parallel_for() splits a loop over the same threads.
+// With no workers, or with debugging.single_threaded_systems, everything runs on the calling thread in declaration order.
+class Scheduler
+{
+public:
+	// Elements per chunk of a parallel loop that does not pick its own grain
+	static constexpr size_t DEFAULT_GRAIN = 256;
+
+	~Scheduler();
+
+	// Starts the worker threads, 0 workers runs everything on the calling thread.
+	// The workers make world current on their thread, so the systems they run see the same world as the calling thread
+	void init(unsigned int worker_count, World* world);
+
+	// Runs every system of the schedule once and returns when all of them are done
+	void run(SystemSchedule& schedule, float elapsed_ms);
+
+	// Calls fn(begin, end) for chunks of [0, count) of at most grain elements and returns when all of them are done.
+	// The calling thread and every idle worker take chunks. Each thread starts on its own contiguous share of the range
+	// and then steals chunks from the shares of the others, so uneven chunks even out.
+	// Chunks run at the same time: fn may only write to the elements of its chunk and records structural changes
+	// in registry().local_commands().
+	void parallel_for(size_t count, size_t grain, const std::function<void(size_t, size_t)>& fn);
+
+	// Threads that systems run on, including the calling one
+	unsigned int thread_count() const;
+
+private:
+	// A running parallel_for, lives on the stack of its caller
+	struct ParallelJob
+	{
+		// chunks are taken from the front of a share by its owner and by thieves alike
+		struct alignas(64) Share
+		{
+			std::atomic<size_t> next{ 0 };
+			size_t end = 0;
+		};
+
+		const std::function<void(size_t, size_t)>* fn = nullptr;
+		size_t grain = 0;
+		unsigned int share_count = 0;
+		Share shares[MAX_THREADS];
+		int helpers = 0; // threads other than the caller working on it, guarded by mutex
+	};
+
+	void worker_loop(unsigned int thread_index, World* world);
+	bool help(std::unique_lock<std::mutex>& lock);
+	void run_ready_task(std::unique_lock<std::mutex>& lock);
+	void work_on(ParallelJob& job);
+	void remove_job(ParallelJob& job);
+
+	std::vector<std::thread> workers;
+	std::mutex mutex;
+	std::condition_variable wake; // a system became ready, a parallel loop started, the schedule finished or the workers are stopping
+	std::condition_variable job_done; // the last helper left a parallel loop
+	bool stopping = false;
+
+	// parallel loops with chunks left, guarded by mutex
+	std::vector<ParallelJob*> jobs;
+
+	// the schedule being run, guarded by mutex
+	SystemSchedule* schedule = nullptr;
+	float elapsed_ms = 0.f;
+	std::vector<int> waiting_for; // per system, dependencies that are not done yet
+	std::vector<size_t> ready;
+	size_t finished = 0;
+};
+
+// The scheduler of the world the calling thread works on
+Scheduler& scheduler();
+
+// Calls fn(Entity, Components&...) for every entity of the view like View::each, spread over the scheduler's threads.
+// Chunks are ranges of the view's driving container, see Scheduler::parallel_for for what fn may do.
+template <typename... Components, typename Fn>
+void parallel_for_each(View<Components...> view, Fn fn, size_t grain = Scheduler::DEFAULT_GRAIN)
+{
+	scheduler().parallel_for(view.size_hint(), grain, [&](size_t begin, size_t end) { view.each_range(begin, end, fn); });
+}
+
+// Calls fn(Entity, Component&) for every component of a container, spread over the scheduler's threads
+template <typename Component, typename Fn>
+void parallel_for_each(ComponentContainer<Component>& container, Fn fn, size_t grain = Scheduler::DEFAULT_GRAIN)
+{
+	scheduler().parallel_for(container.size(), grain, [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; i++)
+			fn(container.entities[i], container.components[i]);
+	});
+}
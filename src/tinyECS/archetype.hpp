@@ -0,0 +1,288 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <assert.h>
+
+#include "tiny_ecs.hpp"
+
+// Opt-in storage for entities that always carry the same set of components, e.g. projectiles.
+// Entities are packed into fixed size chunks; inside a chunk every component type has its own
+// contiguous array (structure of arrays), so a pass over one archetype streams memory linearly.
+// It has the same operations as a ComponentContainer, so it can be added to the registry next to the regular
+// ComponentContainers and systems can be migrated one at a time.
+template <typename... Components>
+class Archetype : public ContainerBase
+{
+public:
+	static constexpr size_t CHUNK_BYTES = 16 * 1024;
+	static constexpr size_t COMPONENT_COUNT = sizeof...(Components);
+
+private:
+	using ComponentTuple = std::tuple<Components...>;
+
+	template <size_t I>
+	using ComponentAt = std::tuple_element_t<I, ComponentTuple>;
+
+	static constexpr std::array<size_t, COMPONENT_COUNT + 1> SIZES = { sizeof(Entity), sizeof(Components)... };
+	static constexpr std::array<size_t, COMPONENT_COUNT + 1> ALIGNS = { alignof(Entity), alignof(Components)... };
+
+	// Rows per chunk, leaving room for the padding between the arrays
+	static constexpr size_t compute_capacity()
+	{
+		size_t row_bytes = 0, padding = 0;
+		for (size_t i = 0; i < SIZES.size(); i++)
+		{
+			row_bytes += SIZES[i];
+			padding += ALIGNS[i] - 1;
+		}
+		return (CHUNK_BYTES - padding) / row_bytes;
+	}
+
+public:
+	static constexpr size_t CHUNK_CAPACITY = compute_capacity();
+	static_assert(CHUNK_CAPACITY > 0, "Archetype row does not fit into a chunk");
+
+private:
+	// Byte offset of every array inside a chunk, the entity array comes first
+	static constexpr std::array<size_t, COMPONENT_COUNT + 1> compute_offsets()
+	{
+		std::array<size_t, COMPONENT_COUNT + 1> offsets = {};
+		size_t offset = 0;
+		for (size_t i = 0; i < SIZES.size(); i++)
+		{
+			offset = (offset + ALIGNS[i] - 1) / ALIGNS[i] * ALIGNS[i];
+			offsets[i] = offset;
+			offset += SIZES[i] * CHUNK_CAPACITY;
+		}
+		return offsets;
+	}
+	static constexpr std::array<size_t, COMPONENT_COUNT + 1> OFFSETS = compute_offsets();
+
+	struct Chunk
+	{
+		alignas(std::max_align_t) unsigned char data[CHUNK_BYTES];
+		size_t count = 0;
+
+		Entity* entities() { return reinterpret_cast<Entity*>(data + OFFSETS[0]); }
+
+		template <size_t I>
+		ComponentAt<I>* array() { return reinterpret_cast<ComponentAt<I>*>(data + OFFSETS[I + 1]); }
+	};
+
+	static constexpr unsigned int INVALID_SLOT = 0xFFFFFFFFu;
+
+	std::vector<std::unique_ptr<Chunk>> chunks;
+	std::unique_ptr<Chunk> spare_chunk; // kept around so that churn at a chunk boundary does not reallocate
+	std::vector<unsigned int> slots;    // entity index -> chunk * CHUNK_CAPACITY + row
+	size_t count = 0;
+
+	template <typename T, size_t I = 0>
+	static constexpr size_t index_of()
+	{
+		static_assert(I < COMPONENT_COUNT, "Component is not part of this archetype");
+		if constexpr (std::is_same_v<T, ComponentAt<I>>)
+			return I;
+		else
+			return index_of<T, I + 1>();
+	}
+
+	unsigned int slot_of(Entity e) const
+	{
+		if (e.index() >= slots.size())
+			return INVALID_SLOT;
+		unsigned int slot = slots[e.index()];
+		if (slot == INVALID_SLOT || chunks[slot / CHUNK_CAPACITY]->entities()[slot % CHUNK_CAPACITY].id() != e.id())
+			return INVALID_SLOT;
+		return slot;
+	}
+
+	template <size_t... I>
+	void construct_row(Chunk& chunk, size_t row, std::index_sequence<I...>, Components&&... cs)
+	{
+		(new (&chunk.template array<I>()[row]) ComponentAt<I>(std::move(cs)), ...);
+	}
+
+	template <size_t... I>
+	void move_row(Chunk& to, size_t to_row, Chunk& from, size_t from_row, std::index_sequence<I...>)
+	{
+		((to.template array<I>()[to_row] = std::move(from.template array<I>()[from_row])), ...);
+	}
+
+	template <size_t... I>
+	void destroy_row(Chunk& chunk, size_t row, std::index_sequence<I...>)
+	{
+		(std::destroy_at(&chunk.template array<I>()[row]), ...);
+	}
+
+	template <typename Fn, size_t... I>
+	void each_in_chunk(Chunk& chunk, Fn& fn, std::index_sequence<I...>)
+	{
+		Entity* entities = chunk.entities();
+		std::tuple<Components*...> arrays(chunk.template array<I>()...);
+		for (size_t row = 0; row < chunk.count; row++)
+			fn(entities[row], std::get<I>(arrays)[row]...);
+	}
+
+	template <typename Fn, size_t... I>
+	void call_with_arrays(Chunk& chunk, Fn& fn, std::index_sequence<I...>)
+	{
+		fn(chunk.count, chunk.entities(), chunk.template array<I>()...);
+	}
+
+public:
+	Archetype() = default;
+	Archetype(const Archetype&) = delete;
+	Archetype& operator=(const Archetype&) = delete;
+
+	~Archetype()
+	{
+		clear();
+	}
+
+	// Inserting an entity together with all of its components
+	void insert(Entity e, Components... cs)
+	{
+		assert(!has(e) && "Entity already contained in archetype");
+
+		if (chunks.empty() || chunks.back()->count == CHUNK_CAPACITY)
+			chunks.push_back(spare_chunk ? std::move(spare_chunk) : std::unique_ptr<Chunk>(new Chunk));
+
+		Chunk& chunk = *chunks.back();
+		size_t row = chunk.count;
+		new (&chunk.entities()[row]) Entity(e);
+		construct_row(chunk, row, std::index_sequence_for<Components...>{}, std::move(cs)...);
+		chunk.count++;
+
+		if (e.index() >= slots.size())
+			slots.resize(e.index() + 1, INVALID_SLOT);
+		slots[e.index()] = (unsigned int)((chunks.size() - 1) * CHUNK_CAPACITY + row);
+		count++;
+		mark_signature(e);
+		count_insert(count);
+	}
+
+	// Remove an entity and fill the hole with the last row of the last chunk
+	void remove(Entity e)
+	{
+		unsigned int slot = slot_of(e);
+		if (slot == INVALID_SLOT)
+			return;
+
+		Chunk& chunk = *chunks[slot / CHUNK_CAPACITY];
+		size_t row = slot % CHUNK_CAPACITY;
+		Chunk& last = *chunks.back();
+		size_t last_row = last.count - 1;
+
+		if (&chunk != &last || row != last_row)
+		{
+			Entity moved = last.entities()[last_row];
+			move_row(chunk, row, last, last_row, std::index_sequence_for<Components...>{});
+			chunk.entities()[row] = moved;
+			slots[moved.index()] = slot;
+		}
+		destroy_row(last, last_row, std::index_sequence_for<Components...>{});
+		last.count--;
+		slots[e.index()] = INVALID_SLOT;
+		count--;
+		unmark_signature(e);
+		count_removes(1);
+
+		if (last.count == 0)
+		{
+			spare_chunk = std::move(chunks.back());
+			chunks.pop_back();
+		}
+	}
+
+	bool has(Entity e)
+	{
+		return slot_of(e) != INVALID_SLOT;
+	}
+
+	template <typename T>
+	T& get(Entity e)
+	{
+		unsigned int slot = slot_of(e);
+		assert(slot != INVALID_SLOT && "Entity not contained in archetype");
+		return chunks[slot / CHUNK_CAPACITY]->template array<index_of<T>()>()[slot % CHUNK_CAPACITY];
+	}
+
+	// Calls fn(Entity, Components&...) for every entity, chunk by chunk
+	template <typename Fn>
+	void each(Fn fn)
+	{
+		for (auto& chunk : chunks)
+			each_in_chunk(*chunk, fn, std::index_sequence_for<Components...>{});
+	}
+
+	// Calls fn(size_t count, Entity*, Components*...) once per chunk, for passes that want the raw arrays
+	template <typename Fn>
+	void each_chunk(Fn fn)
+	{
+		for (auto& chunk : chunks)
+			call_with_arrays(*chunk, fn, std::index_sequence_for<Components...>{});
+	}
+
+	void clear()
+	{
+		for (auto& chunk : chunks)
+		{
+			for (size_t row = 0; row < chunk->count; row++)
+			{
+				slots[chunk->entities()[row].index()] = INVALID_SLOT;
+				unmark_signature(chunk->entities()[row]);
+				destroy_row(*chunk, row, std::index_sequence_for<Components...>{});
+			}
+			chunk->count = 0;
+		}
+		count_removes(count);
+		if (!chunks.empty() && !spare_chunk)
+			spare_chunk = std::move(chunks.front());
+		chunks.clear();
+		count = 0;
+	}
+
+	size_t size()
+	{
+		return count;
+	}
+
+	ContainerStats stats()
+	{
+		size_t chunk_count = chunks.size() + (spare_chunk ? 1 : 0);
+		size_t bytes = chunk_count * sizeof(Chunk) + chunks.capacity() * sizeof(chunks[0]) + slots.capacity() * sizeof(unsigned int);
+		return base_stats(count, chunks.size() * CHUNK_CAPACITY, bytes);
+	}
+
+	// Rows are written as one array per component type, in chunk order
+	void save(SnapshotBuffer& buffer)
+	{
+		std::vector<Entity> all_entities;
+		std::tuple<std::vector<Components>...> arrays;
+		all_entities.reserve(count);
+		each([&](Entity e, Components&... cs) {
+			all_entities.push_back(e);
+			(std::get<std::vector<Components>>(arrays).push_back(cs), ...);
+		});
+		buffer.write_array(all_entities);
+		(SnapshotHooks<Components>::save(buffer, std::get<std::vector<Components>>(arrays)), ...);
+	}
+
+	void load(SnapshotReader& reader)
+	{
+		clear();
+		std::vector<Entity> all_entities;
+		std::tuple<std::vector<Components>...> arrays;
+		reader.read_array(all_entities);
+		(SnapshotHooks<Components>::load(reader, std::get<std::vector<Components>>(arrays)), ...);
+		for (size_t i = 0; i < all_entities.size(); i++)
+			insert(all_entities[i], std::move(std::get<std::vector<Components>>(arrays)[i])...);
+	}
+};
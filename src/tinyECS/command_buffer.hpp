@@ -0,0 +1,113 @@
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "tiny_ecs.hpp"
+
+// Records structural changes (emplace, remove, destroy) made while a system iterates over
+// the containers, and applies them later in one batch at a sync point (see ECSRegistry::flush_commands).
+// Until then every container keeps its size and order, so loops can index the dense arrays directly.
+// Entities can be created right away since handing out a handle does not touch any container.
+//
+// Flush order: emplaces in the order they were recorded, then component removals, then destroys.
+// Removals and destroys are sorted and duplicates are dropped, so destroying an entity twice is harmless.
+// Commands recorded during a flush are kept for the next one.
+class CommandBuffer
+{
+	struct RemoveCommand
+	{
+		void* container;
+		void (*remove)(void* container, Entity e);
+		Entity entity;
+	};
+
+	std::vector<std::function<void()>> emplaces;
+	std::vector<RemoveCommand> removes;
+	std::vector<Entity> destroys;
+
+public:
+	// Add a component to e at the next flush
+	template <typename Container, typename Component>
+	void emplace(Container& container, Entity e, Component c)
+	{
+		emplaces.push_back([&container, e, c = std::move(c)]() mutable {
+			container.insert(e, std::move(c));
+		});
+	}
+
+	// Remove the component of e from container at the next flush
+	template <typename Container>
+	void remove(Container& container, Entity e)
+	{
+		removes.push_back({ &container, [](void* c, Entity e) { static_cast<Container*>(c)->remove(e); }, e });
+	}
+
+	// Remove all components of e and release its handle at the next flush
+	void destroy(Entity e)
+	{
+		destroys.push_back(e);
+	}
+
+	bool empty() const
+	{
+		return emplaces.empty() && removes.empty() && destroys.empty();
+	}
+
+	// Move all commands of other behind the ones recorded here, e.g. to collect the per thread buffers of a parallel loop
+	void absorb(CommandBuffer& other)
+	{
+		for (auto& apply : other.emplaces)
+			emplaces.push_back(std::move(apply));
+		removes.insert(removes.end(), other.removes.begin(), other.removes.end());
+		destroys.insert(destroys.end(), other.destroys.begin(), other.destroys.end());
+		other.clear();
+	}
+
+	// Drop all recorded commands without applying them
+	void clear()
+	{
+		emplaces.clear();
+		removes.clear();
+		destroys.clear();
+	}
+
+	// Apply all recorded commands. destroy_fn is called once per destroyed entity
+	template <typename DestroyFn>
+	void flush(DestroyFn destroy_fn)
+	{
+		if (!emplaces.empty())
+		{
+			std::vector<std::function<void()>> batch = std::move(emplaces);
+			emplaces.clear();
+			for (auto& apply : batch)
+				apply();
+		}
+
+		if (!removes.empty())
+		{
+			std::sort(removes.begin(), removes.end(), [](const RemoveCommand& a, const RemoveCommand& b) {
+				return a.container != b.container ? a.container < b.container : a.entity.id() < b.entity.id();
+			});
+			for (size_t i = 0; i < removes.size(); i++)
+			{
+				if (i > 0 && removes[i].container == removes[i - 1].container && removes[i].entity.id() == removes[i - 1].entity.id())
+					continue;
+				removes[i].remove(removes[i].container, removes[i].entity);
+			}
+			removes.clear();
+		}
+
+		if (!destroys.empty())
+		{
+			std::sort(destroys.begin(), destroys.end(), [](Entity a, Entity b) { return a.id() < b.id(); });
+			destroys.erase(std::unique(destroys.begin(), destroys.end(), [](Entity a, Entity b) { return a.id() == b.id(); }), destroys.end());
+			std::vector<Entity> batch = std::move(destroys);
+			destroys.clear();
+			for (Entity e : batch)
+				destroy_fn(e);
+		}
+	}
+};
@@ -3,6 +3,8 @@
 #include <vector>
 #include <unordered_map>
 #include <set>
+#include "snapshot.hpp"
+#include "small_containers.hpp"
 #include "../ext/stb_image/stb_image.h"
 
 // Player component
@@ -110,9 +112,13 @@ struct TilesetInfo {
 	std::string name;
 };
 
+// Paths up to this length are stored inside the PathComponent, longer ones in a pooled block
+const size_t INLINE_WAYPOINTS = 32;
+using WaypointBuffer = InlineVector<ivec2, INLINE_WAYPOINTS>;
+
 // AI pathfinding component
 struct PathComponent {
-	std::vector<ivec2> waypoints;	// grid positions from A* pathfinding
+	WaypointBuffer waypoints;		// grid positions from A* pathfinding
 	int current_index = 0;			// index into the waypoints vector
 	bool valid = false;				// true if a valid path was found
 	ivec2 target_cell = { -1, -1 };
@@ -130,7 +136,7 @@ struct Projectile {
 	bool is_gun = false;
 	bool can_bounce = false;
 	int remaining_penetrations = 0;
-	std::set<int> hit_enemies;
+	SmallFlatSet<int, 4> hit_enemies;
 	int ricochet_remaining = 0;
 };
 
@@ -149,6 +155,22 @@ struct Motion {
 	vec2  scale    = { 10, 10 };
 };
 
+// Attaches an entity to a parent entity, see ECSRegistry::set_parent().
+// The Motion of the child follows the Motion of the parent through the local transform (see TransformSystem)
+// and the child is destroyed together with its parent.
+struct Parent {
+	Entity entity;
+	vec2  local_position = { 0, 0 }; // offset in the rotated frame of the parent, not scaled since Motion::scale is a size
+	float local_angle = 0;           // added to the angle of the parent
+	vec2  local_scale = { 1, 1 };    // multiplies the scale of the parent
+	int   depth = 1;                 // 1 below a root entity, a parent always has a smaller depth than its children
+};
+
+// The children of an entity, so that destroying a parent does not have to search for them
+struct Children {
+	InlineVector<Entity, 8> entities;
+};
+
 enum class ButtonType {
 	START,
 	RESUME,
@@ -225,6 +247,9 @@ struct Debug {
 	bool disable_text_rendering = false;
 	bool disable_enemy_shooting = false;
 	bool enable_button_outlines = false; // true = button outlines
+	bool disable_restart_snapshot = false; // true = rebuild the level on every restart instead of restoring a snapshot
+	bool single_threaded_systems = false; // true = run all systems on the main thread in order, toggled with F10
+	bool profiling = false; // true = print the system times and allocations with the FPS, F11 spawns a stress test
 };
 extern Debug debugging;
 
@@ -679,6 +704,7 @@ enum class TEXTURE_ORIGIN_ID {
 };
 const int texture_origin_count = (int)TEXTURE_ORIGIN_ID::TEXTURE_ORIGIN_COUNT;
 
+// Change z_index or is_ui_element through registry().renderRequests.modify() so that the cached draw order is rebuilt
 struct RenderRequest {
 	TEXTURE_ASSET_ID   used_texture  = TEXTURE_ASSET_ID::TEXTURE_COUNT;
 	EFFECT_ASSET_ID    used_effect   = EFFECT_ASSET_ID::EFFECT_COUNT;
@@ -702,13 +728,18 @@ enum class TILE_ID {
 	TILE_COUNT = CLOSED_DOOR + 1
 };
 
+// Frames of an animation. Clips are immutable and shared by all animations playing them, see animation_init.hpp
+struct AnimationClip {
+	std::vector<TEXTURE_ASSET_ID> frames;
+};
+
 struct Animation {
 	int state = 0;
 	float counter_ms;
 	float change_time_ms;
 	bool playing;
 	bool looping;
-	std::vector<TEXTURE_ASSET_ID> textures;
+	const AnimationClip* clip = nullptr;
 };
 
 enum class WALL_DIRECTION {
@@ -751,6 +782,12 @@ struct Prop {
 	int prop_size = 1;
 };
 
+// A door of a level. MapSystem keeps Map::prop_doors in sync with the doors through the signals of their container
+struct Door {
+	vec2 cell;
+	int level;
+};
+
 struct Tile {
 	TEXTURE_ASSET_ID texture;
 	TEXTURE_ASSET_ID normal = TEXTURE_ASSET_ID::DEFAULT_NORMAL;
@@ -775,8 +812,7 @@ struct Map {
 	std::vector<std::vector<int>> tile_object_grid; // Stores the id of the Tile object in each tile of the grid
 	std::vector<std::vector<int>> room_mask; // Stores the room id of each tile in the grid
 	std::vector<ivec2> prop_doors_list;
-	std::vector<std::pair<Entity, std::vector<Entity>>> prop_doors_pair;
-	std::unordered_map<vec2, Entity, ivec2_hash> prop_doors; // Stores all the location of doors
+	std::unordered_map<vec2, Entity, ivec2_hash> prop_doors; // Door entity at each door location, follows the Door components. The second leaf of a door is its child
 	std::unordered_map<int, Tile> tiles; // Stores the Tile object themselves
 	std::vector<std::vector<WALL_DIRECTION>> wall_directions;
 	std::vector<ivec2> door_locations;
@@ -794,6 +830,40 @@ struct Map {
 	TEXTURE_ASSET_ID level_title = TEXTURE_ASSET_ID::LEVEL_0_TEXT;
 };
 
+// A registry snapshot only keeps the parts of the maps that change while a level is played (doors and what is rendered).
+// The layout is built once at startup and is left as it is.
+template <>
+struct SnapshotHooks<Map>
+{
+	struct State {
+		std::vector<std::vector<TILE_ID>> tile_id_grid;
+		std::vector<ivec2> prop_doors_list;
+		std::unordered_map<vec2, Entity, ivec2_hash> prop_doors;
+		std::vector<Entity> rendered_entities;
+		std::unordered_map<vec2, Prop, ivec2_hash> props;
+	};
+
+	static void save(SnapshotBuffer& buffer, const std::vector<Map>& maps) {
+		std::vector<State> states;
+		states.reserve(maps.size());
+		for (const Map& map : maps)
+			states.push_back({ map.tile_id_grid, map.prop_doors_list, map.prop_doors, map.rendered_entities, map.props });
+		buffer.keep(std::move(states));
+	}
+
+	static void load(SnapshotReader& reader, std::vector<Map>& maps) {
+		const std::vector<State>& states = reader.take<std::vector<State>>();
+		assert(states.size() == maps.size() && "Maps are only created at startup");
+		for (size_t i = 0; i < maps.size(); i++) {
+			maps[i].tile_id_grid = states[i].tile_id_grid;
+			maps[i].prop_doors_list = states[i].prop_doors_list;
+			maps[i].prop_doors = states[i].prop_doors;
+			maps[i].rendered_entities = states[i].rendered_entities;
+			maps[i].props = states[i].props;
+		}
+	}
+};
+
 struct GameProgress {
 	int level = 0;
 };
@@ -807,9 +877,45 @@ struct InstructionMessage {
 
 };
 
+// Collision shape of a static collider, computed once when it enters the spatial hash since statics never move.
+// Holds what get_rotated_corners() and the SAT tests would otherwise recompute every frame, see make_static_shape()
+struct StaticShape {
+	vec2 center;
+	vec2 box;                 // AABB::collision_box
+	vec2 corners[4];
+	vec2 edge_normals[2];     // normals of the first two edges, as AABBSAT projects onto them
+	vec2 unit_normals[2];     // the same normalized, as AABBCircleSAT projects onto them, zero for an empty edge
+	vec2 box_min;             // bounds of the corners
+	vec2 box_max;
+	float half_extent = 0.f;  // half the longer side
+	float half_diagonal = 0.f;
+	bool axis_aligned = false; // the unit normals are exactly (0, 1) and (-1, 0), so projecting is reading a coordinate
+};
+
+// Grid of the static colliders, built when a level is loaded and patched when a single static comes or goes.
+// The cells are stored as compressed rows: cell c holds cell_entities[cell_start[c], cell_start[c] + cell_count[c]).
+// Every row keeps a few free slots behind its entries, so adding or removing a static only touches the rows of its cells.
 struct SpatialHash {
+	static constexpr uint32_t ROW_SLACK = 2;
+
+	// First and last cell of a static in the grid, to take it out again
+	struct StaticCells {
+		ivec2 first;
+		ivec2 last;
+		bool in_hash = false;
+	};
+
 	float cell_size = 100.f;
 	int height;
 	int width;
-	std::vector<std::vector < std::vector<Entity>>> grid;
+	std::vector<uint32_t> cell_start; // one per cell plus the end of the last row
+	std::vector<uint32_t> cell_count;
+	std::vector<Entity> cell_entities;
+	// per entity index, where every static in the grid is
+	std::vector<StaticCells> static_cells;
+	// per entity index, the query that saw a static last, so a static covering several cells is reported once
+	std::vector<uint32_t> query_stamps;
+	// per entity index, the shape of every static in the hash
+	std::vector<StaticShape> shapes;
+	uint32_t query_stamp = 0;
 };
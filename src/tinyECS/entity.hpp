@@ -1,31 +1,33 @@
 #pragma once
 
-// Unique identifier for all entities
+// Handle for all entities. The 32-bit id is split into an index (slot in the
+// entity pool, reused once destroyed) and a generation (bumped on every reuse),
+// so that a stale handle to a destroyed entity never matches the new one.
+// Create entities with registry().create(), a default constructed Entity is null.
 class Entity
 {
     unsigned int m_id;
-    static unsigned int id_count;   // defaults to 0 (invalid), need to init 1
 
 public:
+    static constexpr unsigned int INDEX_BITS = 20;
+    static constexpr unsigned int GENERATION_BITS = 32 - INDEX_BITS;
+    static constexpr unsigned int INDEX_MASK = (1u << INDEX_BITS) - 1;
+    static constexpr unsigned int GENERATION_MASK = (1u << GENERATION_BITS) - 1;
 
-    Entity()
-    {
-        // ensure that each entity gets a unique ID
-        m_id = id_count++; // assign and increment
-    }
+    Entity() : m_id(0) {} // null entity, index 0 is never handed out
 
-    /*
-    Entity(Entity& e)
-    {
-        m_id = e.m_id;
-    }
-    */
+    explicit Entity(unsigned int id) : m_id(id) {}
 
-    ~Entity()
-    {
-    }
+    Entity(unsigned int index, unsigned int generation)
+        : m_id((generation & GENERATION_MASK) << INDEX_BITS | (index & INDEX_MASK)) {}
 
     operator unsigned int() const { return m_id; } // enables automatic casting to int
 
     unsigned int id() const { return m_id; }
-};
\ No newline at end of file
+
+    unsigned int index() const { return m_id & INDEX_MASK; }
+
+    unsigned int generation() const { return m_id >> INDEX_BITS; }
+
+    bool is_null() const { return m_id == 0; }
+};
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <assert.h>
+
+#include "tiny_ecs.hpp"
+
+// Keeps the entities that have all of the given components packed at the front of the owned containers, in the same order.
+// Index i of every owned container then refers to the same entity, so a hot loop over the group is a linear scan over
+// parallel arrays instead of a lookup per entity:
+//	Motion* motions = group.data<Motion>();
+//	AABB* aabbs = group.data<AABB>();
+//	for (size_t i = 0; i < group.size(); i++) { ... motions[i] ... aabbs[i] ... }
+// Empty tag components are not owned, they only filter which entities belong to the group.
+// The group follows every insert, remove, freeze and thaw through the hooks of its containers. Frozen components are not
+// part of the group, so the group is a prefix of the active partition and the frozen tail stays behind it.
+// A container can be part of one group only, and the owned ones can not be sorted.
+// Joining or leaving the group moves components inside the owned containers, so references into an owned container
+// do not survive an insert into or removal from any container of the group.
+template <typename... Components>
+class OwningGroup
+{
+	template <typename T, typename... Rest>
+	struct FirstOwned
+	{
+		using type = std::conditional_t<!std::is_empty_v<T>, T, typename FirstOwned<Rest...>::type>;
+	};
+	template <typename T>
+	struct FirstOwned<T>
+	{
+		using type = T;
+	};
+
+	// the owned container the group reads its entities and positions from
+	using Lead = typename FirstOwned<Components...>::type;
+	static_assert(!std::is_empty_v<Lead>, "An owning group needs at least one component with data");
+
+	std::tuple<ContainerFor<Components>*...> containers;
+	size_t count = 0;
+
+	ComponentContainer<Lead>& lead() { return *std::get<ContainerFor<Lead>*>(containers); }
+
+	// Has the component, and for an owned one it is not frozen
+	template <typename T>
+	bool has_active(Entity e)
+	{
+		auto* c = std::get<ContainerFor<T>*>(containers);
+		if constexpr (std::is_empty_v<T>)
+			return c->has(e);
+		else
+			return c->has(e) && !c->is_frozen(e);
+	}
+
+	// Move the component of e to dense index to, if T is owned
+	template <typename T>
+	void move_owned(Entity e, size_t to)
+	{
+		if constexpr (!std::is_empty_v<T>)
+		{
+			auto* c = std::get<ContainerFor<T>*>(containers);
+			c->swap_dense(c->dense_index(e), to);
+		}
+	}
+
+	void enter(Entity e)
+	{
+		if (contains(e) || !(has_active<Components>(e) && ...))
+			return;
+		(move_owned<Components>(e, count), ...);
+		count++;
+	}
+
+	void leave(Entity e)
+	{
+		if (!contains(e))
+			return;
+		count--;
+		(move_owned<Components>(e, count), ...);
+	}
+
+	static void enter_hook(void* group, Entity e) { static_cast<OwningGroup*>(group)->enter(e); }
+	static void leave_hook(void* group, Entity e) { static_cast<OwningGroup*>(group)->leave(e); }
+	static void reset_hook(void* group) { static_cast<OwningGroup*>(group)->count = 0; }
+
+	template <typename T>
+	auto owned_array()
+	{
+		if constexpr (std::is_empty_v<T>)
+			return std::tuple<>();
+		else
+			return std::tuple<T*>(std::get<ContainerFor<T>*>(containers)->components.data());
+	}
+
+public:
+	OwningGroup(ContainerFor<Components>&... cs) : containers(&cs...)
+	{
+		(cs.set_group({ this, &enter_hook, &leave_hook, &reset_hook }), ...);
+		rebuild();
+	}
+
+	// the containers hold a pointer to the group
+	OwningGroup(const OwningGroup&) = delete;
+	OwningGroup& operator=(const OwningGroup&) = delete;
+
+	// Collect the members again, after the containers were cleared or loaded from a snapshot
+	void rebuild()
+	{
+		count = 0;
+		ComponentContainer<Lead>& c = lead();
+		for (size_t i = 0; i < c.active_size(); i++)
+			enter(c.entities[i]);
+	}
+
+	// Number of members, they occupy the indices [0, size()) of every owned container
+	size_t size() const { return count; }
+
+	bool contains(Entity e)
+	{
+		unsigned int cID = lead().dense_index(e);
+		return cID != ComponentContainer<Lead>::INVALID_INDEX && cID < count;
+	}
+
+	// The members, index i of these is index i of data<T>()
+	Entity* entities() { return lead().entities.data(); }
+
+	// The components of the members in an owned container
+	template <typename T>
+	T* data()
+	{
+		static_assert(!std::is_empty_v<T>, "Tag components are not stored by the group");
+		return std::get<ContainerFor<T>*>(containers)->components.data();
+	}
+
+	// Calls fn(Entity, Owned&...) for every member, with the owned components in the order of the template arguments
+	template <typename Fn>
+	void each(Fn fn)
+	{
+		auto arrays = std::tuple_cat(owned_array<Components>()...);
+		Entity* members = entities();
+		for (size_t i = 0; i < count; i++)
+			std::apply([&](auto*... array) { fn(members[i], array[i]...); }, arrays);
+	}
+};
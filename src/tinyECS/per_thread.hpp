@@ -0,0 +1,43 @@
+#pragma once
+
+#include <array>
+#include <assert.h>
+
+// Most threads that ever run systems or parallel loops: the main thread plus the scheduler's workers
+constexpr unsigned int MAX_THREADS = 8;
+
+// Index of the calling thread, 0 for the main thread and 1.. for the workers of the Scheduler, which set it when they start
+struct ThreadIndex
+{
+	static inline thread_local unsigned int current = 0;
+};
+
+// One T per thread, e.g. a scratch buffer or a command queue that a parallel loop fills without locking.
+// Each slot has its own cache line so that threads writing their own slot do not slow each other down.
+template <typename T>
+class PerThread
+{
+	struct alignas(64) Slot
+	{
+		T value;
+	};
+	std::array<Slot, MAX_THREADS> slots;
+
+public:
+	// The calling thread's T
+	T& local()
+	{
+		assert(ThreadIndex::current < MAX_THREADS);
+		return slots[ThreadIndex::current].value;
+	}
+
+	T& operator[](unsigned int thread) { return slots[thread].value; }
+
+	// Calls fn(T&) for every thread's T, in thread order
+	template <typename Fn>
+	void each(Fn fn)
+	{
+		for (Slot& slot : slots)
+			fn(slot.value);
+	}
+};
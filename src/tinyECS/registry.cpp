@@ -1,3 +0,0 @@
-#include "registry.hpp"
-
-ECSRegistry registry;
\ No newline at end of file
@@ -1,138 +1,446 @@
 #pragma once
 #include <vector>
+#include <tuple>
+#include <cstdint>
+#include <cstdio>
+#include <type_traits>
+#include <utility>
+#include <glm/trigonometric.hpp>
 
 #include "tiny_ecs.hpp"
+#include "archetype.hpp"
+#include "command_buffer.hpp"
+#include "group.hpp"
+#include "per_thread.hpp"
 #include "components.hpp"
-#include "map_system.hpp"
-#include "ui_system.hpp"
+
+// The components every projectile is created with by createProjectile(), see Archetype
+using ProjectileArchetype = Archetype<Motion, Projectile, MovingCollidable, MovingSAT, Collidable, AABB, RenderRequest>;
 
 class ECSRegistry
 {
-	// callbacks to remove a particular or all entities in the system
-	std::vector<ContainerInterface*> registry_list;
+	// Every container of the game. Adding a component type here is all it takes to register it:
+	// cross-container operations (destroy, clear, snapshot, stats) fold over this tuple at compile time.
+	// Empty tag components go into a TagContainer, see ContainerFor.
+	using Containers = std::tuple<
+		ComponentContainer<Motion>,
+		ComponentContainer<Parent>,
+		ComponentContainer<Children>,
+		ComponentContainer<UIButton>,
+		ComponentContainer<TitleScreenText>,
+		ComponentContainer<Collision>,
+		ComponentContainer<Player>,
+		ComponentContainer<Gun>,
+		ComponentContainer<Enemy>,
+		TagContainer<DeadEnemy>,
+		TagContainer<TutorialEnemy>,
+		ComponentContainer<PathComponent>,
+		ComponentContainer<Mesh*>,
+		ComponentContainer<RenderRequest>,
+		ComponentContainer<vec3>,
+		ComponentContainer<Projectile>,
+		ComponentContainer<Input>,
+		TagContainer<Collidable>,
+		ComponentContainer<AABB>,
+		ComponentContainer<CircleBound>,
+		ComponentContainer<Camera>,
+		ComponentContainer<Map>,
+		ComponentContainer<GameProgress>,
+		ComponentContainer<WalkSoundTimer>,
+		TagContainer<Laser>,
+		TagContainer<StaticCollidable>,
+		TagContainer<MovingCollidable>,
+		TagContainer<MovingCircle>,
+		TagContainer<MovingSAT>,
+		ComponentContainer<meshCollidable>,
+		ComponentContainer<Dash>,
+		ComponentContainer<Melee>,
+		ComponentContainer<Light>,
+		ComponentContainer<Pickup>,
+		ComponentContainer<Character>,
+		ComponentContainer<Text>,
+		ComponentContainer<Reload>,
+		ComponentContainer<UI>,
+		TagContainer<InstructionMessage>,
+		TagContainer<TextureWithoutLighting>,
+		ComponentContainer<Animation>,
+		ComponentContainer<RemoveTimer>,
+		ComponentContainer<SpatialHash>,
+		ComponentContainer<ShadowCaster>,
+		ComponentContainer<Prop>,
+		ComponentContainer<Door>,
+		TagContainer<Debris>,
+		ProjectileArchetype
+	>;
+	static constexpr size_t CONTAINER_COUNT = std::tuple_size_v<Containers>;
+	static_assert(CONTAINER_COUNT <= 64, "Entity signatures only have room for 64 containers");
+
+	Containers containers;
+
+	// hands out and recycles entity handles
+	EntityPool entity_pool;
+
+	// per entity index, one bit for every container the entity has a component in
+	std::vector<uint64_t> signatures;
+
+	// Names the container of Component for the stats and returns it, used to initialize the named members below
+	template <typename Component>
+	ContainerFor<Component>& container(const char* name) {
+		ContainerFor<Component>& c = std::get<ContainerFor<Component>>(containers);
+		c.set_name(name);
+		return c;
+	}
+
+	// The same for an archetype, which is looked up by its own type
+	template <typename ArchetypeType>
+	ArchetypeType& archetype(const char* name) {
+		ArchetypeType& a = std::get<ArchetypeType>(containers);
+		a.set_name(name);
+		return a;
+	}
+
+	template <size_t... I>
+	void assign_signatures(std::index_sequence<I...>) {
+		(std::get<I>(containers).set_signature(uint64_t(1) << I, &signatures), ...);
+	}
+
+	// Depths below e after e got a new parent
+	void update_child_depths(Entity e) {
+		Children* c = children.find(e);
+		if (!c)
+			return;
+		int depth = parents.get(e).depth + 1;
+		for (Entity child : c->entities) {
+			parents.modify(child).depth = depth;
+			update_child_depths(child);
+		}
+	}
+
+	template <size_t... I>
+	void remove_by_signature(Entity e, uint64_t signature, std::index_sequence<I...>) {
+		((signature & (uint64_t(1) << I) ? std::get<I>(containers).remove(e) : void()), ...);
+	}
 
 public:
-	// Manually created list of all components this game has
-	// IMPORTANT: Add any new CC's below to the registry_list
-	ComponentContainer<Motion> motions;
-	ComponentContainer<UIButton> buttons;
-	ComponentContainer<TitleScreenText> text;
-	ComponentContainer<Collision> collisions;
-	ComponentContainer<Player> players;
-	ComponentContainer<Gun> guns;
-	ComponentContainer<Enemy> enemies;
-	ComponentContainer<DeadEnemy> deadEnemies;
-	ComponentContainer<TutorialEnemy> tutorialEnemies;
-	ComponentContainer<PathComponent> pathComponents;
-	ComponentContainer<Mesh*> meshPtrs;
-	ComponentContainer<RenderRequest> renderRequests;
-	ComponentContainer<vec3> colors;
-	ComponentContainer<Projectile> projectiles;
-	ComponentContainer<Input> inputs;
-	ComponentContainer<Collidable> collidables;
-	ComponentContainer<AABB> AABBs;
-	ComponentContainer<CircleBound> circlebounds;
-	ComponentContainer<Camera> cameras;
-	ComponentContainer<Map> maps;
-	ComponentContainer<GameProgress> gameProgress;
-	ComponentContainer<WalkSoundTimer> walkSoundTimers;
-	ComponentContainer<Laser> lasers;
-	ComponentContainer<StaticCollidable> staticCollidables;
-	ComponentContainer<MovingCollidable> movingCollidables;
-	ComponentContainer<MovingCircle> movingCircleCollidables;
-	ComponentContainer<MovingSAT> movingSATCollidables;
-	ComponentContainer<meshCollidable> meshCollidables;
-	ComponentContainer<Dash> dashes;
-	ComponentContainer<Melee> melees;
-	ComponentContainer<Light> lights;
-	ComponentContainer<Pickup> pickups;
-	ComponentContainer<Character> characters;
-	ComponentContainer<Text> texts;
-	ComponentContainer<Reload> reloads;
-	ComponentContainer<UI> uis;
-	ComponentContainer<InstructionMessage> instructionMessages;
-	ComponentContainer<TextureWithoutLighting> textureWithoutLighting;
-	ComponentContainer<Animation> animations;
-	ComponentContainer<RemoveTimer> removeTimers;
-	ComponentContainer<SpatialHash> spatialHashes;
-	ComponentContainer<ShadowCaster> shadowCasters;
-	ComponentContainer<Prop> props;
-	ComponentContainer<Debris> debrises;
-
-	// constructor that adds all containers for looping over them
-	ECSRegistry()
-	{
-		// TODO: A1 add a LightUp component
-		registry_list.push_back(&motions);
-		registry_list.push_back(&collisions);
-		registry_list.push_back(&players);
-		registry_list.push_back(&guns);
-		registry_list.push_back(&meshPtrs);
-		registry_list.push_back(&renderRequests);
-		registry_list.push_back(&colors);
-		registry_list.push_back(&projectiles);
-		registry_list.push_back(&inputs);
-		registry_list.push_back(&collidables);
-		registry_list.push_back(&AABBs);
-		registry_list.push_back(&circlebounds);
-		registry_list.push_back(&cameras);
-		registry_list.push_back(&enemies);
-		registry_list.push_back(&deadEnemies);
-		registry_list.push_back(&tutorialEnemies);
-		registry_list.push_back(&maps);
-		registry_list.push_back(&gameProgress);
-		registry_list.push_back(&staticCollidables);
-		registry_list.push_back(&movingCollidables);
-		registry_list.push_back(&movingCircleCollidables);
-		registry_list.push_back(&movingSATCollidables);
-		registry_list.push_back(&meshCollidables);
-		registry_list.push_back(&dashes);
-		registry_list.push_back(&melees);
-		registry_list.push_back(&lights);
-		registry_list.push_back(&characters);
-		registry_list.push_back(&texts);
-		registry_list.push_back(&reloads);
-		registry_list.push_back(&pickups);
-		registry_list.push_back(&uis);
-		registry_list.push_back(&instructionMessages);
-		registry_list.push_back(&textureWithoutLighting);
-		registry_list.push_back(&animations);
-		registry_list.push_back(&removeTimers);
-		registry_list.push_back(&spatialHashes);
-		registry_list.push_back(&shadowCasters);
-		registry_list.push_back(&props);
-		registry_list.push_back(&debrises);
+	// Named access to the containers. These refer into the tuple above, so a name can not exist without its container being registered
+	ComponentContainer<Motion>& motions = container<Motion>("motions");
+	ComponentContainer<Parent>& parents = container<Parent>("parents");
+	ComponentContainer<Children>& children = container<Children>("children");
+	ComponentContainer<UIButton>& buttons = container<UIButton>("buttons");
+	ComponentContainer<TitleScreenText>& text = container<TitleScreenText>("text");
+	ComponentContainer<Collision>& collisions = container<Collision>("collisions");
+	ComponentContainer<Player>& players = container<Player>("players");
+	ComponentContainer<Gun>& guns = container<Gun>("guns");
+	ComponentContainer<Enemy>& enemies = container<Enemy>("enemies");
+	TagContainer<DeadEnemy>& deadEnemies = container<DeadEnemy>("deadEnemies");
+	TagContainer<TutorialEnemy>& tutorialEnemies = container<TutorialEnemy>("tutorialEnemies");
+	ComponentContainer<PathComponent>& pathComponents = container<PathComponent>("pathComponents");
+	ComponentContainer<Mesh*>& meshPtrs = container<Mesh*>("meshPtrs");
+	ComponentContainer<RenderRequest>& renderRequests = container<RenderRequest>("renderRequests");
+	ComponentContainer<vec3>& colors = container<vec3>("colors");
+	ComponentContainer<Projectile>& projectiles = container<Projectile>("projectiles");
+	ComponentContainer<Input>& inputs = container<Input>("inputs");
+	TagContainer<Collidable>& collidables = container<Collidable>("collidables");
+	ComponentContainer<AABB>& AABBs = container<AABB>("AABBs");
+	ComponentContainer<CircleBound>& circlebounds = container<CircleBound>("circlebounds");
+	ComponentContainer<Camera>& cameras = container<Camera>("cameras");
+	ComponentContainer<Map>& maps = container<Map>("maps");
+	ComponentContainer<GameProgress>& gameProgress = container<GameProgress>("gameProgress");
+	ComponentContainer<WalkSoundTimer>& walkSoundTimers = container<WalkSoundTimer>("walkSoundTimers");
+	TagContainer<Laser>& lasers = container<Laser>("lasers");
+	TagContainer<StaticCollidable>& staticCollidables = container<StaticCollidable>("staticCollidables");
+	TagContainer<MovingCollidable>& movingCollidables = container<MovingCollidable>("movingCollidables");
+	TagContainer<MovingCircle>& movingCircleCollidables = container<MovingCircle>("movingCircleCollidables");
+	TagContainer<MovingSAT>& movingSATCollidables = container<MovingSAT>("movingSATCollidables");
+	ComponentContainer<meshCollidable>& meshCollidables = container<meshCollidable>("meshCollidables");
+	ComponentContainer<Dash>& dashes = container<Dash>("dashes");
+	ComponentContainer<Melee>& melees = container<Melee>("melees");
+	ComponentContainer<Light>& lights = container<Light>("lights");
+	ComponentContainer<Pickup>& pickups = container<Pickup>("pickups");
+	ComponentContainer<Character>& characters = container<Character>("characters");
+	ComponentContainer<Text>& texts = container<Text>("texts");
+	ComponentContainer<Reload>& reloads = container<Reload>("reloads");
+	ComponentContainer<UI>& uis = container<UI>("uis");
+	TagContainer<InstructionMessage>& instructionMessages = container<InstructionMessage>("instructionMessages");
+	TagContainer<TextureWithoutLighting>& textureWithoutLighting = container<TextureWithoutLighting>("textureWithoutLighting");
+	ComponentContainer<Animation>& animations = container<Animation>("animations");
+	ComponentContainer<RemoveTimer>& removeTimers = container<RemoveTimer>("removeTimers");
+	ComponentContainer<SpatialHash>& spatialHashes = container<SpatialHash>("spatialHashes");
+	ComponentContainer<ShadowCaster>& shadowCasters = container<ShadowCaster>("shadowCasters");
+	ComponentContainer<Prop>& props = container<Prop>("props");
+	ComponentContainer<Door>& doors = container<Door>("doors");
+	TagContainer<Debris>& debrises = container<Debris>("debrises");
+	// Not used by the game yet: createProjectile() and the physics and render passes still work on the containers above
+	ProjectileArchetype& projectileArchetype = archetype<ProjectileArchetype>("projectileArchetype");
+
+	// Owning groups, see OwningGroup. Their containers are packed in lockstep, so they can not be sorted or join another group
+	OwningGroup<Motion, AABB, MovingSAT> movingSATGroup{ motions, AABBs, movingSATCollidables };
+
+	ECSRegistry() {
+		assign_signatures(std::make_index_sequence<CONTAINER_COUNT>{});
+	}
+
+	// the named members refer into this instance
+	ECSRegistry(const ECSRegistry&) = delete;
+	ECSRegistry& operator=(const ECSRegistry&) = delete;
+
+	// Signature bit of the container of Component, the same in every registry
+	template <typename Component, size_t I = 0>
+	static constexpr uint64_t signature_mask() {
+		if constexpr (std::is_same_v<std::tuple_element_t<I, Containers>, ContainerFor<Component>>)
+			return uint64_t(1) << I;
+		else
+			return signature_mask<Component, I + 1>();
+	}
+
+	// Returns the container holding components of type Component
+	template <typename Component>
+	ContainerFor<Component>& get() {
+		return std::get<ContainerFor<Component>>(containers);
+	}
+
+	// Calls fn(container) for every container, expanded at compile time
+	template <typename Fn>
+	void each_container(Fn&& fn) {
+		std::apply([&](auto&... c) { (fn(c), ...); }, containers);
+	}
+
+	// Numbers for every container, e.g. for an overlay or to find entities that are never destroyed
+	std::vector<ContainerStats> container_stats() {
+		std::vector<ContainerStats> all;
+		all.reserve(CONTAINER_COUNT);
+		each_container([&](auto& c) { all.push_back(c.stats()); });
+		return all;
+	}
+
+	// Call once per frame, closes the per frame insert and remove counts
+	void end_frame_stats() {
+		each_container([](auto& c) { c.end_frame(); });
+	}
+
+	// Start tracking the peak sizes over again, e.g. when a level is loaded
+	void reset_peak_sizes() {
+		each_container([](auto& c) { c.reset_peak(c.size()); });
+	}
+
+	// Write container_stats() as CSV, returns false if the file can not be opened
+	bool dump_stats_csv(const char* path) {
+		FILE* file = fopen(path, "w");
+		if (!file) {
+			printf("Could not open %s for the registry stats\n", path);
+			return false;
+		}
+		fprintf(file, "container,size,capacity,bytes,inserts_last_frame,removes_last_frame,peak_size\n");
+		for (const ContainerStats& stats : container_stats())
+			fprintf(file, "%s,%zu,%zu,%zu,%zu,%zu,%zu\n", stats.name, stats.size, stats.capacity, stats.bytes, stats.inserts, stats.removes, stats.peak_size);
+		fclose(file);
+		printf("Registry stats written to %s\n", path);
+		return true;
+	}
+
+	// Create a new entity, reusing the index of a destroyed one if available
+	Entity create() {
+		return entity_pool.create();
+	}
+
+	// Remove all components of e and release its index for reuse, the children of e are destroyed with it.
+	// Any handle still referring to e will no longer match a component afterwards.
+	void destroy(Entity e) {
+		if (Children* c = children.find(e)) {
+			// copied since every destroyed child removes itself from the list
+			InlineVector<Entity, 8> doomed = c->entities;
+			for (Entity child : doomed)
+				destroy(child);
+		}
+		detach(e);
+		remove_all_components_of(e);
+		entity_pool.destroy(e);
+	}
+
+	// Attach child to parent, both need a Motion. The child keeps its current world transform,
+	// the local transform is derived from the two Motions. A child that already has a parent is moved over.
+	void set_parent(Entity child, Entity parent) {
+		assert(child != parent && "An entity can not be its own parent");
+		detach(child);
+
+		const Motion& parent_motion = motions.get(parent);
+		const Motion& child_motion = motions.get(child);
+		float radians = glm::radians(-parent_motion.angle);
+		vec2 offset = child_motion.position - parent_motion.position;
+
+		Parent link;
+		link.entity = parent;
+		link.local_position = { offset.x * cos(radians) - offset.y * sin(radians), offset.x * sin(radians) + offset.y * cos(radians) };
+		link.local_angle = child_motion.angle - parent_motion.angle;
+		link.local_scale = {
+			parent_motion.scale.x != 0 ? child_motion.scale.x / parent_motion.scale.x : 1.f,
+			parent_motion.scale.y != 0 ? child_motion.scale.y / parent_motion.scale.y : 1.f
+		};
+		link.depth = parents.has(parent) ? parents.get(parent).depth + 1 : 1;
+		parents.insert(child, link);
+
+		Children* siblings = children.find(parent);
+		if (!siblings)
+			siblings = &children.emplace(parent);
+		siblings->entities.push_back(child);
+		update_child_depths(child);
+	}
+
+	// Detach e from its parent, e stays where it is and keeps its own children
+	void detach(Entity e) {
+		Parent* link = parents.find(e);
+		if (!link)
+			return;
+		if (Children* siblings = children.find(link->entity)) {
+			for (size_t i = 0; i < siblings->entities.size(); i++) {
+				if (siblings->entities[i] == e) {
+					siblings->entities.erase(i);
+					break;
+				}
+			}
+			if (siblings->entities.empty())
+				children.remove(link->entity);
+		}
+		parents.remove(e);
+	}
+
+	// Lifecycle signals of the container of Component, see ContainerBase
+	template <typename Component>
+	Signal& on_construct() {
+		return get<Component>().on_construct;
+	}
+
+	template <typename Component>
+	Signal& on_update() {
+		return get<Component>().on_update;
+	}
+
+	template <typename Component>
+	Signal& on_destroy() {
+		return get<Component>().on_destroy;
+	}
+
+	// Iterate over all entities that have all of the given components, see View
+	template <typename... Components>
+	View<Components...> view() {
+		return View<Components...>(get<Components>()...);
+	}
+
+	// Structural changes recorded during iteration, applied by flush_commands()
+	CommandBuffer commands;
+
+	// Structural changes recorded inside parallel loops, one buffer per thread so that recording needs no lock.
+	// Which thread runs which part of a loop varies, so the order of emplaces from different threads does too
+	PerThread<CommandBuffer> thread_commands;
+
+	// The buffer of the calling thread, for loop bodies run by parallel_for_each
+	CommandBuffer& local_commands() {
+		return thread_commands.local();
+	}
+
+	// Sync point: apply everything recorded in commands, followed by the per thread buffers in thread order
+	void flush_commands() {
+		thread_commands.each([this](CommandBuffer& c) { commands.absorb(c); });
+		commands.flush([this](Entity e) { destroy(e); });
+	}
+
+	// Check if e refers to an entity that has not been destroyed
+	bool valid(Entity e) const {
+		return entity_pool.valid(e);
 	}
 
 	void clear_all_components() {
-		for (ContainerInterface* reg : registry_list)
-			reg->clear();
+		each_container([](auto& c) { c.clear(); });
 	}
 
 	void list_all_components() {
 		printf("Debug info on all registry entries:\n");
-		for (ContainerInterface* reg : registry_list)
-			if (reg->size() > 0)
-				printf("%4d components of type %s\n", (int)reg->size(), typeid(*reg).name());
+		for (const ContainerStats& stats : container_stats())
+			if (stats.size > 0)
+				printf("%4zu components in %-26s (capacity %zu, %zu bytes, peak %zu)\n", stats.size, stats.name, stats.capacity, stats.bytes, stats.peak_size);
 	}
 
 	void list_all_components_of(Entity e) {
 		printf("Debug info on components of entity %u:\n", (unsigned int)e);
-		for (ContainerInterface* reg : registry_list)
-			if (reg->has(e))
-				printf("type %s\n", typeid(*reg).name());
+		each_container([&](auto& c) {
+			if (c.has(e))
+				printf("%s\n", c.stats().name);
+		});
 	}
 
+	// Only removes from the containers whose bit is set in the signature of e
 	void remove_all_components_of(Entity e) {
-		for (ContainerInterface* reg : registry_list)
-			reg->remove(e);
+		if (!valid(e) || e.index() >= signatures.size())
+			return;
+		remove_by_signature(e, signatures[e.index()], std::make_index_sequence<CONTAINER_COUNT>{});
+	}
+
+	// Check if e has all of the given components with a single mask test
+	template <typename... Components>
+	bool has_all(Entity e) {
+		if (!valid(e))
+			return false;
+		uint64_t mask = (get<Components>().get_signature_mask() | ...);
+		uint64_t signature = e.index() < signatures.size() ? signatures[e.index()] : 0;
+		return (signature & mask) == mask;
+	}
+
+	// State of all containers and of the entity handles at one point in time, see snapshot()
+	struct Snapshot
+	{
+		SnapshotBuffer data;
+		EntityPool entity_pool;
+		std::vector<uint64_t> signatures;
+
+		bool empty() const { return data.empty(); }
+	};
+
+	// Save every container except inputs, which hold the live device state
+	Snapshot snapshot() {
+		Snapshot s;
+		each_container([&](auto& c) {
+			if constexpr (!std::is_same_v<std::decay_t<decltype(c)>, ComponentContainer<Input>>)
+				c.save(s.data);
+		});
+		s.entity_pool = entity_pool;
+		s.signatures = signatures;
+		return s;
+	}
+
+	// Put all saved containers back and revive the entities alive at the time of the snapshot under their old handles.
+	// Everything created since is gone, pending commands are dropped since they refer to the state being replaced.
+	// Handles kept outside of the registry to entities created after the snapshot must not be used afterwards.
+	void restore(const Snapshot& s) {
+		commands.clear();
+		thread_commands.each([](CommandBuffer& c) { c.clear(); });
+		SnapshotReader reader(s.data);
+		each_container([&](auto& c) {
+			if constexpr (!std::is_same_v<std::decay_t<decltype(c)>, ComponentContainer<Input>>)
+				c.load(reader);
+		});
+		entity_pool.restore(s.entity_pool);
+		movingSATGroup.rebuild();
+
+		// the bits of the skipped containers stay as they are
+		uint64_t kept = inputs.get_signature_mask();
+		std::vector<uint64_t> restored = s.signatures;
+		restored.resize(std::max(restored.size(), signatures.size()), 0);
+		for (size_t i = 0; i < restored.size(); i++)
+			restored[i] = (restored[i] & ~kept) | (i < signatures.size() ? signatures[i] & kept : 0);
+		signatures = std::move(restored);
 	}
 
 	ScreenState screen_state;
 	std::unordered_map<char, Character> character_map;
-	MapSystem* map_system;
-	AudioSystem* audio_system;
-	UISystem* ui_system;
+
+	// The registry of the world the calling thread works on, set by World::make_current().
+	// Systems use the world they were created with, see GameSystem. This is for the free helpers such as createProjectile()
+	// or the map loader, which are called from every system and from parallel loops and would otherwise need a World&
+	// threaded through every call.
+	static inline thread_local ECSRegistry* current = nullptr;
 };
 
-extern ECSRegistry registry;
\ No newline at end of file
+// The registry of the world the calling thread works on, see World
+inline ECSRegistry& registry() {
+	return *ECSRegistry::current;
+}
\ No newline at end of file
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Spare heap blocks shared by all InlineVector<T, N> of the same element type.
+// A vector that outgrows its inline storage takes one from here and gives it back when it is destroyed,
+// so once the game has warmed up, long paths and the like no longer touch the allocator.
+// One pool per thread, so systems running on the scheduler's worker threads do not share it.
+template <typename T>
+struct OverflowPool
+{
+	static constexpr size_t MAX_SPARE = 64;
+	static inline thread_local std::vector<std::vector<T>> spare;
+
+	static std::vector<T> take()
+	{
+		if (spare.empty())
+			return {};
+		std::vector<T> block = std::move(spare.back());
+		spare.pop_back();
+		return block;
+	}
+
+	static void give(std::vector<T>&& block)
+	{
+		if (block.capacity() == 0 || spare.size() >= MAX_SPARE)
+			return;
+		block.clear();
+		spare.push_back(std::move(block));
+	}
+};
+
+// Vector that keeps up to N elements inside the object and moves them to a pooled heap block beyond that.
+// Once spilled it stays on the heap block, so clearing and refilling reuses its capacity.
+template <typename T, size_t N>
+class InlineVector
+{
+	static_assert(std::is_trivially_copyable_v<T>, "InlineVector only holds plain data");
+
+	T items[N] = {};
+	size_t count = 0;          // number of inline elements, unused once spilled
+	std::vector<T> overflow;   // holds all elements once spilled
+	bool spilled = false;
+
+	void spill()
+	{
+		overflow = OverflowPool<T>::take();
+		overflow.assign(items, items + count);
+		spilled = true;
+	}
+
+public:
+	InlineVector() = default;
+	InlineVector(const InlineVector&) = default;
+	InlineVector& operator=(const InlineVector&) = default;
+
+	InlineVector(InlineVector&& other) noexcept
+		: count(other.count), overflow(std::move(other.overflow)), spilled(other.spilled)
+	{
+		std::copy(other.items, other.items + other.count, items);
+		other.count = 0;
+		other.spilled = false;
+	}
+
+	InlineVector& operator=(InlineVector&& other) noexcept
+	{
+		if (this == &other)
+			return *this;
+		OverflowPool<T>::give(std::move(overflow));
+		std::copy(other.items, other.items + other.count, items);
+		count = other.count;
+		overflow = std::move(other.overflow);
+		spilled = other.spilled;
+		other.count = 0;
+		other.spilled = false;
+		return *this;
+	}
+
+	~InlineVector()
+	{
+		OverflowPool<T>::give(std::move(overflow));
+	}
+
+	T* data() { return spilled ? overflow.data() : items; }
+	const T* data() const { return spilled ? overflow.data() : items; }
+	size_t size() const { return spilled ? overflow.size() : count; }
+	bool empty() const { return size() == 0; }
+
+	T* begin() { return data(); }
+	T* end() { return data() + size(); }
+	const T* begin() const { return data(); }
+	const T* end() const { return data() + size(); }
+
+	T& operator[](size_t i) { return data()[i]; }
+	const T& operator[](size_t i) const { return data()[i]; }
+
+	void push_back(const T& value)
+	{
+		if (!spilled && count == N)
+			spill();
+		if (spilled)
+			overflow.push_back(value);
+		else
+			items[count++] = value;
+	}
+
+	void insert(size_t position, const T& value)
+	{
+		push_back(value);
+		std::rotate(begin() + position, end() - 1, end());
+	}
+
+	// Removes the element at position, keeping the order of the others
+	void erase(size_t position)
+	{
+		std::copy(begin() + position + 1, end(), begin() + position);
+		if (spilled)
+			overflow.pop_back();
+		else
+			count--;
+	}
+
+	void clear()
+	{
+		count = 0;
+		overflow.clear();
+	}
+};
+
+// Sorted set of up to N elements stored inline, for small per-component sets such as the enemies a projectile hit
+template <typename T, size_t N>
+class SmallFlatSet
+{
+	InlineVector<T, N> items;
+
+public:
+	bool contains(const T& value) const
+	{
+		return std::binary_search(items.begin(), items.end(), value);
+	}
+
+	// Returns false if the value was already in the set
+	bool insert(const T& value)
+	{
+		const T* position = std::lower_bound(items.begin(), items.end(), value);
+		if (position != items.end() && *position == value)
+			return false;
+		items.insert(position - items.begin(), value);
+		return true;
+	}
+
+	size_t size() const { return items.size(); }
+	bool empty() const { return items.empty(); }
+	void clear() { items.clear(); }
+
+	const T* begin() const { return items.begin(); }
+	const T* end() const { return items.end(); }
+};
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <vector>
+#include <assert.h>
+
+// Storage of a registry snapshot, see ECSRegistry::snapshot().
+// Trivially copyable data is appended to one contiguous byte buffer and restored with memcpy,
+// everything else is kept as a copy next to it and restored through its SnapshotHooks.
+class SnapshotBuffer
+{
+	std::vector<unsigned char> bytes;
+	std::vector<std::shared_ptr<void>> objects;
+
+	friend class SnapshotReader;
+
+public:
+	void write(const void* data, size_t size)
+	{
+		size_t offset = bytes.size();
+		bytes.resize(offset + size);
+		if (size > 0)
+			std::memcpy(bytes.data() + offset, data, size);
+	}
+
+	// Arrays start at an offset aligned for their element type, so they can be copied straight out of the buffer
+	template <typename T>
+	void write_array(const std::vector<T>& array)
+	{
+		static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable arrays can be written as bytes");
+		size_t count = array.size();
+		write(&count, sizeof(count));
+		bytes.resize((bytes.size() + alignof(T) - 1) / alignof(T) * alignof(T));
+		write(array.data(), count * sizeof(T));
+	}
+
+	// Keep a copy of an object that can not be written as bytes
+	template <typename T>
+	void keep(T object)
+	{
+		objects.push_back(std::make_shared<T>(std::move(object)));
+	}
+
+	bool empty() const { return bytes.empty() && objects.empty(); }
+
+	// Bytes in the contiguous buffer, objects kept aside are not counted
+	size_t byte_size() const { return bytes.size(); }
+};
+
+// Reads a SnapshotBuffer back in the order it was written
+class SnapshotReader
+{
+	const SnapshotBuffer& buffer;
+	size_t byte_cursor = 0;
+	size_t object_cursor = 0;
+
+public:
+	SnapshotReader(const SnapshotBuffer& buffer) : buffer(buffer) {}
+
+	void read(void* data, size_t size)
+	{
+		assert(byte_cursor + size <= buffer.bytes.size() && "Read past the end of the snapshot");
+		if (size > 0)
+			std::memcpy(data, buffer.bytes.data() + byte_cursor, size);
+		byte_cursor += size;
+	}
+
+	template <typename T>
+	void read_array(std::vector<T>& array)
+	{
+		static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable arrays can be read as bytes");
+		size_t count;
+		read(&count, sizeof(count));
+		byte_cursor = (byte_cursor + alignof(T) - 1) / alignof(T) * alignof(T);
+		assert(byte_cursor + count * sizeof(T) <= buffer.bytes.size() && "Read past the end of the snapshot");
+		// assign() instead of resize() + read(), components do not need a default constructor
+		const T* first = reinterpret_cast<const T*>(buffer.bytes.data() + byte_cursor);
+		array.assign(first, first + count);
+		byte_cursor += count * sizeof(T);
+	}
+
+	template <typename T>
+	const T& take()
+	{
+		assert(object_cursor < buffer.objects.size() && "Read past the end of the snapshot");
+		return *static_cast<const T*>(buffer.objects[object_cursor++].get());
+	}
+};
+
+// How the components of a container are saved into and restored from a snapshot.
+// The default keeps a copy of the whole array, which covers members like std::set and std::vector.
+// Specialize it for components that own large data that never changes after creation, see SnapshotHooks<Map>.
+template <typename Component, typename Enable = void>
+struct SnapshotHooks
+{
+	static void save(SnapshotBuffer& buffer, const std::vector<Component>& components)
+	{
+		buffer.keep(components);
+	}
+
+	static void load(SnapshotReader& reader, std::vector<Component>& components)
+	{
+		components = reader.take<std::vector<Component>>();
+	}
+};
+
+// Trivially copyable components go into the byte buffer with a single memcpy per container
+template <typename Component>
+struct SnapshotHooks<Component, std::enable_if_t<std::is_trivially_copyable_v<Component>>>
+{
+	static void save(SnapshotBuffer& buffer, const std::vector<Component>& components)
+	{
+		buffer.write_array(components);
+	}
+
+	static void load(SnapshotReader& reader, std::vector<Component>& components)
+	{
+		reader.read_array(components);
+	}
+};
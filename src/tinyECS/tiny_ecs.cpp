@@ -1,5 +1,4 @@
 // internal
 #include "tiny_ecs.hpp"
 
-// All we need to store besides the containers is the id of every entity and callbacks to be able to remove entities across containers
-unsigned int Entity::id_count = 1;
\ No newline at end of file
+// Entity handles are handed out by the EntityPool owned by the registry, see registry.hpp
@@ -1,33 +1,359 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
+#include <deque>
 #include <vector>
 #include <unordered_map>
 #include <set>
+#include <memory>
+#include <tuple>
 #include <functional>
 #include <typeindex>
 #include <assert.h>
+#include <cstdint>
 
 #include "entity.hpp"
+#include "snapshot.hpp"
 
 
-// Common interface to refer to all containers in the ECS registry
-struct ContainerInterface
+// Hands out entity handles and recycles the indices of destroyed entities.
+// Each reuse bumps the generation of the index so stale handles can be detected.
+// Destroyed indices wait in a queue and are only reused once MIN_FREE_INDICES are waiting, oldest first.
+// Reusing the most recently freed index would let projectile churn cycle one index through all generations
+// after a few thousand shots, at which point a stale handle to it passes as live again.
+class EntityPool
 {
-	virtual void clear() = 0;
-	virtual size_t size() = 0;
-	virtual void remove(Entity e) = 0;
-	virtual bool has(Entity entity) = 0;
+	std::vector<unsigned int> generations; // generation of every index handed out so far
+	std::deque<unsigned int> free_list;    // destroyed indices waiting to be reused, oldest first
+
+public:
+	// With this many indices in the queue an index is reused at most once every MIN_FREE_INDICES destroys,
+	// so its generation wraps after GENERATION_MASK * MIN_FREE_INDICES destroys instead of GENERATION_MASK
+	static constexpr size_t MIN_FREE_INDICES = 1024;
+
+	EntityPool()
+	{
+		generations.push_back(0); // index 0 is reserved for the null entity
+	}
+
+	Entity create()
+	{
+		if (free_list.size() >= MIN_FREE_INDICES)
+		{
+			unsigned int index = free_list.front();
+			free_list.pop_front();
+			return Entity(index, generations[index]);
+		}
+		unsigned int index = (unsigned int)generations.size();
+		assert(index <= Entity::INDEX_MASK && "Ran out of entity indices");
+		generations.push_back(0);
+		return Entity(index, 0);
+	}
+
+	void destroy(Entity e)
+	{
+		if (!valid(e))
+			return;
+		unsigned int index = e.index();
+		generations[index] = (generations[index] + 1) & Entity::GENERATION_MASK;
+		free_list.push_back(index);
+	}
+
+	bool valid(Entity e) const
+	{
+		return !e.is_null() && e.index() < generations.size() && generations[e.index()] == e.generation();
+	}
+
+	// Number of entities currently alive
+	size_t alive() const
+	{
+		return generations.size() - 1 - free_list.size();
+	}
+
+	// Roll back to a copy of the pool taken earlier, entities alive in the copy get their old handles back.
+	// Indices that end up free keep a generation newer than any handle handed out since the copy,
+	// so those handles stay stale.
+	void restore(const EntityPool& saved)
+	{
+		assert(saved.generations.size() <= generations.size() && "The pool never shrinks");
+		std::vector<bool> free_now(generations.size(), false), free_saved(generations.size(), false);
+		for (unsigned int index : free_list)
+			free_now[index] = true;
+		for (unsigned int index : saved.free_list)
+			free_saved[index] = true;
+
+		free_list = saved.free_list;
+		for (unsigned int index = 1; index < generations.size(); index++)
+		{
+			bool alive_saved = index < saved.generations.size() && !free_saved[index];
+			if (alive_saved)
+			{
+				generations[index] = saved.generations[index];
+				continue;
+			}
+			unsigned int next = free_now[index] ? generations[index] : (generations[index] + 1) & Entity::GENERATION_MASK;
+			if (index < saved.generations.size())
+				next = std::max(next, saved.generations[index]);
+			else
+				free_list.push_back(index);
+			generations[index] = next;
+		}
+	}
+};
+
+// Global change counter. Containers stamp components with the current tick whenever they are inserted or modified.
+// A system that wants to do incremental work takes a checkpoint(), and next time only looks at what changed since.
+// Atomic since systems on different threads stamp changes while another one takes a checkpoint.
+struct ChangeTick
+{
+	static inline std::atomic<uint32_t> current{ 1 };
+
+	// Returns a tick that every later change is newer than
+	static uint32_t checkpoint() { return current++; }
+};
+
+// Numbers of one container for profiling and leak hunting, see ECSRegistry::container_stats()
+struct ContainerStats
+{
+	const char* name;
+	size_t size;
+	size_t capacity;
+	size_t bytes;        // heap memory held by the container itself, not counting what the components own
+	size_t inserts;      // during the last frame
+	size_t removes;      // during the last frame
+	size_t peak_size;    // since the last reset_peak()
+};
+
+// Listeners that are called with an entity, see the lifecycle signals of ContainerBase.
+// Publishing to a signal without listeners is a single empty() check.
+class Signal
+{
+	struct Listener
+	{
+		void* instance;
+		void (*call)(void* instance, Entity e);
+	};
+	std::vector<Listener> listeners;
+
+public:
+	// Call (instance->*Method)(e) on every publish
+	template <auto Method, typename T>
+	void connect(T* instance)
+	{
+		listeners.push_back({ instance, [](void* i, Entity e) { (static_cast<T*>(i)->*Method)(e); } });
+	}
+
+	// Call Function(e) on every publish
+	template <auto Function>
+	void connect()
+	{
+		listeners.push_back({ nullptr, [](void*, Entity e) { Function(e); } });
+	}
+
+	// Remove every listener connected with instance
+	void disconnect(void* instance)
+	{
+		listeners.erase(std::remove_if(listeners.begin(), listeners.end(), [instance](const Listener& l) { return l.instance == instance; }), listeners.end());
+	}
+
+	bool empty() const { return listeners.empty(); }
+
+	void publish(Entity e)
+	{
+		for (const Listener& listener : listeners)
+			listener.call(listener.instance, e);
+	}
+};
+
+// Callbacks into the owning group a container takes part in, see OwningGroup
+struct GroupHooks
+{
+	void* group = nullptr;
+	void (*enter)(void* group, Entity e) = nullptr; // e got a component, it may now have everything the group needs
+	void (*leave)(void* group, Entity e) = nullptr; // e is about to lose a component or have one frozen
+	void (*reset)(void* group) = nullptr;           // the container was cleared or loaded, the group is rebuilt later
+};
+
+// State shared by all containers: their bit in the entity signatures, their stats counters and their owning group.
+// Containers are never used through this base, the registry reaches each one statically (see ECSRegistry::each_container),
+// so none of the container operations are virtual.
+// Every container provides clear(), size(), remove(e), has(e), stats(), and save()/load() for snapshots.
+struct ContainerBase
+{
+	// Lifecycle signals for indices kept outside of the registry, e.g. the spatial hash.
+	// on_construct is published after a component was inserted, on_update when it is marked as changed through
+	// modify() or mark_changed(), and on_destroy before a component is removed, so it can still be read.
+	// Loading a snapshot publishes nothing, indices that are not restored with it have to be rebuilt.
+	// Listeners must not insert or remove components of the container that publishes, and a listener of a
+	// container written by a parallel loop is called from several threads at once.
+	Signal on_construct, on_update, on_destroy;
+
+	// Called by the registry for every container it holds. Each container owns one bit
+	// of the per-entity signature, so the registry knows which containers an entity has components in.
+	void set_signature(uint64_t mask, std::vector<uint64_t>* entity_signatures)
+	{
+		signature_mask = mask;
+		signatures = entity_signatures;
+	}
+
+	// The bit of this container in the entity signatures, 0 if it is not registered
+	uint64_t get_signature_mask() const { return signature_mask; }
+
+	void set_name(const char* container_name) { name = container_name; }
+
+	// Called once per frame, the inserts and removes counted so far become the ones of the last frame
+	void end_frame()
+	{
+		last_inserts = inserts;
+		last_removes = removes;
+		inserts = 0;
+		removes = 0;
+	}
+
+	void reset_peak(size_t current_size) { peak_size = current_size; }
+
+	// Called by an OwningGroup for every container it covers
+	void set_group(GroupHooks hooks)
+	{
+		assert(!group.group && "A container can only be part of one owning group");
+		group = hooks;
+	}
+
+	bool in_group() const { return group.group != nullptr; }
+
+protected:
+	void group_enter(Entity e)
+	{
+		if (group.group)
+			group.enter(group.group, e);
+	}
+
+	void group_leave(Entity e)
+	{
+		if (group.group)
+			group.leave(group.group, e);
+	}
+
+	void group_reset()
+	{
+		if (group.group)
+			group.reset(group.group);
+	}
+
+	void count_insert(size_t new_size)
+	{
+		inserts++;
+		peak_size = std::max(peak_size, new_size);
+	}
+
+	void count_removes(size_t n) { removes += n; }
+
+	// The part of stats() that every container shares
+	ContainerStats base_stats(size_t size, size_t capacity, size_t bytes) const
+	{
+		return { name, size, capacity, bytes, last_inserts, last_removes, std::max(peak_size, size) };
+	}
+
+	void mark_signature(Entity e)
+	{
+		if (!signatures)
+			return;
+		if (e.index() >= signatures->size())
+			signatures->resize(e.index() + 1, 0);
+		(*signatures)[e.index()] |= signature_mask;
+	}
+
+	void unmark_signature(Entity e)
+	{
+		if (signatures && e.index() < signatures->size())
+			(*signatures)[e.index()] &= ~signature_mask;
+	}
+
+private:
+	uint64_t signature_mask = 0;
+	std::vector<uint64_t>* signatures = nullptr;
+
+	const char* name = "unnamed";
+	size_t inserts = 0, removes = 0;
+	size_t last_inserts = 0, last_removes = 0;
+	size_t peak_size = 0;
+
+	GroupHooks group;
 };
 
 // A container that stores components of type 'Component' and associated entities
 template <typename Component> // A component can be any class
-class ComponentContainer : public ContainerInterface
+class ComponentContainer : public ContainerBase
 {
 private:
-	// The hash map from Entity -> array index.
-	std::unordered_map<unsigned int, unsigned int> map_entity_componentID; // the entity is cast to uint to be hashable.
+	template <typename... Components>
+	friend class OwningGroup;
+
+	// Paged sparse set from Entity index -> array index. Pages are allocated lazily so that
+	// large entity indices do not require a large contiguous allocation.
+	static constexpr unsigned int PAGE_BITS = 10;
+	static constexpr unsigned int PAGE_SIZE = 1u << PAGE_BITS;
+	static constexpr unsigned int INVALID_INDEX = 0xFFFFFFFFu;
+	std::vector<std::unique_ptr<unsigned int[]>> sparse_pages;
 	bool registered = false;
+
+	// Returns the slot for entity e, allocating its page if needed
+	unsigned int& sparse_slot(Entity e)
+	{
+		unsigned int page = e.index() >> PAGE_BITS;
+		if (page >= sparse_pages.size())
+			sparse_pages.resize(page + 1);
+		if (!sparse_pages[page])
+		{
+			sparse_pages[page].reset(new unsigned int[PAGE_SIZE]);
+			std::fill_n(sparse_pages[page].get(), PAGE_SIZE, INVALID_INDEX);
+		}
+		return sparse_pages[page][e.index() & (PAGE_SIZE - 1)];
+	}
+
+	// Number of frozen components kept at the tail of the dense arrays, see freeze()
+	size_t frozen_count = 0;
+
+	// Tick of the last insert, modify or remove, and the tick of the last insert or modify of every component
+	uint32_t last_change_tick = 0;
+	std::vector<uint32_t> change_ticks;
+
+	// Move the component at dense index from to index to, overwriting what was there
+	void move_dense(size_t from, size_t to)
+	{
+		if (from == to)
+			return;
+		components[to] = std::move(components[from]);
+		entities[to] = entities[from];
+		change_ticks[to] = change_ticks[from];
+		sparse_slot(entities[to]) = (unsigned int)to;
+	}
+
+	void swap_dense(size_t i, size_t j)
+	{
+		if (i == j)
+			return;
+		std::swap(components[i], components[j]);
+		std::swap(entities[i], entities[j]);
+		std::swap(change_ticks[i], change_ticks[j]);
+		sparse_slot(entities[i]) = (unsigned int)i;
+		sparse_slot(entities[j]) = (unsigned int)j;
+	}
+
+	// Returns the dense index of entity e, or INVALID_INDEX if it has none.
+	// The generation check rejects stale handles whose index has been reused.
+	unsigned int dense_index(Entity e) const
+	{
+		unsigned int page = e.index() >> PAGE_BITS;
+		if (page >= sparse_pages.size() || !sparse_pages[page])
+			return INVALID_INDEX;
+		unsigned int cID = sparse_pages[page][e.index() & (PAGE_SIZE - 1)];
+		if (cID == INVALID_INDEX || entities[cID].id() != e.id())
+			return INVALID_INDEX;
+		return cID;
+	}
+
 public:
 	// Container of all components of type 'Component'
 	std::vector<Component> components;
@@ -46,10 +372,32 @@ public:
 		// Usually, every entity should only have one instance of each component type
 		assert(!(check_for_duplicates && has(e)) && "Entity already contained in ECS registry");
 
-		map_entity_componentID[e] = (unsigned int)components.size();
+		size_t cID = components.size();
+		sparse_slot(e) = (unsigned int)cID;
 		components.push_back(std::move(c)); // the move enforces move instead of copy constructor
 		entities.push_back(e);
-		return components.back();
+		change_ticks.push_back(ChangeTick::current);
+		last_change_tick = ChangeTick::current;
+		mark_signature(e);
+		count_insert(components.size());
+		// new components are never frozen, move it in front of the frozen tail
+		if (frozen_count > 0)
+		{
+			swap_dense(cID, cID - frozen_count);
+			cID -= frozen_count;
+		}
+		// joining a group moves the component to the end of the group's prefix
+		if (in_group())
+		{
+			group_enter(e);
+			cID = dense_index(e);
+		}
+		if (!on_construct.empty())
+		{
+			on_construct.publish(e);
+			cID = dense_index(e); // a listener may have moved it by joining a group
+		}
+		return components[cID];
 	};
 
 	// The emplace function takes the the provided arguments Args, creates a new object of type Component, and inserts it into the ECS system
@@ -62,15 +410,22 @@ public:
 		return insert(e, Component(std::forward<Args>(args)...), false);
 	};
 
-	// A wrapper to return the component of an entity
+	// A wrapper to return the component of an entity. Writes through get() are not stamped, changed_since() and
+	// on_update listeners only see them when the writer uses modify() instead or calls mark_changed() afterwards
 	Component& get(Entity e) {
 		assert(has(e) && "Entity not contained in ECS registry");
-		return components[map_entity_componentID[e]];
+		return components[dense_index(e)];
+	}
+
+	// Returns a pointer to the component of e, or nullptr if it has none. Saves the second lookup of has() + get()
+	Component* find(Entity e) {
+		unsigned int cID = dense_index(e);
+		return cID == INVALID_INDEX ? nullptr : &components[cID];
 	}
 
 	// Check if entity has a component of type 'Component'
 	bool has(Entity entity) {
-		return map_entity_componentID.count(entity) > 0;
+		return dense_index(entity) != INVALID_INDEX;
 	}
 
 	// Remove an component and pack the container to re-use the empty space
@@ -78,29 +433,134 @@ public:
 	{
 		if (has(e))
 		{
+			on_destroy.publish(e);
+			group_leave(e);
+
 			// Get the current position
-			int cID = map_entity_componentID[e];
+			size_t cID = dense_index(e);
+			size_t last = components.size() - 1;
+			size_t active_end = components.size() - frozen_count;
 
-			// Move the last element to position cID using the move operator
+			// Move the last element of the same partition to position cID using the move operator
 			// Note, components[cID] = components.back() would trigger the copy instead of move operator
-			components[cID] = std::move(components.back());
-			entities[cID] = entities.back(); // the entity is only a single index, copy it.
-			map_entity_componentID[entities.back()] = cID;
+			if (cID < active_end)
+			{
+				move_dense(active_end - 1, cID);
+				// the last frozen component fills the slot that the active partition gives up
+				if (frozen_count > 0)
+					move_dense(last, active_end - 1);
+			}
+			else
+			{
+				move_dense(last, cID);
+				frozen_count--;
+			}
 
 			// Erase the old component and free its memory
-			map_entity_componentID.erase(e);
+			sparse_slot(e) = INVALID_INDEX;
+			unmark_signature(e);
 			components.pop_back();
 			entities.pop_back();
-			// Note, one could mark the id for re-use
+			change_ticks.pop_back();
+			last_change_tick = ChangeTick::current;
+			count_removes(1);
 		}
 	};
 
+	// get() for write access, marks the component as changed
+	Component& modify(Entity e) {
+		mark_changed(e);
+		return get(e);
+	}
+
+	// Stamp the component of e with the current tick, call this after changing it through get()
+	void mark_changed(Entity e) {
+		unsigned int cID = dense_index(e);
+		if (cID == INVALID_INDEX)
+			return;
+		change_ticks[cID] = ChangeTick::current;
+		last_change_tick = ChangeTick::current;
+		on_update.publish(e);
+	}
+
+	// Check if anything was inserted, modified or removed after tick
+	bool changed_since(uint32_t tick) const {
+		return last_change_tick > tick;
+	}
+
+	// Check if the component of e was inserted or modified after tick
+	bool changed_since(Entity e, uint32_t tick) const {
+		unsigned int cID = dense_index(e);
+		return cID != INVALID_INDEX && change_ticks[cID] > tick;
+	}
+
+	// Same as above for a component of this container, e.g. one returned by find()
+	bool changed_since(const Component* c, uint32_t tick) const {
+		return change_ticks[c - components.data()] > tick;
+	}
+
+	// Move the component of e to the frozen tail of the dense arrays. Passes that only care about
+	// active components, e.g. motion integration of static bodies, can stop at active_size().
+	void freeze(Entity e)
+	{
+		unsigned int cID = dense_index(e);
+		size_t active_end = components.size() - frozen_count;
+		if (cID == INVALID_INDEX || cID >= active_end)
+			return;
+		if (in_group())
+		{
+			group_leave(e);
+			cID = dense_index(e);
+		}
+		swap_dense(cID, active_end - 1);
+		frozen_count++;
+	}
+
+	// Move the component of e back in front of the frozen tail
+	void thaw(Entity e)
+	{
+		unsigned int cID = dense_index(e);
+		size_t active_end = components.size() - frozen_count;
+		if (cID == INVALID_INDEX || cID < active_end)
+			return;
+		swap_dense(cID, active_end);
+		frozen_count--;
+		group_enter(e);
+	}
+
+	bool is_frozen(Entity e) const
+	{
+		unsigned int cID = dense_index(e);
+		return cID != INVALID_INDEX && cID >= components.size() - frozen_count;
+	}
+
+	// Number of components that are not frozen, they occupy the indices [0, active_size())
+	size_t active_size() const
+	{
+		return components.size() - frozen_count;
+	}
+
 	// Remove all components of type 'Component'
 	void clear()
 	{
-		map_entity_componentID.clear();
+		if (!on_destroy.empty())
+		{
+			for (Entity e : entities)
+				on_destroy.publish(e);
+		}
+		// Pages stay allocated, only the live slots need resetting
+		for (Entity e : entities)
+		{
+			sparse_slot(e) = INVALID_INDEX;
+			unmark_signature(e);
+		}
+		count_removes(components.size());
 		components.clear();
 		entities.clear();
+		change_ticks.clear();
+		frozen_count = 0;
+		last_change_tick = ChangeTick::current;
+		group_reset();
 	}
 
 	// Report the number of components of type 'Component'
@@ -109,18 +569,394 @@ public:
 		return components.size();
 	}
 
+	// Append all components to a snapshot. The registry saves the entity signatures as a whole
+	void save(SnapshotBuffer& buffer)
+	{
+		SnapshotHooks<Component>::save(buffer, components);
+		buffer.write_array(entities);
+		buffer.write(&frozen_count, sizeof(frozen_count));
+	}
+
+	// Replace all components with the ones read back from a snapshot.
+	// Restored components count as changed, so incremental systems pick them up
+	void load(SnapshotReader& reader)
+	{
+		for (Entity e : entities)
+			sparse_slot(e) = INVALID_INDEX;
+		SnapshotHooks<Component>::load(reader, components);
+		reader.read_array(entities);
+		reader.read(&frozen_count, sizeof(frozen_count));
+		assert(components.size() == entities.size() && "Snapshot does not match the container");
+		change_ticks.assign(entities.size(), ChangeTick::current);
+		last_change_tick = ChangeTick::current;
+		for (unsigned int i = 0; i < entities.size(); i++)
+			sparse_slot(entities[i]) = i;
+		group_reset();
+	}
+
+	ContainerStats stats()
+	{
+		size_t pages = 0;
+		for (const auto& page : sparse_pages)
+			pages += page != nullptr;
+		size_t bytes = components.capacity() * sizeof(Component)
+			+ entities.capacity() * sizeof(Entity)
+			+ change_ticks.capacity() * sizeof(uint32_t)
+			+ sort_order.capacity() * sizeof(unsigned int)
+			+ sparse_pages.capacity() * sizeof(sparse_pages[0])
+			+ pages * PAGE_SIZE * sizeof(unsigned int);
+		return base_stats(components.size(), components.capacity(), bytes);
+	}
+
 	// Sort the components and associated entity assignment structures by the comparisonFunction, see std::sort
+	// Sorting thaws all frozen components. Containers owned by a group keep the group's order and can not be sorted.
 	template <class Compare>
 	void sort(Compare comparisonFunction)
 	{
-		// First sort the entity list as desired
-		std::sort(entities.begin(), entities.end(), comparisonFunction);
-		// Now re-arrange the components (Note, creates a new vector, which may be slow! Not sure if in-place could be faster: https://stackoverflow.com/questions/63703637/how-to-efficiently-permute-an-array-in-place-using-stdswap)
-		std::vector<Component> components_new; components_new.reserve(components.size());
-		std::transform(entities.begin(), entities.end(), std::back_inserter(components_new), [&](Entity e) { return std::move(get(e)); }); // note, the get still uses the old hash map (on purpose!)
-		components = std::move(components_new); // note, we use move operations to not create unneccesary copies of objects, but memory is still allocated for the new vector
-		// Fill the new hashmap
+		assert(!in_group() && "Sorting would break the order of the owning group");
+		// First sort the order of the entities as desired, the components stay in place so the comparison can still get() them
+		reset_sort_order();
+		std::sort(sort_order.begin(), sort_order.end(), [&](unsigned int a, unsigned int b) { return comparisonFunction(entities[a], entities[b]); });
+		apply_sort_order();
+	}
+
+	// Same as sort() for containers that are nearly sorted already, e.g. re-sorted every frame after a few changes.
+	// Insertion sort is close to O(n) then. If too many elements are out of place it falls back to std::sort.
+	template <class Compare>
+	void sort_incremental(Compare comparisonFunction)
+	{
+		assert(!in_group() && "Sorting would break the order of the owning group");
+		reset_sort_order();
+		auto less = [&](unsigned int a, unsigned int b) { return comparisonFunction(entities[a], entities[b]); };
+		size_t budget = 8 * sort_order.size() + 64; // element moves before giving up
+		for (size_t i = 1; i < sort_order.size(); i++)
+		{
+			unsigned int held = sort_order[i];
+			size_t j = i;
+			for (; j > 0 && less(held, sort_order[j - 1]); j--)
+				sort_order[j] = sort_order[j - 1];
+			sort_order[j] = held;
+
+			if (i - j > budget)
+			{
+				std::sort(sort_order.begin(), sort_order.end(), less);
+				break;
+			}
+			budget -= i - j;
+		}
+		apply_sort_order();
+	}
+
+private:
+	// Permutation buffer of the sorts, kept between calls
+	std::vector<unsigned int> sort_order;
+
+	void reset_sort_order()
+	{
+		sort_order.resize(entities.size());
+		for (unsigned int i = 0; i < sort_order.size(); i++)
+			sort_order[i] = i;
+	}
+
+	// Move the element at sort_order[i] to slot i, in place. Every cycle of the permutation is walked once
+	// holding one element aside, so each element is moved once. Done slots are marked by sort_order[i] == i.
+	void apply_sort_order()
+	{
+		frozen_count = 0;
+		size_t first_moved = sort_order.size();
+		for (unsigned int start = 0; start < sort_order.size(); start++)
+		{
+			if (sort_order[start] == start)
+				continue;
+			first_moved = std::min(first_moved, (size_t)start);
+			Component held_component = std::move(components[start]);
+			Entity held_entity = entities[start];
+			uint32_t held_tick = change_ticks[start];
+			unsigned int slot = start;
+			while (sort_order[slot] != start)
+			{
+				unsigned int from = sort_order[slot];
+				components[slot] = std::move(components[from]);
+				entities[slot] = entities[from];
+				change_ticks[slot] = change_ticks[from];
+				sort_order[slot] = slot;
+				slot = from;
+			}
+			components[slot] = std::move(held_component);
+			entities[slot] = held_entity;
+			change_ticks[slot] = held_tick;
+			sort_order[slot] = slot;
+		}
+		if (first_moved == sort_order.size())
+			return;
+		// Fill the new sparse index from the first slot that changed
+		for (size_t i = first_moved; i < entities.size(); i++)
+			sparse_slot(entities[i]) = (unsigned int)i;
+		last_change_tick = ChangeTick::current;
+	}
+};
+
+// Storage for empty tag components such as Collidable, which carry no data: one bit per entity index, the list of
+// member entities and, per index, the slot of its entity in that list. has() is a bit test, a set bit is confirmed
+// against the handle in the slot so that a stale handle whose index has been reused does not match.
+// It has the operations of a ComponentContainer that make sense without data, find() and get() return a shared instance.
+template <typename Component>
+class TagContainer : public ContainerBase
+{
+	static_assert(std::is_empty_v<Component>, "TagContainer only holds empty components");
+
+	std::vector<uint64_t> bits;
+	std::vector<unsigned int> slots; // per entity index, only meaningful while its bit is set
+	uint32_t last_change_tick = 0;
+	static inline Component instance;
+
+	bool test(unsigned int index) const
+	{
+		return index / 64 < bits.size() && (bits[index / 64] >> (index % 64)) & 1;
+	}
+
+	void set(Entity e, unsigned int slot)
+	{
+		if (e.index() / 64 >= bits.size())
+			bits.resize(e.index() / 64 + 1, 0);
+		if (e.index() >= slots.size())
+			slots.resize(bits.size() * 64);
+		bits[e.index() / 64] |= uint64_t(1) << (e.index() % 64);
+		slots[e.index()] = slot;
+	}
+
+public:
+	// The member entities, in insertion order until one is removed
+	std::vector<Entity> entities;
+
+	Component& insert(Entity e, Component = {}, bool check_for_duplicates = true)
+	{
+		assert(!(check_for_duplicates && has(e)) && "Entity already contained in ECS registry");
+		if (has(e))
+			return instance; // a set can not hold an entity twice
+		set(e, (unsigned int)entities.size());
+		entities.push_back(e);
+		last_change_tick = ChangeTick::current;
+		mark_signature(e);
+		count_insert(entities.size());
+		group_enter(e);
+		on_construct.publish(e);
+		return instance;
+	}
+
+	template<typename... Args>
+	Component& emplace(Entity e, Args &&...) {
+		return insert(e);
+	}
+	template<typename... Args>
+	Component& emplace_with_duplicates(Entity e, Args &&...) {
+		return insert(e, {}, false);
+	}
+
+	Component& get(Entity e) {
+		assert(has(e) && "Entity not contained in ECS registry");
+		return instance;
+	}
+
+	Component* find(Entity e) {
+		return has(e) ? &instance : nullptr;
+	}
+
+	bool has(Entity e) {
+		return test(e.index()) && entities[slots[e.index()]].id() == e.id();
+	}
+
+	// The last member takes the slot of e
+	void remove(Entity e)
+	{
+		if (!has(e))
+			return;
+		on_destroy.publish(e);
+		group_leave(e);
+		unsigned int slot = slots[e.index()];
+		Entity last = entities.back();
+		entities[slot] = last;
+		slots[last.index()] = slot;
+		entities.pop_back();
+		bits[e.index() / 64] &= ~(uint64_t(1) << (e.index() % 64));
+		last_change_tick = ChangeTick::current;
+		unmark_signature(e);
+		count_removes(1);
+	}
+
+	// Tags have no data to change, these only exist so that tags work wherever components do. on_update is never published
+	Component& modify(Entity e) { return get(e); }
+	void mark_changed(Entity) {}
+
+	// Check if anything was inserted or removed after tick
+	bool changed_since(uint32_t tick) const {
+		return last_change_tick > tick;
+	}
+
+	// Without per member ticks this is true for every member if the container changed after tick
+	bool changed_since(Entity e, uint32_t tick) {
+		return has(e) && last_change_tick > tick;
+	}
+
+	bool changed_since(const Component*, uint32_t tick) const {
+		return last_change_tick > tick;
+	}
+
+	void clear()
+	{
+		if (!on_destroy.empty())
+		{
+			for (Entity e : entities)
+				on_destroy.publish(e);
+		}
+		for (Entity e : entities)
+			unmark_signature(e);
+		count_removes(entities.size());
+		std::fill(bits.begin(), bits.end(), 0);
+		entities.clear();
+		last_change_tick = ChangeTick::current;
+		group_reset();
+	}
+
+	size_t size()
+	{
+		return entities.size();
+	}
+
+	void save(SnapshotBuffer& buffer)
+	{
+		buffer.write_array(entities);
+	}
+
+	void load(SnapshotReader& reader)
+	{
+		std::fill(bits.begin(), bits.end(), 0);
+		reader.read_array(entities);
 		for (unsigned int i = 0; i < entities.size(); i++)
-			map_entity_componentID[entities[i]] = i;
+			set(entities[i], i);
+		last_change_tick = ChangeTick::current;
+		group_reset();
+	}
+
+	ContainerStats stats()
+	{
+		size_t bytes = bits.capacity() * sizeof(uint64_t) + slots.capacity() * sizeof(unsigned int) + entities.capacity() * sizeof(Entity);
+		return base_stats(entities.size(), entities.capacity(), bytes);
 	}
 };
+
+// The container the registry uses for a component type: TagContainer for empty structs, ComponentContainer otherwise
+template <typename Component>
+using ContainerFor = std::conditional_t<std::is_empty_v<Component>, TagContainer<Component>, ComponentContainer<Component>>;
+
+// Iterates over all entities that have every one of the given components.
+// Iteration is driven by the smallest container and yields the entity together with references to its components:
+//	for (auto [entity, motion, aabb] : registry().view<Motion, AABB>()) { ... }
+// or equivalently
+//	registry().view<Motion, AABB>().each([](Entity entity, Motion& motion, AABB& aabb) { ... });
+// Like the index loops it replaces, components added to the driving container during iteration are visited
+// and removing any component but the current entity's is unsafe.
+template <typename... Components>
+class View
+{
+	std::tuple<ContainerFor<Components>*...> containers;
+	std::vector<Entity>* driver = nullptr;
+	uint32_t since_tick = 0; // only yield entities with a component changed after this tick, see changed_since()
+
+	// Looks up the components of e in every container, returns false if one is missing
+	bool find_all(Entity e, std::tuple<Components*...>& found)
+	{
+		found = std::tuple<Components*...>(std::get<ContainerFor<Components>*>(containers)->find(e)...);
+		if (!((std::get<Components*>(found) != nullptr) && ...))
+			return false;
+		return since_tick == 0 || (std::get<ContainerFor<Components>*>(containers)->changed_since(std::get<Components*>(found), since_tick) || ...);
+	}
+
+public:
+	View(ContainerFor<Components>&... cs) : containers(&cs...)
+	{
+		// pick the container with the fewest entities to drive the iteration
+		((driver == nullptr || cs.entities.size() < driver->size() ? (void)(driver = &cs.entities) : (void)0), ...);
+	}
+
+	// Iterate in the order of T's container instead of the smallest one, e.g. when draw order matters
+	// Returns a copy so that it can be chained on a temporary view in a range-for
+	template <typename T>
+	View use() const
+	{
+		View ordered = *this;
+		ordered.driver = &std::get<ContainerFor<T>*>(containers)->entities;
+		return ordered;
+	}
+
+	// Only visit entities where at least one of the components was inserted or modified after tick
+	View changed_since(uint32_t tick) const
+	{
+		View changed = *this;
+		changed.since_tick = tick;
+		return changed;
+	}
+
+	class iterator
+	{
+		View* view;
+		size_t i;
+		std::tuple<Components*...> current;
+
+		// Advance to the next entity that has all components
+		void skip()
+		{
+			while (i < view->driver->size() && !view->find_all((*view->driver)[i], current))
+				i++;
+		}
+
+	public:
+		iterator(View* view, size_t i) : view(view), i(i) { skip(); }
+
+		std::tuple<Entity, Components&...> operator*() const
+		{
+			return std::tuple<Entity, Components&...>((*view->driver)[i], *std::get<Components*>(current)...);
+		}
+
+		iterator& operator++()
+		{
+			i++;
+			skip();
+			return *this;
+		}
+
+		// The end is re-checked against the live size so that the loop tolerates insertions
+		bool operator!=(const iterator&) const { return i < view->driver->size(); }
+	};
+
+	iterator begin() { return iterator(this, 0); }
+	iterator end() { return iterator(this, driver->size()); }
+
+	template <typename Fn>
+	void each(Fn fn)
+	{
+		std::tuple<Components*...> found;
+		for (size_t i = 0; i < driver->size(); i++)
+		{
+			Entity e = (*driver)[i];
+			if (find_all(e, found))
+				fn(e, *std::get<Components*>(found)...);
+		}
+	}
+
+	// each() for the entities at the indices [begin, end) of the driving container, for splitting a view into chunks
+	template <typename Fn>
+	void each_range(size_t begin, size_t end, Fn& fn)
+	{
+		std::tuple<Components*...> found;
+		for (size_t i = begin; i < end; i++)
+		{
+			Entity e = (*driver)[i];
+			if (find_all(e, found))
+				fn(e, *std::get<Components*>(found)...);
+		}
+	}
+
+	// Upper bound on the number of entities visited
+	size_t size_hint() const { return driver->size(); }
+};
@@ -0,0 +1,27 @@
+#include "transform_system.hpp"
+
+#include <glm/trigonometric.hpp>
+
+// Recomputes the Motion of every child from its parent's Motion and its local transform.
+// The Parent components are kept sorted by depth, so a parent is always updated before its children
+// and the whole hierarchy is done in one pass over a contiguous array.
+void TransformSystem::step(float elapsed_ms) {
+	auto& parents = registry().parents;
+	if (parents.changed_since(sorted_tick)) {
+		parents.sort_incremental([&](Entity a, Entity b) { return parents.get(a).depth < parents.get(b).depth; });
+		sorted_tick = ChangeTick::checkpoint();
+	}
+
+	for (size_t i = 0; i < parents.size(); i++) {
+		const Parent& link = parents.components[i];
+		const Motion& parent_motion = registry().motions.get(link.entity);
+		Motion& motion = registry().motions.get(parents.entities[i]);
+
+		float radians = glm::radians(parent_motion.angle);
+		float c = cos(radians);
+		float s = sin(radians);
+		motion.position = parent_motion.position + vec2(link.local_position.x * c - link.local_position.y * s, link.local_position.x * s + link.local_position.y * c);
+		motion.angle = parent_motion.angle + link.local_angle;
+		motion.scale = parent_motion.scale * link.local_scale;
+	}
+}
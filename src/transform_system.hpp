@@ -0,0 +1,20 @@
+#pragma once
+
+#include "common.hpp"
+#include "tinyECS/tiny_ecs.hpp"
+#include "tinyECS/components.hpp"
+#include "tinyECS/registry.hpp"
+#include "world.hpp"
+
+// Moves child entities along with their parents, see Parent and ECSRegistry::set_parent()
+class TransformSystem : public GameSystem
+{
+public:
+	using GameSystem::GameSystem;
+
+	void step(float elapsed_ms);
+
+private:
+	// the parents container was last sorted by depth at this tick
+	uint32_t sorted_tick = 0;
+};
@@ -4,11 +4,14 @@
 #include "tinyECS/tiny_ecs.hpp"
 #include <render_system.hpp>
 #include <audio_system.hpp>
+#include "world.hpp"
 
 class WorldSystem;
 
-class UISystem {
+class UISystem : public GameSystem {
 public:
+    using GameSystem::GameSystem;
+
     void init(GLFWwindow* window, WorldSystem* world_system, RenderSystem* render_system, AudioSystem* audio_system);
 
     void update_stamina_bar();
@@ -29,6 +32,10 @@ public:
 
     void update_UI();
 
+    // Health and stamina bars of the "hud" system, which runs next to the AI: reads Player and Dash and writes UI only,
+    // the textures of the bars follow in the next update_UI()
+    void update_bars();
+
     void step(float elapsed_ms);
 
     void progress_timers(float elapsed_ms);
@@ -68,6 +75,11 @@ private:
     Entity gun_entity;
     Entity ammo_entity, max_ammo_entity;
     Entity cinematic_entity;
+
+    // checkpoints of the last update_UI and update_bars, see ChangeTick
+    uint32_t ui_tick = 0;
+    uint32_t bars_tick = 0;
+    bool bars_changed = false;
 };
 
 
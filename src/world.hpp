@@ -0,0 +1,86 @@
+#pragma once
+
+#include "tinyECS/registry.hpp"
+#include "scheduler.hpp"
+
+class MapSystem;
+class AudioSystem;
+class UISystem;
+
+// One game simulation: its entities and components, the threads its systems run on and the systems other systems call into.
+// Worlds are independent of each other, so one process can run several, e.g. headless games side by side for balance
+// tests, or a next level that is built while the current one plays.
+// Systems work on the world they were created with, see GameSystem. Helpers like createProjectile() work on the world
+// of the calling thread through world() and registry(), so make a world current before calling into its systems.
+// Its worker threads do so on their own.
+// Systems keep state of their world (listeners, the current map), so every world needs its own instances.
+class World
+{
+public:
+	ECSRegistry registry;
+	Scheduler scheduler; // declared after the registry so that the workers stop before the containers go away
+
+	// Set by whoever creates the systems, see main()
+	MapSystem* map_system = nullptr;
+	AudioSystem* audio_system = nullptr;
+	UISystem* ui_system = nullptr;
+
+	World() = default;
+
+	// the containers and the worker threads refer to this instance
+	World(const World&) = delete;
+	World& operator=(const World&) = delete;
+
+	// Starts the worker threads of the scheduler, 0 workers runs the systems on the calling thread only
+	void start_workers(unsigned int worker_count) {
+		scheduler.init(worker_count, this);
+	}
+
+	// Makes this the world of the calling thread
+	void make_current() {
+		current = this;
+		ECSRegistry::current = &registry;
+	}
+
+	// The world of the calling thread, nullptr until one is made current
+	static inline thread_local World* current = nullptr;
+};
+
+// The world of the calling thread
+inline World& world() {
+	return *World::current;
+}
+
+// Makes a world current until the end of the scope and then switches back, e.g. to fill another world from the thread of the current one
+class WorldScope
+{
+	World* previous;
+
+public:
+	WorldScope(World& world) : previous(World::current) {
+		world.make_current();
+	}
+
+	~WorldScope() {
+		World::current = previous;
+		ECSRegistry::current = previous ? &previous->registry : nullptr;
+	}
+
+	WorldScope(const WorldScope&) = delete;
+	WorldScope& operator=(const WorldScope&) = delete;
+};
+
+// Base of the game systems. A system belongs to the world it is created with and reaches it through these members,
+// whichever thread its methods run on
+class GameSystem
+{
+public:
+	explicit GameSystem(World& world) : owner(&world) {}
+
+	World& world() const { return *owner; }
+	ECSRegistry& registry() const { return owner->registry; }
+	Scheduler& scheduler() const { return owner->scheduler; }
+
+private:
+	World* owner;
+};
@@ -1,5 +1,7 @@
 #include "world_init.hpp"
 #include "tinyECS/registry.hpp"
+#include "world.hpp"
+#include "ui_system.hpp"
 #include "map_init.hpp"
 #include "ai_system_init.hpp"
 #include "player_system.hpp"
@@ -7,15 +9,15 @@
 
 Entity createProjectile(vec2 pos, vec2 size, vec2 velocity, float angle, float angle_velocity, float damage, bool shot_by_player, TEXTURE_ASSET_ID texture_id, bool is_gun, bool can_bounce, int penetration_count, int ricochet_count)
 {
-	auto entity = Entity();
-	auto& motion = registry.motions.emplace(entity);
+	auto entity = registry().create();
+	auto& motion = registry().motions.emplace(entity);
 	motion.position = pos;
 	motion.velocity = velocity;
 	motion.scale = size;
 	motion.angle = angle;
 	motion.angle_velocity = angle_velocity;
 
-	Projectile& projectile = registry.projectiles.emplace(entity);
+	Projectile& projectile = registry().projectiles.emplace(entity);
 	projectile.shot_by_player = shot_by_player;
 	projectile.damage = damage;
 	projectile.is_gun = is_gun;
@@ -23,14 +25,15 @@ Entity createProjectile(vec2 pos, vec2 size, vec2 velocity, float angle, float a
 	projectile.remaining_penetrations = penetration_count;
 	projectile.ricochet_remaining = ricochet_count;
 
-	registry.movingCollidables.emplace(entity);
-	registry.movingSATCollidables.emplace(entity);
-	registry.collidables.emplace(entity);
-	AABB& aabb = registry.AABBs.emplace(entity);
-	aabb.collision_box = motion.scale;
+	registry().movingCollidables.emplace(entity);
+	registry().movingSATCollidables.emplace(entity);
+	registry().collidables.emplace(entity);
+	// joining the moving SAT group moves the Motion, so motion must not be used after this
+	AABB& aabb = registry().AABBs.emplace(entity);
+	aabb.collision_box = size;
 	aabb.offset = { 0.f, 0.f };
 
-	registry.renderRequests.emplace(entity, RenderRequest{
+	registry().renderRequests.emplace(entity, RenderRequest{
 		texture_id,
 		EFFECT_ASSET_ID::TEXTURED,
 		GEOMETRY_BUFFER_ID::SPRITE,
@@ -42,8 +45,8 @@ Entity createProjectile(vec2 pos, vec2 size, vec2 velocity, float angle, float a
 
 Entity spawn_pickup(vec2 position, float angle, PICKUP_TYPE pickup_type, float value, GUN_TYPE gun_type) {
 
-	Entity entity = Entity();
-	Pickup& pickup = registry.pickups.emplace(entity);
+	Entity entity = registry().create();
+	Pickup& pickup = registry().pickups.emplace(entity);
 	pickup.gun_type = gun_type;
 	pickup.type = pickup_type;
 	pickup.value = value;
@@ -54,7 +57,7 @@ Entity spawn_pickup(vec2 position, float angle, PICKUP_TYPE pickup_type, float v
 		return entity;
 	}
 
-	auto& motion = registry.motions.emplace(entity);
+	auto& motion = registry().motions.emplace(entity);
 	motion.position = position;
 	motion.angle = (pickup_type == PICKUP_TYPE::GUN) ? static_cast<float>(get_rand(0, 360)) : angle;
 	motion.velocity = glm::vec2(0.0f, 0.0f);
@@ -82,26 +85,26 @@ Entity spawn_pickup(vec2 position, float angle, PICKUP_TYPE pickup_type, float v
 		}
 	}
 
-	registry.renderRequests.emplace(entity, RenderRequest{
+	registry().renderRequests.emplace(entity, RenderRequest{
 		pickup_texture,
 		EFFECT_ASSET_ID::TEXTURED,
 		GEOMETRY_BUFFER_ID::SPRITE,
 		Z_INDEX::PICKUP
 	});
 
-	registry.textureWithoutLighting.emplace(entity);
+	registry().textureWithoutLighting.emplace(entity);
 
 	return entity;
 }
 
 void collect_pickup(Entity pickup_entity, AudioSystem* audio) {
-	if (!registry.pickups.has(pickup_entity)) {
+	if (!registry().pickups.has(pickup_entity)) {
 		return;
 	}
 
-	Pickup& pickup = registry.pickups.get(pickup_entity);
-	Entity& player_entity = registry.players.entities[0];
-	Player& player = registry.players.components[0];
+	Pickup& pickup = registry().pickups.get(pickup_entity);
+	Entity& player_entity = registry().players.entities[0];
+	Player& player = registry().players.components[0];
 
 	const PICKUP_TYPE pickup_type = pickup.type;
 	SOUND_ASSET_ID pickup_sound;
@@ -113,14 +116,16 @@ void collect_pickup(Entity pickup_entity, AudioSystem* audio) {
 		}
 
 		player.health = min(STARTING_PLAYER_HEALTH, player.health + pickup.value);
+		registry().players.mark_changed(player_entity);
 		audio->play_sound(SOUND_ASSET_ID::HEALTH_BOOST, 20);
 		break;
 
 	case PICKUP_TYPE::GUN:
-		if (registry.guns.has(registry.players.entities[0])) {
-			Gun& player_gun = registry.guns.get(registry.players.entities[0]);
+		if (registry().guns.has(registry().players.entities[0])) {
+			Gun& player_gun = registry().guns.get(registry().players.entities[0]);
 
 			if (player_gun.gun_type == pickup.gun_type) {
+				registry().guns.mark_changed(player_entity);
 				player_gun.remaining_bullets += pickup.value;
 			} else {
 				// If the pickup gun_type is different from the player's gun, don't pick it up
@@ -130,17 +135,17 @@ void collect_pickup(Entity pickup_entity, AudioSystem* audio) {
 			}
 		} else {
 			create_gun(player_entity, pickup.gun_type);
-			Gun& player_gun = registry.guns.get(registry.players.entities[0]);
+			Gun& player_gun = registry().guns.modify(player_entity);
 			player_gun.current_magazine = std::min(player_gun.magazine_size, pickup.value);
 			player_gun.remaining_bullets = std::max(0, pickup.value - player_gun.current_magazine);
-			registry.ui_system->update_gun_ui();
+			world().ui_system->update_gun_ui();
 			update_player_sprite();
 		}
 		break;
 	}
 	pickup_sound = static_cast<SOUND_ASSET_ID>(get_rand(static_cast<int>(SOUND_ASSET_ID::PISTOL_LOAD_1), static_cast<int>(SOUND_ASSET_ID::PISTOL_LOAD_5)));
 	audio->play_sound(pickup_sound, 20);
-	registry.remove_all_components_of(pickup_entity);
+	registry().destroy(pickup_entity);
 }
 
 vec2 grid_to_world_coord(float x, float y) {
@@ -173,7 +178,7 @@ void create_debris(vec2 door_loc, vec2 away_from_player, int rng)
 
 	int num_debris = std::max(rng, 6);
 	for (int i = 0; i < num_debris; i++) {
-		Entity debris = Entity();
+		Entity debris = registry().create();
 
 		// Slight offset near the door center for placement
 		float offset_x = (rand() % 10 - 5) * 0.5f;
@@ -191,7 +196,7 @@ void create_debris(vec2 door_loc, vec2 away_from_player, int rng)
 
 		createProjectile(debris_position, debris_scale, debris_velocity, 0, 0, PROJECTILE_DAMAGE * 3, true, textures[i % textures.size()], false, true);
 
-		registry.renderRequests.insert(
+		registry().renderRequests.insert(
 			debris,
 			{
 				textures[i % textures.size()],
@@ -6,9 +6,9 @@
 #include "audio_system.hpp"
 #include "render_system.hpp"
 
-#define GRID_CELL_SIZE (registry.screen_state.grid_cell_size)
-#define WINDOW_WIDTH_PX (registry.screen_state.resolution_x)
-#define WINDOW_HEIGHT_PX (registry.screen_state.resolution_y)
+#define GRID_CELL_SIZE (registry().screen_state.grid_cell_size)
+#define WINDOW_WIDTH_PX (registry().screen_state.resolution_x)
+#define WINDOW_HEIGHT_PX (registry().screen_state.resolution_y)
 
 Entity createProjectile(vec2 pos, vec2 size, vec2 velocity, float angle, float angle_velocity, float damage, bool shot_by_player, TEXTURE_ASSET_ID texture_id, bool is_gun = false, bool can_bounce = false, int penetration_count = 0, int ricochets = 0);
 
@@ -10,6 +10,7 @@
 #include "animation_init.hpp"
 #include "physics_system_init.hpp"
 #include "ui_system.hpp"
+#include "world.hpp"
 
 // stlib
 #include <cassert>
@@ -22,7 +23,7 @@
 
 
 // create the world
-WorldSystem::WorldSystem()
+WorldSystem::WorldSystem(World& world) : GameSystem(world)
 {
 	// seeding rng with random device
 	rng = std::default_random_engine(std::random_device()());
@@ -30,7 +31,7 @@ WorldSystem::WorldSystem()
 
 WorldSystem::~WorldSystem() {
 	// Destroy all created components
-	registry.clear_all_components();
+	registry().clear_all_components();
 
 	// Close the window
 	glfwDestroyWindow(window);
@@ -78,14 +79,14 @@ GLFWwindow* WorldSystem::create_window() {
 
 	GLFWmonitor* primary_monitor = glfwGetPrimaryMonitor();
     const GLFWvidmode* mode = glfwGetVideoMode(primary_monitor);
-	registry.screen_state.resolution_x = mode->width;
-	registry.screen_state.resolution_y = mode->height;
-	registry.screen_state.grid_cell_size = mode->height / GRID_HEIGHT;
+	registry().screen_state.resolution_x = mode->width;
+	registry().screen_state.resolution_y = mode->height;
+	registry().screen_state.grid_cell_size = mode->height / GRID_HEIGHT;
 	if (debugging.disable_fullscreen) {
-		registry.screen_state.resolution_y -= 100; // To give enough room for Apple menubar and dock
+		registry().screen_state.resolution_y -= 100; // To give enough room for Apple menubar and dock
 	}
 	GLFWmonitor* monitor_ptr = debugging.disable_fullscreen ? nullptr : primary_monitor;
-	window = glfwCreateWindow(registry.screen_state.resolution_x, registry.screen_state.resolution_y, "Cyber-Yaga Vindicta", monitor_ptr, nullptr);
+	window = glfwCreateWindow(registry().screen_state.resolution_x, registry().screen_state.resolution_y, "Cyber-Yaga Vindicta", monitor_ptr, nullptr);
 
 	if (window == nullptr) {
 		std::cerr << "ERROR: Failed to glfwCreateWindow in world_system.cpp" << std::endl;
@@ -112,8 +113,8 @@ void WorldSystem::init(RenderSystem* renderer_arg, AudioSystem* audio) {
 	//	audio->play_music(MUSIC_ASSET_ID::MUSIC1, 7);
 	//}
 
-	Entity game_progress_entity = Entity();
-	GameProgress game_progress = registry.gameProgress.emplace(game_progress_entity);
+	Entity game_progress_entity = registry().create();
+	GameProgress game_progress = registry().gameProgress.emplace(game_progress_entity);
 	game_progress.level = 0;
 
 	// Set all states to default
@@ -122,25 +123,72 @@ void WorldSystem::init(RenderSystem* renderer_arg, AudioSystem* audio) {
 }
 
 void WorldSystem::progress_timers(float elapsed_ms) {
-	for (int i = 0; i < registry.removeTimers.size(); i++) {
-		RemoveTimer& timer = registry.removeTimers.components[i];
+	// a few dozen timers at most, too few to be worth spreading over threads.
+	// The buffer of this thread, since other systems can be recording at the same time
+	auto& timers = registry().removeTimers;
+	for (size_t i = 0; i < timers.size(); i++) {
+		RemoveTimer& timer = timers.components[i];
 		timer.remaining_time -= elapsed_ms;
 		if (timer.remaining_time < 0.) {
-			registry.remove_all_components_of(registry.removeTimers.entities[i]);
+			registry().local_commands().destroy(timers.entities[i]);
 		}
 	}
 
-	ScreenState& screen = registry.screen_state;
+	ScreenState& screen = registry().screen_state;
 	if (screen.glitch_remaining_ms > 0.f) {
 		screen.glitch_remaining_ms -= elapsed_ms;
 	}
 }
 
+void WorldSystem::spawn_stress_test(int enemy_count, int projectile_count) {
+	vec2 center = registry().motions.get(registry().players.entities[0]).position;
+	Map& map = *world().map_system->current_map;
+	ivec2 center_cell = world_to_grid_coords(center.x, center.y);
+
+	// enemies on the floor tiles around the player, the projectiles do no damage so that the enemies stay
+	int enemies = 0;
+	for (int attempt = 0; enemies < enemy_count && attempt < enemy_count * 20; attempt++) {
+		ivec2 cell = center_cell + ivec2(get_rand(-15, 15), get_rand(-15, 15));
+		if (cell.x < 0 || cell.y < 0 || cell.x >= map.grid_width || cell.y >= map.grid_height || map.tile_id_grid[cell.y][cell.x] != TILE_ID::FLOOR)
+			continue;
+		create_enemy(cell, GUN_TYPE::PISTOL, 100.f, 1.f, 6.6f, 8.3f);
+		enemies++;
+	}
+	for (int i = 0; i < projectile_count; i++) {
+		float direction = uniform_dist(rng) * 2.f * M_PI;
+		float distance = GRID_CELL_SIZE * (2.f + uniform_dist(rng) * 13.f);
+		vec2 position = center + distance * vec2(cos(direction), sin(direction));
+		float heading = uniform_dist(rng) * 360.f;
+		vec2 velocity = 50.f * vec2(cos(glm::radians(heading)), sin(glm::radians(heading)));
+		createProjectile(position, { 15, 15 }, velocity, heading + 180.f, 0.f, 0.f, true, TEXTURE_ASSET_ID::PROJECTILE);
+	}
+	printf("Stress test: %d enemies and %d projectiles around the player\n", enemies, projectile_count);
+}
+
 // Update our game world
 bool WorldSystem::step(float elapsed_ms_since_last_update) {
 	progress_timers(elapsed_ms_since_last_update);
 
-	Input& input = registry.inputs.components[0];
+	if (restart_requested) {
+		restart_requested = false;
+		restart_game();
+	}
+
+	Input& input = registry().inputs.components[0];
+	// F9 dumps the registry stats, e.g. to look for containers that keep growing
+	if (input.key_down_events[GLFW_KEY_F9]) {
+		registry().dump_stats_csv("registry_stats.csv");
+	}
+	// F10 switches between running the systems on the worker threads and on the main thread only, to compare frame times
+	if (input.key_down_events[GLFW_KEY_F10]) {
+		debugging.single_threaded_systems = !debugging.single_threaded_systems;
+		printf("Systems run %s\n", debugging.single_threaded_systems ? "single threaded" : "on the worker threads");
+	}
+	// F11 spawns 200 enemies and 2000 projectiles around the player, compare the system times printed with the FPS
+	if (debugging.profiling && input.key_down_events[GLFW_KEY_F11] && game_state == GameState::PLAYING) {
+		spawn_stress_test(200, 2000);
+	}
+
 	if (input.keys[GLFW_KEY_P]) {
 		if (game_state == GameState::CINEMATIC) {
 			//TODO: make it so it skips the cinematic
@@ -161,89 +209,109 @@ void WorldSystem::restart_game() {
 
 	std::cout << "Restarting..." << std::endl;
 
-	// Debugging for memory/component leaks
-	registry.list_all_components();
+	// Apply deferred changes first, so they do not end up in or get replayed onto the restarted level
+	registry().flush_commands();
 
 	// Reset the game speed
 	current_speed = 1.f;
 
+	int current_level = registry().gameProgress.size() != 0 ? registry().gameProgress.components[0].level : -1;
+	if (!debugging.disable_restart_snapshot && !level_snapshot.empty() && level_snapshot_level == current_level) {
+		// the restored spatial hash already holds the restored walls and doors
+		registry().restore(level_snapshot);
+		world().ui_system->update_gun_ui();
+		update_player_sprite();
+		return;
+	}
+
+	// Debugging for memory/component leaks
+	registry().list_all_components();
+
 	// Remove all entities that we created
-	while (!registry.enemies.entities.empty()) {
-		registry.remove_all_components_of(registry.enemies.entities.back());
+	while (!registry().enemies.entities.empty()) {
+		registry().destroy(registry().enemies.entities.back());
 	}
-	while (!registry.deadEnemies.entities.empty()) {
-		registry.remove_all_components_of(registry.deadEnemies.entities.back());
+	while (!registry().deadEnemies.entities.empty()) {
+		registry().destroy(registry().deadEnemies.entities.back());
 	}
-	while (!registry.projectiles.entities.empty()) {
-		registry.remove_all_components_of(registry.projectiles.entities.back());
+	while (!registry().projectiles.entities.empty()) {
+		registry().destroy(registry().projectiles.entities.back());
 	}
-	while (!registry.pickups.entities.empty()) {
-		registry.remove_all_components_of(registry.pickups.entities.back());
+	while (!registry().pickups.entities.empty()) {
+		registry().destroy(registry().pickups.entities.back());
 	}
 
 	
 
-	if (!registry.players.entities.empty()) {
-		Entity& player = registry.players.entities[0];
-		Player& player_component = registry.players.components[0];
+	if (!registry().players.entities.empty()) {
+		Entity& player = registry().players.entities[0];
+		Player& player_component = registry().players.components[0];
 		player_component.health = STARTING_PLAYER_HEALTH;
+		registry().players.mark_changed(player);
 		
-		if (registry.motions.has(player)) { //TODO: in future, add start_position to the Map
-			auto& playerMotion = registry.motions.get(player);
-			vec2 grid_start_location = registry.map_system->current_map->start_location;
+		if (registry().motions.has(player)) { //TODO: in future, add start_position to the Map
+			auto& playerMotion = registry().motions.get(player);
+			vec2 grid_start_location = world().map_system->current_map->start_location;
 			playerMotion.position = grid_to_world_coord(grid_start_location.x, grid_start_location.y);
 		}
 
-		if (registry.guns.has(player)) {
-			registry.guns.remove(player);
+		if (registry().guns.has(player)) {
+			registry().guns.remove(player);
 		}
-		create_gun(player, registry.map_system->current_map->gun_type);
-		registry.ui_system->update_gun_ui();
+		create_gun(player, world().map_system->current_map->gun_type);
+		world().ui_system->update_gun_ui();
 
 		// Reset enemies and pickups
-		registry.map_system->spawn_map_pickups();
-		registry.map_system->spawn_map_enemies();
+		world().map_system->spawn_map_pickups();
+		world().map_system->spawn_map_enemies();
 	}
 	else {
 		renderer->initializeCamera();
 	}
 
-	if (registry.maps.size() != 0) {
-		int current_level = registry.gameProgress.components[0].level;
-		Map& map = registry.maps.components[current_level];
+	if (registry().maps.size() != 0) {
+		Map& map = registry().maps.components[current_level];
 
 		for (const auto& [pos, prop] : map.information_props) {
 			auto it = map.props.find(pos);
 			if (it == map.props.end()) {
 				
-				Entity entity = Entity();
-				Motion& motion = registry.motions.emplace(entity);
+				Entity entity = registry().create();
+				Motion& motion = registry().motions.emplace(entity);
 				motion.angle = prop.angle;
 				motion.velocity = { 0.0f, 0.0f };
 				motion.position = grid_to_world_coord(pos.x, pos.y);
 				motion.scale = vec2({ GRID_CELL_SIZE * prop.size.x, GRID_CELL_SIZE * prop.size.y });
 				map.props[pos] = prop;
-				map.prop_doors[pos] = entity;
 				map.prop_doors_list.push_back(pos);
+				registry().doors.insert(entity, { pos, current_level });
 
-				registry.map_system->make_door(entity, motion, map, prop.vertical, prop.prop_size);
+				world().map_system->make_door(entity, motion, map, prop.vertical, prop.prop_size);
 				
-				registry.staticCollidables.emplace(entity);
-				AABB& aabb = registry.AABBs.emplace(entity);
+				AABB& aabb = registry().AABBs.emplace(entity);
 				aabb.collision_box = prop.collision_size * (float)GRID_CELL_SIZE;
 				aabb.offset = prop.collision_offset * (float)GRID_CELL_SIZE;
+				registry().staticCollidables.emplace(entity);
 				map.tile_id_grid[pos.y][pos.x] = TILE_ID::CLOSED_DOOR;
 
 				map.rendered_entities.push_back(entity);
 			}
 		}
+		freeze_static_bodies(map.rendered_entities);
 	}
 	
 	update_player_sprite();
 	clear_and_set_spatial_hash();
 
+	// The level is back at its start now, keep it so the next restart is a plain copy.
+	// Not on the title screen, its entities are gone once the game starts.
+	if (!debugging.disable_restart_snapshot && game_state == GameState::PLAYING && !registry().players.entities.empty()) {
+		level_snapshot = registry().snapshot();
+		level_snapshot_level = current_level;
+	}
+
 	// debugging for memory/component leaks
-	registry.list_all_components();
+	registry().list_all_components();
 }
 
 void WorldSystem::display_instruction_images()
@@ -272,16 +340,16 @@ void WorldSystem::display_instruction_images()
 
 Entity WorldSystem::display_given_instruction(vec2 position, TEXTURE_ASSET_ID texture_ID)
 {
-	auto instruction_entity = Entity();
-	registry.instructionMessages.emplace(instruction_entity);
-	auto& timer = registry.removeTimers.emplace(instruction_entity);
+	auto instruction_entity = registry().create();
+	registry().instructionMessages.emplace(instruction_entity);
+	auto& timer = registry().removeTimers.emplace(instruction_entity);
 	timer.remaining_time = 1000000;
-	auto& motion = registry.motions.emplace(instruction_entity);
+	auto& motion = registry().motions.emplace(instruction_entity);
 	motion.position = position;
 	motion.scale = glm::vec2(GRID_CELL_SIZE * 8, GRID_CELL_SIZE * 2);
 
-	registry.textureWithoutLighting.emplace(instruction_entity);
-	registry.renderRequests.emplace(instruction_entity, RenderRequest {
+	registry().textureWithoutLighting.emplace(instruction_entity);
+	registry().renderRequests.emplace(instruction_entity, RenderRequest {
 			texture_ID,
 			EFFECT_ASSET_ID::TEXTURED,
 			GEOMETRY_BUFFER_ID::SPRITE,
@@ -294,37 +362,37 @@ Entity WorldSystem::display_given_instruction(vec2 position, TEXTURE_ASSET_ID te
 // Compute collisions between entities
 void WorldSystem::handle_collisions(float elapsed_ms) {
 
-	ComponentContainer<Collision>& collision_container = registry.collisions;
+	ComponentContainer<Collision>& collision_container = registry().collisions;
 	for (uint i = 0; i < collision_container.components.size(); i++) {
 		Entity entity_i = collision_container.entities[i];
 		Entity entity_j = collision_container.components[i].other;
 
-		if (registry.pickups.has(entity_i) || registry.pickups.has(entity_j)) {
-			Entity pickup = registry.pickups.has(entity_i) ? entity_i : entity_j;
+		if (registry().pickups.has(entity_i) || registry().pickups.has(entity_j)) {
+			Entity pickup = registry().pickups.has(entity_i) ? entity_i : entity_j;
 			Entity other = (entity_i == pickup) ? entity_j : entity_i;
-			if (registry.players.has(other)) {
+			if (registry().players.has(other)) {
 				collect_pickup(pickup, audio);
 			}
 			else {
-				Entity projectile = registry.projectiles.has(entity_i) ? entity_i : entity_j;			
+				Entity projectile = registry().projectiles.has(entity_i) ? entity_i : entity_j;			
 				Entity target = (entity_i == projectile) ? entity_j : entity_i;
 				handle_projectile_collisions(projectile, target);
 			}
-		} else if (registry.projectiles.has(entity_i) || registry.projectiles.has(entity_j)) {
-			Entity projectile = registry.projectiles.has(entity_i) ? entity_i : entity_j;			
+		} else if (registry().projectiles.has(entity_i) || registry().projectiles.has(entity_j)) {
+			Entity projectile = registry().projectiles.has(entity_i) ? entity_i : entity_j;			
 			Entity target = (entity_i == projectile) ? entity_j : entity_i;
 			handle_projectile_collisions(projectile, target);
-		} else if (registry.staticCollidables.has(entity_i) || registry.staticCollidables.has(entity_j)) {
-			Entity wall = registry.staticCollidables.has(entity_i) ? entity_i : entity_j;
+		} else if (registry().staticCollidables.has(entity_i) || registry().staticCollidables.has(entity_j)) {
+			Entity wall = registry().staticCollidables.has(entity_i) ? entity_i : entity_j;
 			Entity other = (entity_i == wall) ? entity_j : entity_i;
-			if (registry.motions.has(other)) {
+			if (registry().motions.has(other)) {
 				handle_wall_collisions(wall, other, elapsed_ms);
 			}
 		}
 	}
 
 	// Remove all collisions from this simulation step
-	registry.collisions.clear();
+	registry().collisions.clear();
 }
 
 // Should the game be over ?
@@ -341,32 +409,24 @@ bool WorldSystem::projectile_hit_door(Motion projectile_motion, vec2 door_loc)
 }
 
 void WorldSystem::handle_projectile_collisions(Entity projectile, Entity target) {
-	Projectile& comp = registry.projectiles.get(projectile);
-	if (comp.shot_by_player && registry.players.has(target)) {
+	Projectile& comp = registry().projectiles.get(projectile);
+	if (comp.shot_by_player && registry().players.has(target)) {
 		return;
 	}
 
 
 	// TODO: REFACTOR THIS TO WORK WITH ALL MAPS
-	int current_level = registry.gameProgress.components[0].level;
-	Map& map = registry.maps.components[current_level];
+	int current_level = registry().gameProgress.components[0].level;
+	Map& map = registry().maps.components[current_level];
 
 	for (auto it = map.prop_doors_list.begin(); it != map.prop_doors_list.end(); ) {
 		vec2 door_loc = grid_to_world_coord(it->x, it->y);
-		Motion& projectile_motion = registry.motions.get(projectile);
+		Motion& projectile_motion = registry().motions.get(projectile);
 
 		if (projectile_hit_door(projectile_motion, door_loc)) {
 			auto door_it = map.prop_doors.find(*it);
 			if (door_it != map.prop_doors.end()) {
 				Entity entity = door_it->second;
-				Entity entity2;
-				for (auto& pair : map.prop_doors_pair) {
-					if (pair.first == entity) {
-						entity2 = pair.second.back();
-						break;
-					}
-				}
-
 				Prop prop1 = map.props[door_it->first];
 				vec2 away_from_player = normalize(door_loc - projectile_motion.position);
 				int random_int = (int)uniform_dist(rng) * 10;
@@ -375,14 +435,14 @@ void WorldSystem::handle_projectile_collisions(Entity projectile, Entity target)
 				audio->play_sound(SOUND_ASSET_ID::DOOR_BREAKING, 20);
 
 				// spawn gun pickup in front of doorway
-				Motion& target_motion = registry.motions.get(target);
-				Projectile& projectile_comp = registry.projectiles.get(projectile);
+				Motion& target_motion = registry().motions.get(target);
+				Projectile& projectile_comp = registry().projectiles.get(projectile);
 				vec2 door_normal = get_wall_collision_normal(projectile_motion.position, target_motion.position, target_motion.scale);
 				vec2 particle_pos = projectile_motion.position;
 				float particle_angle = glm::degrees(atan2(target_motion.position.y, target_motion.position.x) + M_PI / 2.f);
 				float particle_scale = 30.f;
 				if (projectile_comp.is_gun) {
-					Gun& gun = registry.guns.get(projectile);
+					Gun& gun = registry().guns.get(projectile);
 						Entity entity = spawn_pickup(
 							particle_pos + door_normal * GRID_CELL_SIZE * 0.05f,
 							projectile_motion.angle,
@@ -390,7 +450,7 @@ void WorldSystem::handle_projectile_collisions(Entity projectile, Entity target)
 							gun.current_magazine + gun.remaining_bullets,
 							gun.gun_type
 						);
-						registry.guns.insert(entity, gun);
+						registry().guns.insert(entity, gun);
 				}
 
 				// change tile id of door from door to floor;
@@ -425,11 +485,11 @@ void WorldSystem::handle_projectile_collisions(Entity projectile, Entity target)
 
 
 
-				// Remove from all relevant maps
+				// Remove from the layout, map.prop_doors follows the destroyed entity (see MapSystem::on_door_destroyed)
 				map.props.erase(*it);
-				registry.remove_all_components_of(entity);
-				registry.remove_all_components_of(entity2);
-				clear_and_set_spatial_hash();
+				// the second leaf is a child of the door and goes with it
+				registry().destroy(entity);
+				// the door leaves the spatial hash right away, see remove_static_from_hash
 			}
 
 			it = map.prop_doors_list.erase(it);
@@ -439,30 +499,31 @@ void WorldSystem::handle_projectile_collisions(Entity projectile, Entity target)
 		}
 	}
 
-	if (registry.players.has(target) && !comp.shot_by_player) {
-		Player& player = registry.players.get(target);
+	if (registry().players.has(target) && !comp.shot_by_player) {
+		Player& player = registry().players.get(target);
 		if (player.is_invincible) {
 			audio->play_sound(SOUND_ASSET_ID::DODGE_WOOSH, 30);
 		} else {
-			ScreenState& screen = registry.screen_state;
+			ScreenState& screen = registry().screen_state;
 			screen.glitch_remaining_ms = screen.glitch_duration;
-			Motion& player_motion = registry.motions.get(target);
-			Motion& projectile_motion = registry.motions.get(projectile);
+			Motion& player_motion = registry().motions.get(target);
+			Motion& projectile_motion = registry().motions.get(projectile);
 			player_motion.velocity += normalize(player_motion.position - projectile_motion.position) * 100.f;
 			// M1: creative element #23: Audio feedback
 			// Play groaning sound when user gets hit by a bullet
 			player_got_shot(projectile, audio);
 
 			player.health -= comp.damage;
+			registry().players.mark_changed(target);
 			if (player.health <= 0) {
 				audio->play_sound(SOUND_ASSET_ID::PLAYER_HIT_1, 20);
-				restart_game();
+				// the collision loop is still running, restarting now would pull the registry out from under it
+				restart_requested = true;
 			}
 		}
 	}
-	else if (registry.enemies.has(target) && comp.shot_by_player) {
-		if (comp.hit_enemies.find(target.id()) == comp.hit_enemies.end()) {
-			comp.hit_enemies.insert(target.id());
+	else if (registry().enemies.has(target) && comp.shot_by_player) {
+		if (comp.hit_enemies.insert(target.id())) {
 			enemy_got_shot(target, projectile, audio);
 			if (comp.remaining_penetrations > 0) {
 				comp.remaining_penetrations--;
@@ -473,15 +534,15 @@ void WorldSystem::handle_projectile_collisions(Entity projectile, Entity target)
 			return;
 		}
 	}
-	else if (registry.pickups.has(target)) {
+	else if (registry().pickups.has(target)) {
 		return;
 	}
-	else if (registry.staticCollidables.has(target)) {
+	else if (registry().staticCollidables.has(target)) {
 		if (comp.ricochet_remaining > 0) {
 			audio->play_sound(SOUND_ASSET_ID::BULLET_HIT_WALL_1, 20);
 			comp.damage *= 1.5;
-			Motion& projectile_motion = registry.motions.get(projectile);
-			Motion& wall_motion = registry.motions.get(target);
+			Motion& projectile_motion = registry().motions.get(projectile);
+			Motion& wall_motion = registry().motions.get(target);
 			vec2 wall_normal = get_wall_collision_normal(projectile_motion.position, wall_motion.position, wall_motion.scale);
 			projectile_motion.velocity -= 2.0f * glm::dot(projectile_motion.velocity, wall_normal) * wall_normal;
 			projectile_motion.velocity *= 0.8f;
@@ -494,14 +555,14 @@ void WorldSystem::handle_projectile_collisions(Entity projectile, Entity target)
 		}
 	}
 
-	registry.remove_all_components_of(projectile);
+	registry().destroy(projectile);
 }
 
 // M1: creative element #8 Basic Physics
 // Prevent objects from moving into each other
 void WorldSystem::handle_wall_collisions(Entity wall, Entity other, float elapsed_ms) {
-	Motion& wall_motion = registry.motions.get(wall);
-	Motion& object_motion = registry.motions.get(other);
+	Motion& wall_motion = registry().motions.get(wall);
+	Motion& object_motion = registry().motions.get(other);
 
 	vec2 normal = get_wall_collision_normal(object_motion.position, wall_motion.position, wall_motion.scale);
 	float dot_product = dot(object_motion.velocity, normal);
@@ -510,10 +571,10 @@ void WorldSystem::handle_wall_collisions(Entity wall, Entity other, float elapse
 	}
 
 	// for enemies 
-	float is_enemy = registry.enemies.has(other);
+	float is_enemy = registry().enemies.has(other);
 	// if enemy is in backoff state then check collisions with walls
 	if(is_enemy) {
-		auto& enemy = registry.enemies.get(other);
+		auto& enemy = registry().enemies.get(other);
 		if (enemy.state == ENEMY_STATE::BACKOFF) {
 			object_motion.position -= is_enemy * object_motion.velocity * (elapsed_ms / 1000);
 		}
@@ -548,17 +609,17 @@ vec2 WorldSystem::get_wall_collision_normal(vec2& player_pos, vec2& wall_pos, ve
 void WorldSystem::projectile_hit_wall(Entity projectile, Entity wall) {
 	audio->play_sound(SOUND_ASSET_ID::BULLET_HIT_WALL_1, 20);
 
-	if (!registry.projectiles.has(projectile)) return;
+	if (!registry().projectiles.has(projectile)) return;
 
-	Motion& projectile_motion = registry.motions.get(projectile);
-	Motion& wall_motion = registry.motions.get(wall);
+	Motion& projectile_motion = registry().motions.get(projectile);
+	Motion& wall_motion = registry().motions.get(wall);
 	vec2 wall_normal = get_wall_collision_normal(projectile_motion.position, wall_motion.position, wall_motion.scale);
 	vec2 particle_pos = projectile_motion.position;
 	float particle_angle = glm::degrees(atan2(wall_normal.y, wall_normal.x) + M_PI / 2.f);
 	float particle_scale = 30.f;
 
-	Projectile& projectile_comp = registry.projectiles.get(projectile);
-	RenderRequest render_request = registry.renderRequests.get(projectile);
+	Projectile& projectile_comp = registry().projectiles.get(projectile);
+	RenderRequest render_request = registry().renderRequests.get(projectile);
 
 	if (projectile_comp.is_gun) {
 		// Reflect and dampen velocity
@@ -566,7 +627,7 @@ void WorldSystem::projectile_hit_wall(Entity projectile, Entity wall) {
 		projectile_motion.velocity *= 0.8f;
 
 		float speed = length(projectile_motion.velocity);
-		Gun& gun = registry.guns.get(projectile);
+		Gun& gun = registry().guns.get(projectile);
 
 		// Threshold speed to turn into pickup
 		if (speed <= 50.f) {
@@ -577,8 +638,8 @@ void WorldSystem::projectile_hit_wall(Entity projectile, Entity wall) {
 				gun.current_magazine + gun.remaining_bullets,
 				gun.gun_type
 			);
-			registry.guns.insert(entity, gun);
-			registry.remove_all_components_of(projectile);
+			registry().guns.insert(entity, gun);
+			registry().destroy(projectile);
 		}
 		else if (speed <= 200.f) {
 			Entity proj_entity = spawn_pickup(
@@ -588,11 +649,11 @@ void WorldSystem::projectile_hit_wall(Entity projectile, Entity wall) {
 				gun.current_magazine + gun.remaining_bullets,
 				gun.gun_type
 			);
-			Motion motion = registry.motions.get(proj_entity);
+			Motion motion = registry().motions.get(proj_entity);
 			motion.velocity = projectile_motion.velocity;
-			registry.guns.insert(proj_entity, gun);
-			registry.remove_all_components_of(projectile);
-			RenderRequest& render = registry.renderRequests.get(proj_entity);
+			registry().guns.insert(proj_entity, gun);
+			registry().destroy(projectile);
+			RenderRequest& render = registry().renderRequests.modify(proj_entity);
 			render.z_index = Z_INDEX::PICKUP;
 			render.used_texture = gun.thrown_sprite;
 			// TODO: change sprite size depending on gun
@@ -609,8 +670,8 @@ void WorldSystem::projectile_hit_wall(Entity projectile, Entity wall) {
 				gun.thrown_sprite,
 				true
 			);
-			registry.guns.insert(proj_entity, gun);
-			registry.remove_all_components_of(projectile);
+			registry().guns.insert(proj_entity, gun);
+			registry().destroy(projectile);
 		}
 	}
 	else if (projectile_comp.can_bounce) {
@@ -629,7 +690,7 @@ void WorldSystem::projectile_hit_wall(Entity projectile, Entity wall) {
 			false,
 			true
 		);
-		registry.remove_all_components_of(projectile);
+		registry().destroy(projectile);
 	}
 	else {
 		create_animation(
@@ -637,13 +698,7 @@ void WorldSystem::projectile_hit_wall(Entity projectile, Entity wall) {
 			{ 0.f, 0.f },
 			{ particle_scale, particle_scale },
 			particle_angle,
-			{
-				TEXTURE_ASSET_ID::WALL_PARTICLE_1,
-				TEXTURE_ASSET_ID::WALL_PARTICLE_2,
-				TEXTURE_ASSET_ID::WALL_PARTICLE_3,
-				TEXTURE_ASSET_ID::WALL_PARTICLE_4,
-				TEXTURE_ASSET_ID::WALL_PARTICLE_5
-			},
+			WALL_PARTICLE_CLIP,
 			true,
 			false,
 			30.0f,
@@ -14,6 +14,8 @@
 
 #include "render_system.hpp"
 #include "ui_system.hpp"
+#include "tinyECS/registry.hpp"
+#include "world.hpp"
 
 
 enum class GameState {
@@ -24,10 +26,10 @@ enum class GameState {
 
 // Container for all our entities and game logic.
 // Individual rendering / updates are deferred to the update() methods.
-class WorldSystem
+class WorldSystem : public GameSystem
 {
 public:
-	WorldSystem();
+	WorldSystem(World& world);
 
 	// creates main window
 	GLFWwindow* create_window();
@@ -74,8 +76,18 @@ private:
 	// restart level
 	void restart_game();
 
+	// Registry state right after the first full restart of a level, later restarts of the same level restore it
+	ECSRegistry::Snapshot level_snapshot;
+	int level_snapshot_level = -1;
+
+	// set when the player dies during collision handling, the restart happens at the start of the next step
+	bool restart_requested = false;
+
 	void display_instruction_images();
 
+	// Fills the level around the player with enemies and slow projectiles, to measure the collision checks under load
+	void spawn_stress_test(int enemy_count, int projectile_count);
+
 	Entity display_given_instruction(vec2 position, TEXTURE_ASSET_ID texture_ID);
 
 	// OpenGL window handle